@@ -123,8 +123,8 @@ void AlternatingFactorialApp::ValidateOptions(void)
    {
       ProcessInputTermsFile(false);
 
-      iv_Terms.resize(ii_MaxN - ii_MinN + 1);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), false);
+      iv_Terms.Resize(ii_MaxN - ii_MinN + 1);
+      iv_Terms.Fill(false);
 
       il_TermCount = 0;
       ProcessInputTermsFile(true);
@@ -134,8 +134,8 @@ void AlternatingFactorialApp::ValidateOptions(void)
       if (ii_MaxN <= ii_MinN)
          FatalError("The value for -N must be greater than the value for -n");
 
-      iv_Terms.resize(ii_MaxN - ii_MinN + 1);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), true);
+      iv_Terms.Resize(ii_MaxN - ii_MinN + 1);
+      iv_Terms.Fill(true);
 
       il_TermCount = ii_MaxN - ii_MinN + 1;
    }
@@ -198,7 +198,7 @@ void AlternatingFactorialApp::ProcessInputTermsFile(bool haveBitMap)
       if (haveBitMap)
       {
          il_TermCount++;
-         iv_Terms[BIT(n)] = true;
+         iv_Terms.Set(BIT(n));
       }
       else
       {
@@ -227,7 +227,7 @@ bool AlternatingFactorialApp::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (iv_Terms[bit])
    {
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       il_TermCount--;
 
       return true;
@@ -257,7 +257,7 @@ bool AlternatingFactorialApp::ReportFactor(uint64_t theFactor, uint32_t term)
    if (iv_Terms[bit])
    {
       newFactor = true;
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       il_TermCount--;
       il_FactorCount++;
 
@@ -54,7 +54,7 @@ protected:
 private:
    void              VerifyFactor(uint64_t theFactor, uint32_t term);
 
-   std::vector<bool> iv_Terms;
+   TermBitmap        iv_Terms;
 
    uint32_t          ii_MinN;
    uint32_t          ii_MaxN;
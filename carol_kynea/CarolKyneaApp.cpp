@@ -88,11 +88,11 @@ void CarolKyneaApp::ValidateOptions(void)
    {
       ProcessInputTermsFile(false);
 
-      iv_MinusTerms.resize(ii_MaxN - ii_MinN + 1);
-      std::fill(iv_MinusTerms.begin(), iv_MinusTerms.end(), false);
+      iv_MinusTerms.Resize(ii_MaxN - ii_MinN + 1);
+      iv_MinusTerms.Fill(false);
 
-      iv_PlusTerms.resize(ii_MaxN - ii_MinN + 1);
-      std::fill(iv_PlusTerms.begin(), iv_PlusTerms.end(), false);
+      iv_PlusTerms.Resize(ii_MaxN - ii_MinN + 1);
+      iv_PlusTerms.Fill(false);
 
       il_TermCount = 0;
       ProcessInputTermsFile(true);
@@ -105,18 +105,18 @@ void CarolKyneaApp::ValidateOptions(void)
       if (ii_MaxN <= ii_MinN)
          FatalError("The value for -N must be greater than the value for -n");
 
-      iv_MinusTerms.resize(ii_MaxN - ii_MinN + 1);
-      std::fill(iv_MinusTerms.begin(), iv_MinusTerms.end(), true);
+      iv_MinusTerms.Resize(ii_MaxN - ii_MinN + 1);
+      iv_MinusTerms.Fill(true);
 
-      iv_PlusTerms.resize(ii_MaxN - ii_MinN + 1);
-      std::fill(iv_PlusTerms.begin(), iv_PlusTerms.end(), true);
+      iv_PlusTerms.Resize(ii_MaxN - ii_MinN + 1);
+      iv_PlusTerms.Fill(true);
 
       il_TermCount = 2 * (ii_MaxN - ii_MinN + 1);
 
       // (2^1+1)-2 =  1, so remove that term
       if (ii_MinN == 1 && ii_Base == 2)
       {
-         iv_PlusTerms[BIT(1)] = false;
+         iv_PlusTerms.Clear(BIT(1));
          il_TermCount--;
       }
 
@@ -125,7 +125,7 @@ void CarolKyneaApp::ValidateOptions(void)
       // (4^1-1)-2 =  1, so remove that term
       if (ii_MinN == 1 && ii_Base <= 4)
       {
-         iv_MinusTerms[BIT(1)] = false;
+         iv_MinusTerms.Clear(BIT(1));
          il_TermCount--;
       }
    }
@@ -193,13 +193,13 @@ void CarolKyneaApp::ProcessInputTermsFile(bool haveBitMap)
       {
          if (c == +1)
          {
-            iv_PlusTerms[BIT(n)] = true;
+            iv_PlusTerms.Set(BIT(n));
             il_TermCount++;
          }
 
          if (c == -1)
          {
-            iv_MinusTerms[BIT(n)] = true;
+            iv_MinusTerms.Set(BIT(n));
             il_TermCount++;
          }
       }
@@ -235,7 +235,7 @@ bool CarolKyneaApp::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (c == +1 && iv_MinusTerms[bit])
    {
-      iv_MinusTerms[bit] = false;
+      iv_MinusTerms.Clear(bit);
       il_TermCount--;
 
       return true;
@@ -243,7 +243,7 @@ bool CarolKyneaApp::ApplyFactor(uint64_t theFactor, const char *term)
 
    if (c == +1 && iv_PlusTerms[bit])
    {
-      iv_PlusTerms[bit] = false;
+      iv_PlusTerms.Clear(bit);
       il_TermCount--;
 
       return true;
@@ -308,7 +308,7 @@ bool CarolKyneaApp::ReportFactor(uint64_t theFactor, uint32_t n, int32_t c)
 
    if (c == -1 && iv_MinusTerms[bit])
    {
-      iv_MinusTerms[bit] = false;
+      iv_MinusTerms.Clear(bit);
       removedTerm = true;
 
       il_TermCount--;
@@ -319,7 +319,7 @@ bool CarolKyneaApp::ReportFactor(uint64_t theFactor, uint32_t n, int32_t c)
 
    if (c == +1 && iv_PlusTerms[bit])
    {
-      iv_PlusTerms[bit] = false;
+      iv_PlusTerms.Clear(bit);
       removedTerm = true;
 
       il_TermCount--;
@@ -345,7 +345,7 @@ void CarolKyneaApp::ReportPrime(uint64_t thePrime, uint32_t n, int32_t c)
 
    if (c == -1 && iv_MinusTerms[bit])
    {
-      iv_MinusTerms[bit] = false;
+      iv_MinusTerms.Clear(bit);
 
       il_TermCount--;
       il_FactorCount++;
@@ -357,7 +357,7 @@ void CarolKyneaApp::ReportPrime(uint64_t thePrime, uint32_t n, int32_t c)
 
    if (c == +1 && iv_PlusTerms[bit])
    {
-      iv_PlusTerms[bit] = false;
+      iv_PlusTerms.Clear(bit);
 
       il_TermCount--;
       il_FactorCount++;
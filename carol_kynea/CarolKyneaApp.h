@@ -46,8 +46,8 @@ protected:
    void              WriteOutputTermsFile(uint64_t largestPrime);
 
 private:
-   std::vector<bool> iv_PlusTerms;
-   std::vector<bool> iv_MinusTerms;
+   TermBitmap        iv_PlusTerms;
+   TermBitmap        iv_MinusTerms;
 
    uint32_t          ii_Base;
    uint32_t          ii_MinN;
@@ -0,0 +1,367 @@
+/* Affinity.cpp -- (C) Mark Rodenkirch, October 2026
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "Affinity.h"
+
+#define MAX_CPU_ID   4096
+
+Affinity::Affinity(void)
+{
+   it_Policy = AP_NONE;
+   ii_NodeCount = 1;
+   ib_HaveSavedAffinity = false;
+}
+
+bool  Affinity::SetPolicy(const char *policy)
+{
+   const char *ptr = policy;
+   char       *end;
+   uint32_t    first, last;
+
+   iv_CpuList.clear();
+
+   if (!strcmp(policy, "none"))
+   {
+      it_Policy = AP_NONE;
+      return true;
+   }
+
+   if (!strcmp(policy, "compact"))
+   {
+      it_Policy = AP_COMPACT;
+      return true;
+   }
+
+   if (!strcmp(policy, "scatter"))
+   {
+      it_Policy = AP_SCATTER;
+      return true;
+   }
+
+   // Otherwise this is a list of logical CPUs and ranges of logical CPUs
+   while (*ptr)
+   {
+      if (*ptr < '0' || *ptr > '9')
+         return false;
+
+      first = last = (uint32_t) strtoul(ptr, &end, 10);
+      ptr = end;
+
+      if (*ptr == '-')
+      {
+         ptr++;
+
+         if (*ptr < '0' || *ptr > '9')
+            return false;
+
+         last = (uint32_t) strtoul(ptr, &end, 10);
+         ptr = end;
+      }
+
+      if (first > last || last >= MAX_CPU_ID)
+         return false;
+
+      for (uint32_t cpu=first; cpu<=last; cpu++)
+         iv_CpuList.push_back((int32_t) cpu);
+
+      if (*ptr == ',')
+         ptr++;
+      else if (*ptr != 0)
+         return false;
+   }
+
+   if (iv_CpuList.size() == 0)
+      return false;
+
+   it_Policy = AP_LIST;
+   return true;
+}
+
+void  Affinity::Initialize(void)
+{
+   if (it_Policy == AP_NONE)
+      return;
+
+   ReadTopology();
+
+   OrderCpus();
+}
+
+int32_t  Affinity::GetCpuForWorker(uint32_t workerId)
+{
+   if (it_Policy == AP_NONE || iv_CpuOrder.size() == 0)
+      return NO_CPU;
+
+   // Worker 0 is the special CPU worker which only exists if there are no other CPU workers
+   if (workerId > 0)
+      workerId--;
+
+   return iv_CpuOrder[workerId % iv_CpuOrder.size()];
+}
+
+uint32_t  Affinity::GetNodeForCpu(int32_t cpu)
+{
+   for (cpuinfo_t &cpuInfo : iv_Cpus)
+      if (cpuInfo.cpu == cpu)
+         return cpuInfo.node;
+
+   return 0;
+}
+
+#if !defined(WIN32) && !defined(__APPLE__)
+static uint32_t ReadTopologyValue(int32_t cpu, const char *what, uint32_t defaultValue)
+{
+   char      fileName[200];
+   FILE     *fPtr;
+   uint32_t  value;
+
+   sprintf(fileName, "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, what);
+
+   fPtr = fopen(fileName, "r");
+
+   if (fPtr == NULL)
+      return defaultValue;
+
+   if (fscanf(fPtr, "%u", &value) != 1)
+      value = defaultValue;
+
+   fclose(fPtr);
+
+   return value;
+}
+
+static void ReadNodeCpus(uint32_t node, uint32_t *cpuNodes)
+{
+   char      fileName[200];
+   char      buffer[4000];
+   char     *ptr, *end;
+   FILE     *fPtr;
+   uint32_t  first, last;
+
+   sprintf(fileName, "/sys/devices/system/node/node%u/cpulist", node);
+
+   fPtr = fopen(fileName, "r");
+
+   if (fPtr == NULL)
+      return;
+
+   if (fgets(buffer, sizeof(buffer), fPtr) == NULL)
+      buffer[0] = 0;
+
+   fclose(fPtr);
+
+   // The format is the same as the list accepted by -a, such as "0-7,16-23"
+   ptr = buffer;
+   while (*ptr >= '0' && *ptr <= '9')
+   {
+      first = last = (uint32_t) strtoul(ptr, &end, 10);
+      ptr = end;
+
+      if (*ptr == '-')
+      {
+         last = (uint32_t) strtoul(ptr + 1, &end, 10);
+         ptr = end;
+      }
+
+      for (uint32_t cpu=first; cpu<=last && cpu<MAX_CPU_ID; cpu++)
+         cpuNodes[cpu] = node;
+
+      if (*ptr == ',')
+         ptr++;
+   }
+}
+#endif
+
+void  Affinity::ReadTopology(void)
+{
+   cpuinfo_t cpuInfo;
+
+   iv_Cpus.clear();
+   ii_NodeCount = 1;
+
+#if defined(WIN32)
+   DWORD_PTR processMask, systemMask;
+
+   if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+      return;
+
+   for (int32_t cpu=0; cpu<64; cpu++)
+   {
+      if (!(processMask & (1ULL << cpu)))
+         continue;
+
+      UCHAR node = 0;
+
+      GetNumaProcessorNode((UCHAR) cpu, &node);
+
+      // Windows doesn't give us an easy way to identify SMT siblings, so treat each
+      // logical CPU as its own core.
+      cpuInfo.cpu = cpu;
+      cpuInfo.node = (node < MAX_NUMA_NODES ? node : 0);
+      cpuInfo.package = cpuInfo.node;
+      cpuInfo.core = cpu;
+
+      iv_Cpus.push_back(cpuInfo);
+   }
+#elif !defined(__APPLE__)
+   cpu_set_t cpuSet;
+   uint32_t *cpuNodes = (uint32_t *) xmalloc(MAX_CPU_ID * sizeof(uint32_t));
+
+   if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) != 0)
+   {
+      xfree(cpuNodes);
+      return;
+   }
+
+   for (uint32_t node=0; node<MAX_NUMA_NODES; node++)
+      ReadNodeCpus(node, cpuNodes);
+
+   for (int32_t cpu=0; cpu<CPU_SETSIZE && cpu<MAX_CPU_ID; cpu++)
+   {
+      if (!CPU_ISSET(cpu, &cpuSet))
+         continue;
+
+      cpuInfo.cpu = cpu;
+      cpuInfo.node = cpuNodes[cpu];
+      cpuInfo.package = ReadTopologyValue(cpu, "physical_package_id", 0);
+      cpuInfo.core = ReadTopologyValue(cpu, "core_id", cpu);
+
+      iv_Cpus.push_back(cpuInfo);
+   }
+
+   xfree(cpuNodes);
+#endif
+
+   // Now determine which logical CPUs share a core and the rank of each core in its node
+   for (uint32_t ii=0; ii<iv_Cpus.size(); ii++)
+   {
+      iv_Cpus[ii].smtIndex = 0;
+      iv_Cpus[ii].coreIndex = 0;
+
+      for (uint32_t jj=0; jj<ii; jj++)
+      {
+         if (iv_Cpus[jj].node != iv_Cpus[ii].node)
+            continue;
+
+         if (iv_Cpus[jj].package == iv_Cpus[ii].package && iv_Cpus[jj].core == iv_Cpus[ii].core)
+         {
+            iv_Cpus[ii].smtIndex++;
+            iv_Cpus[ii].coreIndex = iv_Cpus[jj].coreIndex;
+         }
+      }
+
+      if (iv_Cpus[ii].smtIndex > 0)
+         continue;
+
+      for (uint32_t jj=0; jj<ii; jj++)
+         if (iv_Cpus[jj].node == iv_Cpus[ii].node && iv_Cpus[jj].smtIndex == 0)
+            iv_Cpus[ii].coreIndex++;
+   }
+
+   for (cpuinfo_t &cpu : iv_Cpus)
+      if (cpu.node + 1 > ii_NodeCount)
+         ii_NodeCount = cpu.node + 1;
+}
+
+void  Affinity::OrderCpus(void)
+{
+   std::vector<cpuinfo_t> cpus = iv_Cpus;
+
+   iv_CpuOrder.clear();
+
+   if (it_Policy == AP_LIST)
+   {
+      iv_CpuOrder = iv_CpuList;
+      return;
+   }
+
+   // Compact fills every logical CPU of a core, then every core of a node, before
+   // moving to the next node.  This keeps workers that share data close together.
+   if (it_Policy == AP_COMPACT)
+      std::sort(cpus.begin(), cpus.end(), [](const cpuinfo_t &a, const cpuinfo_t &b) {
+         if (a.node != b.node) return a.node < b.node;
+         if (a.package != b.package) return a.package < b.package;
+         if (a.core != b.core) return a.core < b.core;
+         return a.cpu < b.cpu;
+      });
+
+   // Scatter alternates between nodes and uses one logical CPU of each core before
+   // using any SMT sibling.  This gives each worker as much cache and memory bandwidth
+   // as possible.
+   if (it_Policy == AP_SCATTER)
+      std::sort(cpus.begin(), cpus.end(), [](const cpuinfo_t &a, const cpuinfo_t &b) {
+         if (a.smtIndex != b.smtIndex) return a.smtIndex < b.smtIndex;
+         if (a.coreIndex != b.coreIndex) return a.coreIndex < b.coreIndex;
+         if (a.node != b.node) return a.node < b.node;
+         return a.cpu < b.cpu;
+      });
+
+   for (cpuinfo_t &cpu : cpus)
+      iv_CpuOrder.push_back(cpu.cpu);
+}
+
+bool  Affinity::PinCurrentThread(int32_t cpu)
+{
+   if (cpu == NO_CPU)
+      return false;
+
+#if defined(WIN32)
+   if (cpu >= 64)
+      return false;
+
+   return (SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) 1 << cpu) != 0);
+#elif defined(__APPLE__)
+   // macOS doesn't support binding a thread to a logical CPU
+   return false;
+#else
+   cpu_set_t cpuSet;
+
+   CPU_ZERO(&cpuSet);
+   CPU_SET(cpu, &cpuSet);
+
+   return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+#endif
+}
+
+void  Affinity::SaveThreadAffinity(void)
+{
+#if defined(WIN32)
+   DWORD_PTR processMask, systemMask;
+
+   if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+   {
+      il_SavedMask = (uint64_t) processMask;
+      ib_HaveSavedAffinity = true;
+   }
+#elif !defined(__APPLE__)
+   ib_HaveSavedAffinity = (pthread_getaffinity_np(pthread_self(), sizeof(ic_SavedCpuSet), &ic_SavedCpuSet) == 0);
+#endif
+}
+
+void  Affinity::RestoreThreadAffinity(void)
+{
+   if (!ib_HaveSavedAffinity)
+      return;
+
+#if defined(WIN32)
+   SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) il_SavedMask);
+#elif !defined(__APPLE__)
+   pthread_setaffinity_np(pthread_self(), sizeof(ic_SavedCpuSet), &ic_SavedCpuSet);
+#endif
+
+   ib_HaveSavedAffinity = false;
+}
@@ -0,0 +1,88 @@
+/* Affinity.h -- (C) Mark Rodenkirch, October 2026
+
+   This class determines which logical CPU each worker is pinned to based upon
+   the CPU topology (NUMA node, package, core) and the policy given with -a.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifndef _AFFINITY_H
+#define _AFFINITY_H
+
+#include <vector>
+#include "main.h"
+
+#if !defined(WIN32) && !defined(__APPLE__)
+#include <sched.h>
+#endif
+
+#define MAX_NUMA_NODES     64
+#define NO_CPU             -1
+
+typedef enum { AP_NONE, AP_COMPACT, AP_SCATTER, AP_LIST } affinitypolicy_t;
+
+typedef struct {
+   int32_t  cpu;
+   uint32_t node;
+   uint32_t package;
+   uint32_t core;
+   uint32_t smtIndex;   // 0 for the first logical CPU of a core, 1 for its sibling, etc.
+   uint32_t coreIndex;  // The rank of this core amongst the cores in the same node
+} cpuinfo_t;
+
+class Affinity
+{
+public:
+   Affinity(void);
+
+   // Accepts "none", "compact", "scatter" or a list of logical CPUs such as "0,2,4-7".
+   // Returns false if the policy cannot be parsed.
+   bool              SetPolicy(const char *policy);
+
+   // This must be called before GetCpuForWorker() as it reads the topology.
+   void              Initialize(void);
+
+   bool              IsEnabled(void) { return (it_Policy != AP_NONE); };
+   uint32_t          GetNodeCount(void) { return ii_NodeCount; };
+
+   // Returns NO_CPU if the worker is not to be pinned
+   int32_t           GetCpuForWorker(uint32_t workerId);
+   uint32_t          GetNodeForCpu(int32_t cpu);
+
+   // Pin the calling thread to a single logical CPU.  This returns false if the
+   // OS doesn't support it or if the CPU is not available to this process.
+   static bool       PinCurrentThread(int32_t cpu);
+
+   // Save and restore the affinity of the calling thread.  The main thread uses
+   // this so that memory allocated while creating a worker is first touched on
+   // the node of that worker.
+   void              SaveThreadAffinity(void);
+   void              RestoreThreadAffinity(void);
+
+private:
+   void              ReadTopology(void);
+   void              OrderCpus(void);
+
+   affinitypolicy_t  it_Policy;
+   uint32_t          ii_NodeCount;
+   bool              ib_HaveSavedAffinity;
+
+   std::vector<cpuinfo_t> iv_Cpus;
+
+   // The order in which workers are assigned to logical CPUs
+   std::vector<int32_t>   iv_CpuOrder;
+
+   // The logical CPUs given on the command line
+   std::vector<int32_t>   iv_CpuList;
+
+#if defined(WIN32)
+   uint64_t          il_SavedMask;
+#elif !defined(__APPLE__)
+   cpu_set_t         ic_SavedCpuSet;
+#endif
+};
+
+#endif
@@ -21,7 +21,7 @@
 #include "../gpu_metal/MetalDevice.h"
 #endif
 
-#ifdef USE_X86
+#ifdef USE_X87
 #include "../x86_asm/fpu-asm-x86.h"
 #endif
 
@@ -40,7 +40,7 @@
 
 App::App(void)
 {
-#ifdef USE_X86
+#ifdef USE_X87
    ii_SavedFpuMode = fpu_mod_init();
 #endif
 
@@ -50,16 +50,24 @@ App::App(void)
    ii_CpuWorkerCount = 0;
    ii_GpuWorkerCount = 0;
    il_TotalSieveUS = 0;
+   il_TotalDispatchCount = 0;
+   il_TotalDispatchLatencyUS = 0;
+   il_MaxDispatchLatencyUS = 0;
+
+   ik_MegaChunkStats.calls = ik_MegaChunkStats.primes = ik_MegaChunkStats.elapsedUS = 0;
+   ik_MiniChunkStats.calls = ik_MiniChunkStats.primes = ik_MiniChunkStats.elapsedUS = 0;
+
+   for (uint32_t id=0; id<MAX_COUNTERS; id++)
+      il_CounterTotals[id] = 0;
 
    ip_Console = new SharedMemoryItem("console");
-   ip_AppStatus = new SharedMemoryItem("appstatus");
-   ip_SievingStatus = new SharedMemoryItem("sievestatus");
-   ip_NeedToRebuild = new SharedMemoryItem("rebuild");
+   ip_WorkerReady = new SharedMemoryItem("workerready", true);
 
    icot_LastConsoleOutputType = COT_OTHER;
 
-   ip_AppStatus->SetValueNoLock(AS_INITIALIZING);
-   ip_SievingStatus->SetValueNoLock(SS_NOT_STARTED);
+   SetAppStatus(AS_INITIALIZING);
+   SetSievingStatus(SS_NOT_STARTED);
+   SetRebuildCompleted();
 
    // The application cannot exceeds these max values
    il_AppMinPrime = PMIN_MIN;
@@ -70,6 +78,11 @@ App::App(void)
    il_MaxPrimeForSingleWorker = 0;
    il_LargestPrimeSieved = 0;
 
+   ib_AllowWidePrimes = false;
+   il_PrimeBase = 0;
+   il_WideMinPrime = 0;
+   il_WideMaxPrime = 0;
+
    // We want this to be a multiple of 16 as any AVX code requires this (see AVX_ARRAY_SIZE).
    // Not many sieves  use AVX, but since the Worker thread will change the number of primes
    // per thread dynamically, this should be okay.
@@ -79,9 +92,20 @@ App::App(void)
    il_MinGpuPrime = 0;
    ib_HaveCreatedWorkers = false;
    ib_SetMinPrimeFromCommandLine = false;
+   ib_SetMaxPrimeFromCommandLine = false;
+   ibf_BenchFormat = BF_NONE;
+   ii_Lanes = 0;
+   ipk_PowModKernel = PK_AUTO;
 
    ip_Workers = (Worker **) xmalloc((MAX_WORKERS + 1) * sizeof(Worker *));
 
+   ip_Affinity = new Affinity();
+
+   for (uint32_t node=0; node<MAX_NUMA_NODES; node++)
+      il_NodePrimesTested[node] = 0;
+
+   il_LastNodeReportUS = 0;
+
 #if defined(USE_OPENCL)
    ip_GpuDevice = new OpenCLDevice();
    ii_GpuWorkGroups = 8;
@@ -100,9 +124,8 @@ App::~App(void)
    xfree(ip_Workers);
 
    delete ip_Console;
-   delete ip_AppStatus;
-   delete ip_SievingStatus;
-   delete ip_NeedToRebuild;
+   delete ip_WorkerReady;
+   delete ip_Affinity;
 
 
 #if defined(USE_OPENCL) || defined(USE_METAL)
@@ -110,7 +133,7 @@ App::~App(void)
    delete ip_GpuDevice;
 #endif
 
-#ifdef USE_X86
+#ifdef USE_X87
    fpu_mod_fini(ii_SavedFpuMode);
 #endif
 }
@@ -128,8 +151,17 @@ void App::ParentHelp(void)
 
    printf("-p --pmin=P0          sieve start: P0 < p (default %" PRIu64")\n", il_AppMinPrime);
    printf("-P --pmax=P1          sieve end: p < P1 (default %s)\n", maxPrime);
+
+   if (ib_AllowWidePrimes)
+      printf("                      P0 and P1 can be up to 2^127 if P1 - P0 < %s\n", maxPrime);
+
    printf("-w --worksize=w       initial primes per chunk of work (default %u)\n", ii_CpuWorkSize);
    printf("-W --workers=W        start W workers (default %u)\n", ii_CpuWorkerCount);
+   printf("-a --affinity=a       pin workers to CPUs: none, compact, scatter or a list like 0,2,4-7 (default none)\n");
+   printf("-e --bench=e          test a fixed range of primes without logging factors, then report rates as json or csv\n");
+   printf("-u --counters         output the counters and timers of the workers with each status report\n");
+   printf("-j --lanes=j          primes per group in workers that support it: 4, 8, 16 or auto (default auto)\n");
+   printf("-E --kernel=E         b^n mod p in workers that support it: fpu, mont, avx512 or auto (default auto)\n");
 
 #if defined(USE_OPENCL) || defined(USE_METAL)
    printf("-g --gpuworkgroups=g  work groups per call to GPU (default %u)\n", ii_GpuWorkGroups);
@@ -141,12 +173,17 @@ void App::ParentHelp(void)
 
 void  App::ParentAddCommandLineOptions(std::string &shortOpts, struct option *longOpts)
 {
-   shortOpts += "p:P:w:W:";
+   shortOpts += "p:P:w:W:a:e:uj:E:";
 
    AppendLongOpt(longOpts, "pmin",          required_argument, 0, 'p');
    AppendLongOpt(longOpts, "pmax",          required_argument, 0, 'P');
    AppendLongOpt(longOpts, "worksize",      required_argument, 0, 'w');
    AppendLongOpt(longOpts, "workers",       required_argument, 0, 'W');
+   AppendLongOpt(longOpts, "affinity",      required_argument, 0, 'a');
+   AppendLongOpt(longOpts, "bench",         required_argument, 0, 'e');
+   AppendLongOpt(longOpts, "counters",      no_argument,       0, 'u');
+   AppendLongOpt(longOpts, "lanes",         required_argument, 0, 'j');
+   AppendLongOpt(longOpts, "kernel",        required_argument, 0, 'E');
 
 #if defined(USE_OPENCL) || defined(USE_METAL)
    shortOpts += "g:G:";
@@ -167,6 +204,8 @@ parse_t App::ParentParseOption(int opt, char *arg, const char *source)
 {
    parse_t      status = P_UNSUPPORTED;
    uint64_t     minPrime;
+   __uint128_t  widePrime = 0;
+   uint32_t     lanes;
 
 #if defined(USE_OPENCL) || defined(USE_METAL)
    status = ip_GpuDevice->ParseOption(opt, arg, source);
@@ -178,19 +217,90 @@ parse_t App::ParentParseOption(int opt, char *arg, const char *source)
    switch (opt)
    {
       case 'p':
-         status = Parser::Parse(arg, il_AppMinPrime, il_AppMaxPrime-1, minPrime);
-         SetMinPrime(minPrime);
+         if (ib_AllowWidePrimes)
+         {
+            status = Parser::Parse(arg, il_AppMinPrime, PMAX_MAX_WIDE-1, widePrime);
+            SetWideMinPrime(widePrime);
+         }
+         else
+         {
+            status = Parser::Parse(arg, il_AppMinPrime, il_AppMaxPrime-1, minPrime);
+            SetMinPrime(minPrime);
+         }
          ib_SetMinPrimeFromCommandLine = true;
          break;
 
       case 'P':
-         status = Parser::Parse(arg, il_AppMinPrime+1, il_AppMaxPrime, il_MaxPrime);
+         if (ib_AllowWidePrimes)
+         {
+            status = Parser::Parse(arg, il_AppMinPrime+1, PMAX_MAX_WIDE-1, widePrime);
+
+            if (status != P_SUCCESS)
+               break;
+
+            if (widePrime <= il_AppMaxPrime)
+               il_MaxPrime = (uint64_t) widePrime;
+            else
+               il_WideMaxPrime = widePrime;
+         }
+         else
+            status = Parser::Parse(arg, il_AppMinPrime+1, il_AppMaxPrime, il_MaxPrime);
+         ib_SetMaxPrimeFromCommandLine = true;
          break;
 
       case 'w':
          status = Parser::Parse(arg, 10, 1000000000, ii_CpuWorkSize);
          break;
 
+      case 'a':
+         status = (ip_Affinity->SetPolicy(arg) ? P_SUCCESS : P_FAILURE);
+         break;
+
+      case 'e':
+         status = P_SUCCESS;
+         if (!strcmp(arg, "json"))
+            ibf_BenchFormat = BF_JSON;
+         else if (!strcmp(arg, "csv"))
+            ibf_BenchFormat = BF_CSV;
+         else
+            status = P_FAILURE;
+         break;
+
+      case 'u':
+         Counters::Enable();
+         status = P_SUCCESS;
+         break;
+
+      case 'j':
+         if (!strcmp(arg, "auto"))
+         {
+            ii_Lanes = 0;
+            status = P_SUCCESS;
+            break;
+         }
+
+         status = Parser::Parse(arg, 4, 16, lanes);
+
+         if (status == P_SUCCESS && lanes != 4 && lanes != 8 && lanes != 16)
+            status = P_FAILURE;
+
+         ii_Lanes = lanes;
+         break;
+
+      case 'E':
+         status = P_SUCCESS;
+         if (!strcmp(arg, "auto"))
+            ipk_PowModKernel = PK_AUTO;
+         else if (!strcmp(arg, "fpu"))
+            ipk_PowModKernel = PK_FPU;
+         else if (!strcmp(arg, "mont"))
+            ipk_PowModKernel = PK_MONT;
+         else if (!strcmp(arg, "avx512"))
+            ipk_PowModKernel = PK_AVX512;
+         else
+            status = P_FAILURE;
+         break;
+
 #if defined(USE_OPENCL) || defined(USE_METAL)
       case 'W':
          status = Parser::Parse(arg, 0, MAX_WORKERS, ii_CpuWorkerCount);
@@ -233,11 +343,40 @@ void App::ParentValidateOptions(void)
    while (ii_CpuWorkSize & 0x10)
       ii_CpuWorkSize++;
 
+   if (il_WideMinPrime > 0 || il_WideMaxPrime > 0)
+   {
+      char  maxPrime[30];
+
+      ConvertNumberToShortString(il_AppMaxPrime, (char *) maxPrime);
+
+      if (il_WideMinPrime == 0)
+         FatalError("pmin must be at least %s when pmax is greater than %s", maxPrime, maxPrime);
+
+      if (il_WideMaxPrime == 0)
+         FatalError("pmax must be given when pmin is at least %s", maxPrime);
+
+      if (il_WideMaxPrime <= il_WideMinPrime)
+         FatalError("pmin must be less than pmax");
+
+      if (il_WideMaxPrime - il_WideMinPrime >= il_AppMaxPrime)
+         FatalError("pmax - pmin must be less than %s", maxPrime);
+
+      // The range of primes starts at il_MinPrime, which can't be 0
+      il_PrimeBase = il_WideMinPrime - 1;
+      il_MinPrime = 1;
+      il_MaxPrime = (uint64_t) (il_WideMaxPrime - il_PrimeBase);
+   }
+
    if (il_MinPrime >= il_MaxPrime)
       FatalError("pmin must be less than pmax");
 
    ii_TotalWorkerCount = ii_CpuWorkerCount + ii_GpuWorkerCount;
 
+   ip_Affinity->Initialize();
+
+   if (ip_Affinity->IsEnabled() && ip_Affinity->GetCpuForWorker(1) == NO_CPU)
+      WriteToConsole(COT_OTHER, "Workers cannot be pinned to CPUs on this platform");
+
 #if defined(USE_OPENCL) || defined(USE_METAL)
    ip_GpuDevice->ValidateOptions();
 #endif
@@ -275,6 +414,32 @@ void App::ConvertNumberToShortString(uint64_t value, char *buffer)
    sprintf(buffer, "%" PRIu64"e%u", value, e);
 }
 
+// This is base + value in decimal
+void App::ConvertPrimeToString(uint64_t value, char *buffer)
+{
+   if (il_PrimeBase == 0)
+      sprintf(buffer, "%" PRIu64"", value);
+   else
+      ConvertWideNumberToString(il_PrimeBase + value, buffer);
+}
+
+void App::ConvertWideNumberToString(__uint128_t value, char *buffer)
+{
+   char     digits[50];
+   uint32_t count = 0;
+
+   do
+   {
+      digits[count++] = '0' + (char) (value % 10);
+      value /= 10;
+   } while (value > 0);
+
+   while (count > 0)
+      *buffer++ = digits[--count];
+
+   *buffer = 0;
+}
+
 void App::SetLogFileName(std::string logFileName)
 {
    is_LogFileName = logFileName;
@@ -354,14 +519,17 @@ void  App::StopWorkers(void)
    int64_t  iter = 0;
 
    // This tells the Workers to stop as soon as possible.
-   ip_SievingStatus->SetValueNoLock(SS_DONE);
+   SetSievingStatus(SS_DONE);
+
+   // Workers waiting for work need to be woken so that they see that sieving is done
+   WakeWorkers();
 
    count = 1;
    while (count)
    {
       CheckReportStatus();
 
-      Sleep(100);
+      WaitForReadyWorker(100);
 
       count = 0;
 
@@ -383,13 +551,49 @@ void  App::StopWorkers(void)
    }
 }
 
+void  App::NotifyWorkerReady(void)
+{
+   ip_WorkerReady->Lock();
+   ip_WorkerReady->SetValueHaveLock(ip_WorkerReady->GetValueHaveLock() + 1);
+   ip_WorkerReady->ClearCondition();
+   ip_WorkerReady->Release();
+}
+
+// Block until a worker has become ready since the last call or until timeoutMS
+// has elapsed.  The caller has to check the workers to find out which is ready.
+void  App::WaitForReadyWorker(uint32_t timeoutMS)
+{
+   ip_WorkerReady->Lock();
+
+   if (ip_WorkerReady->GetValueHaveLock() == 0)
+      ip_WorkerReady->WaitForCondition(timeoutMS);
+
+   ip_WorkerReady->SetValueHaveLock(0);
+   ip_WorkerReady->Release();
+}
+
+void  App::WakeWorkers(void)
+{
+   for (uint32_t ii=0; ii<=ii_TotalWorkerCount; ii++)
+   {
+      // ip_Worker[0] is the special CPU worker (if we need one)
+      if (ii == 0 && ip_Workers[0] == NULL)
+         continue;
+
+      ip_Workers[ii]->Wake();
+   }
+}
+
 void  App::Interrupt(void)
 {
-   ip_AppStatus->SetValueNoLock(AS_INTERRUPTED);
+   SetAppStatus(AS_INTERRUPTED);
 
    uint64_t maxPrime = (il_LargestPrimeSieved > il_MaxPrime ? il_MaxPrime : il_LargestPrimeSieved);
+   char     maxPrimeStr[50];
+
+   ConvertPrimeToString(maxPrime, maxPrimeStr);
 
-   WriteToConsole(COT_OTHER, "CTRL-C accepted.  Threads will stop after sieving to %" PRIu64"", maxPrime);
+   WriteToConsole(COT_OTHER, "CTRL-C accepted.  Threads will stop after sieving to %s", maxPrimeStr);
 }
 
 void  App::SetMinPrime(uint64_t minPrime)
@@ -400,6 +604,22 @@ void  App::SetMinPrime(uint64_t minPrime)
    il_MinPrime = minPrime;
 }
 
+// This is for apps that call AllowWidePrimes().  If minPrime is too large for il_MinPrime,
+// then ParentValidateOptions() makes it the prime base.
+void  App::SetWideMinPrime(__uint128_t minPrime)
+{
+   if (ib_SetMinPrimeFromCommandLine)
+      return;
+
+   if (minPrime < il_AppMaxPrime)
+   {
+      il_MinPrime = (uint64_t) minPrime;
+      il_WideMinPrime = 0;
+   }
+   else
+      il_WideMinPrime = minPrime;
+}
+
 // Overrice the max prime to be sieved so that we can guarantee
 // that all remaining terms are prime.
 void  App::SetMaxPrime(uint64_t maxPrime, const char *why)
@@ -415,7 +635,10 @@ void  App::Run(void)
 
    ValidateOptions();
 
-#ifdef USE_X86
+   if (IsBenchmarking())
+      SetBenchRange();
+
+#ifdef USE_X87
    ii_SavedFpuMode = fpu_mod_init();
 #endif
 
@@ -440,6 +663,19 @@ void  App::Run(void)
    } while (!isDone);
 }
 
+// Use the same range of primes for every benchmark so that the results can be compared
+// across builds and hardware.  The range is only changed if the app allows it.
+void  App::SetBenchRange(void)
+{
+   if (!ib_SetMinPrimeFromCommandLine && il_AppMinPrime <= BENCH_MIN_PRIME && il_MaxPrime > BENCH_MIN_PRIME)
+      il_MinPrime = BENCH_MIN_PRIME;
+
+   if (!ib_SetMaxPrimeFromCommandLine && il_MaxPrime > il_MinPrime + BENCH_PRIME_RANGE)
+      il_MaxPrime = il_MinPrime + BENCH_PRIME_RANGE;
+
+   WriteToConsole(COT_OTHER, "Benchmarking %" PRIu64" < p < %" PRIu64".  Factors will not be logged.", il_MinPrime, il_MaxPrime);
+}
+
 void  App::Sieve(void)
 {
    uint32_t th;
@@ -453,8 +689,8 @@ void  App::Sieve(void)
 
    LogStartSievingMessage();
 
-   ip_AppStatus->SetValueNoLock(AS_RUNNING);
-   ip_SievingStatus->SetValueNoLock(SS_SIEVING);
+   SetAppStatus(AS_RUNNING);
+   SetSievingStatus(SS_SIEVING);
 
    il_LargestPrimeSieved = il_MinPrime - 1;
    il_StartSievingUS = Clock::GetCurrentMicrosecond();
@@ -464,8 +700,6 @@ void  App::Sieve(void)
 
    useSingleThread = (il_LargestPrimeSieved < il_MaxPrimeForSingleWorker);
 
-   ip_PrimeIterator.jump_to(il_LargestPrimeSieved+1, il_MaxPrime);
-
    // In the first loop, run until we no longer need to use a single worker or until we can switch to the GPU.
    while ((useSingleThread || il_LargestPrimeSieved < il_MinGpuPrime) && il_LargestPrimeSieved < il_MaxPrime && IsRunning())
    {
@@ -487,10 +721,10 @@ void  App::Sieve(void)
          {
             CheckReportStatus();
 
-            Sleep(1000);
+            WaitForReadyWorker(1000);
          }
 
-         useSingleThread = (ip_Workers[th]->GetLargestPrimeTested() < il_MaxPrimeForSingleWorker);
+         useSingleThread = (il_LargestPrimeSieved < il_MaxPrimeForSingleWorker);
       }
    }
 
@@ -507,12 +741,8 @@ void  App::Sieve(void)
       // If rebuilding, then the largest prime tested might be smaller
       // than the largest prime sieved so we have to update it.
       if (IsRebuildNeeded())
-      {
          il_LargestPrimeSieved = PauseSievingAndRebuild();
 
-         ip_PrimeIterator.jump_to(il_LargestPrimeSieved+1, il_MaxPrime);
-      }
-
       stoppedCount = 0;
 
       for (th=0; th<=ii_TotalWorkerCount; th++)
@@ -527,16 +757,25 @@ void  App::Sieve(void)
             continue;
          }
 
-         if (ip_Workers[th]->IsStatusWaitingForWork())
+         if (il_LargestPrimeSieved >= il_MaxPrime)
+            break;
+
+         // Busy workers get their next range now so that they can start on it
+         // as soon as they finish their current range.
+         if (ip_Workers[th]->IsStatusWaitingForWork() || ip_Workers[th]->CanQueuePrimeRange())
          {
-            il_LargestPrimeSieved = GetPrimesForWorker(th);
-            gotNewWork = true;
+            uint64_t largestPrimeSieved = GetPrimesForWorker(th);
+
+            if (largestPrimeSieved > il_LargestPrimeSieved)
+               gotNewWork = true;
+
+            il_LargestPrimeSieved = largestPrimeSieved;
          }
       }
 
-      // If we didn't get any new work, sleep
+      // If we didn't get any new work, wait for a worker to finish its chunk
       if (!gotNewWork)
-         Sleep(1);
+         WaitForReadyWorker(100);
    }
 
    Finish();
@@ -589,61 +828,132 @@ uint32_t  App::GetNextAvailableWorker(bool useSingleThread, uint64_t &largestPri
             return th;
       }
 
-      // If we didn't find one, sleep
-      Sleep(1);
+      // If we didn't find one, wait for a worker to finish its chunk
+      WaitForReadyWorker(100);
    }
 }
 
+// Give the worker the next range of primes to test.  The worker will generate the primes
+// in that range so that prime generation is not bottlenecked on the main thread.  This
+// returns the largest value in the range or il_LargestPrimeSieved if the worker did not
+// take the range.
 uint64_t  App::GetPrimesForWorker(uint32_t th)
 {
-   uint64_t  sieveStartUS = Clock::GetThreadMicroseconds();
+   uint64_t  rangeStart = il_LargestPrimeSieved + 1;
+   uint64_t  rangeEnd;
+   double    primesInRange = (double) ip_Workers[th]->GetMaxWorkSize();
+   double    averageGap;
 
-   uint32_t  maxPrimesInList = ip_Workers[th]->GetMaxWorkSize();
-   uint64_t *primeList = ip_Workers[th]->GetPrimeList();
-   uint32_t  pIdx = 0;
+   // Use the prime number theorem to estimate the size of a range that has as many
+   // primes as the worker wants.  It doesn't matter if this is not accurate as the
+   // worker will use multiple passes if there are too many and the worker will adjust
+   // the work size if it has too few.
+   averageGap = log((double) MAX(rangeStart, 100));
+   averageGap = log((double) rangeStart + primesInRange * averageGap);
 
-   if (il_MaxPrimeForSingleWorker > 0 && il_MaxPrimeForSingleWorker > il_LargestPrimeSieved)
-   {
-      while (pIdx < maxPrimesInList && il_LargestPrimeSieved < il_MaxPrimeForSingleWorker)
-      {
-         il_LargestPrimeSieved = ip_PrimeIterator.next_prime();
-         primeList[pIdx] = il_LargestPrimeSieved;
-         pIdx++;
-      };
+   rangeEnd = rangeStart + (uint64_t) (primesInRange * averageGap);
 
-      // For AVX we want multiples of 16, so gurantee that in case AVX is used by the worker for this chunk
-      while (pIdx % 16 > 0)
-      {
-         il_LargestPrimeSieved = ip_PrimeIterator.next_prime();
-         primeList[pIdx] = il_LargestPrimeSieved;
-         pIdx++;
-      }
+   // This guarantees that only one worker will test primes below this value.
+   if (il_MaxPrimeForSingleWorker > 0 && il_MaxPrimeForSingleWorker >= rangeStart && rangeEnd > il_MaxPrimeForSingleWorker)
+      rangeEnd = il_MaxPrimeForSingleWorker + 1;
 
-   }
-   else
+   if (rangeEnd > il_MaxPrime)
+      rangeEnd = il_MaxPrime + 1;
+
+   // If the worker could not take the range, then give it to the next worker
+   if (!ip_Workers[th]->AssignPrimeRange(rangeStart, rangeEnd))
+      return il_LargestPrimeSieved;
+
+   return rangeEnd - 1;
+}
+
+// Give an idle worker the upper half of the untested part of the range of the worker
+// that has the most left to do.  This returns false if there was nothing worth taking.
+bool  App::StealPrimesForWorker(uint32_t th)
+{
+   uint64_t  unclaimed, mostUnclaimed = 0;
+   uint64_t  stolenStart, stolenEnd;
+   uint64_t  minSplitPoint = il_MaxPrimeForSingleWorker + 1;
+   uint32_t  victim = NO_WORKER;
+
+   // Only one worker can test primes below il_MaxPrimeForSingleWorker
+   if (il_MaxPrimeForSingleWorker == 0)
+      minSplitPoint = 0;
+
+#if defined(USE_OPENCL) || defined(USE_METAL)
+   if (ip_Workers[th]->IsGpuWorker() && minSplitPoint < il_MinGpuPrime)
+      minSplitPoint = il_MinGpuPrime;
+#endif
+
+   for (uint32_t ii=0; ii<=ii_TotalWorkerCount; ii++)
    {
-      while (pIdx < maxPrimesInList)
+      // ip_Worker[0] is the special CPU worker (if we need one)
+      if (ii == th || (ii == 0 && ip_Workers[0] == NULL))
+         continue;
+
+      if (!ip_Workers[ii]->IsStatusHasWorkToDo() && !ip_Workers[ii]->IsStatusWorking())
+         continue;
+
+      unclaimed = ip_Workers[ii]->GetUnclaimedRange();
+
+      if (unclaimed > mostUnclaimed)
       {
-         il_LargestPrimeSieved = ip_PrimeIterator.next_prime();
-         primeList[pIdx] = il_LargestPrimeSieved;
-         pIdx++;
+         mostUnclaimed = unclaimed;
+         victim = ii;
       }
    }
 
-   primeList[pIdx] = 0;
+   if (victim == NO_WORKER)
+      return false;
 
-   ip_Workers[th]->SetPrimesInList(pIdx);
+   if (!ip_Workers[victim]->SplitPrimeRange(minSplitPoint, stolenStart, stolenEnd))
+      return false;
+
+   ip_Workers[th]->SetPrimeRange(stolenStart, stolenEnd, true);
    ip_Workers[th]->SetStatusHasWorkToDo();
 
-   il_TotalSieveUS += (Clock::GetThreadMicroseconds() - sieveStartUS);
+   return true;
+}
+
+// This is called when there are no more ranges to give to workers.  Instead of leaving
+// workers idle until the others finish, have them take part of the range from busy workers.
+void  App::DrainWorkers(void)
+{
+   bool  isBusy = true;
+
+   while (isBusy)
+   {
+      isBusy = false;
 
-   return il_LargestPrimeSieved;
+      for (uint32_t th=0; th<=ii_TotalWorkerCount; th++)
+      {
+         // ip_Worker[0] is the special CPU worker (if we need one)
+         if (th == 0 && ip_Workers[0] == NULL)
+            continue;
+
+         if (ip_Workers[th]->IsStatusWaitingForWork())
+            StealPrimesForWorker(th);
+
+         if (ip_Workers[th]->IsStatusHasWorkToDo() || ip_Workers[th]->IsStatusWorking())
+            isBusy = true;
+      }
+
+      if (isBusy)
+      {
+         CheckReportStatus();
+
+         WaitForReadyWorker(100);
+      }
+   }
 }
 
 uint64_t  App::PauseSievingAndRebuild(void)
 {
    uint64_t  largestPrimeTested;
 
+   // Let idle workers help busy workers finish their ranges before stopping them.
+   DrainWorkers();
+
    StopWorkers();
 
    // We can pass true because all workers are stopped which means that
@@ -655,7 +965,7 @@ uint64_t  App::PauseSievingAndRebuild(void)
    DeleteWorkers();
 
    // Reset the sieving status since StopWorkers had changed to SS_DONE
-   ip_SievingStatus->SetValueNoLock(SS_SIEVING);
+   SetSievingStatus(SS_SIEVING);
 
    CreateWorkers(largestPrimeTested);
 
@@ -687,6 +997,19 @@ void  App::DeleteWorkers(void)
 
       ip_Workers[ii]->CleanUp();
 
+      il_TotalSieveUS += ip_Workers[ii]->GetPrimeGenerationUS();
+
+      il_TotalDispatchCount += ip_Workers[ii]->GetDispatchCount();
+      il_TotalDispatchLatencyUS += ip_Workers[ii]->GetDispatchLatencyUS();
+
+      if (ip_Workers[ii]->GetMaxDispatchLatencyUS() > il_MaxDispatchLatencyUS)
+         il_MaxDispatchLatencyUS = ip_Workers[ii]->GetMaxDispatchLatencyUS();
+
+      AddKernelStats(ik_MegaChunkStats, ip_Workers[ii]->GetMegaChunkStats());
+      AddKernelStats(ik_MiniChunkStats, ip_Workers[ii]->GetMiniChunkStats());
+
+      Counters::AddSlot(il_CounterTotals, ip_Workers[ii]->GetCounters());
+
       delete ip_Workers[ii];
    }
 }
@@ -698,6 +1021,10 @@ void  App::CreateWorkers(uint64_t largestPrimeTested)
 
    ip_Workers[0] = NULL;
 
+   // Run this thread on the CPU of each worker while creating it so that memory the
+   // worker allocates and initializes in its constructor is on the worker's node.
+   ip_Affinity->SaveThreadAffinity();
+
    if (ii_CpuWorkerCount == 0 && largestPrimeTested < il_MinGpuPrime)
    {
       // Worker "0" is only created if all of the following conditions are met:
@@ -706,6 +1033,8 @@ void  App::CreateWorkers(uint64_t largestPrimeTested)
       //    the next prime tested cannot be tested on a GPU
       WriteToConsole(COT_OTHER, "Creating CPU worker to use until p >= %" PRIu64"", il_MinGpuPrime);
 
+      Affinity::PinCurrentThread(GetCpuForWorker(0));
+
       ip_Workers[0] = CreateWorker(0, false, largestPrimeTested);
    }
 
@@ -714,17 +1043,27 @@ void  App::CreateWorkers(uint64_t largestPrimeTested)
    // This will create the workers and start executing them
    // Create the CPU workers first, then the GPU workers
    for (w=0; w<ii_CpuWorkerCount; w++, th++)
+   {
+      Affinity::PinCurrentThread(GetCpuForWorker(th));
+
       ip_Workers[th] = CreateWorker(th, false, largestPrimeTested);
+   }
 
    for (w=0; w<ii_GpuWorkerCount; w++, th++)
+   {
+      Affinity::PinCurrentThread(GetCpuForWorker(th));
+
       ip_Workers[th] = CreateWorker(th, true, largestPrimeTested);
+   }
+
+   ip_Affinity->RestoreThreadAffinity();
 
    ib_HaveCreatedWorkers = true;
 
    // We can't start until all workers waiting for work
    while (!allWaiting)
    {
-      Sleep(10);
+      WaitForReadyWorker(100);
       allWaiting = true;
 
       for (th=0; th<=ii_TotalWorkerCount; th++)
@@ -745,12 +1084,41 @@ void  App::Finish(void)
    uint64_t    workerCpuUS;
    uint64_t    processCpuUS;
    uint64_t    elapsedTimeUS;
+   uint64_t    sieveUS = il_TotalSieveUS;
+   uint64_t    dispatchCount = il_TotalDispatchCount;
+   uint64_t    dispatchLatencyUS = il_TotalDispatchLatencyUS;
+   uint64_t    maxDispatchLatencyUS = il_MaxDispatchLatencyUS;
+   kernelstats_t megaStats = ik_MegaChunkStats;
+   kernelstats_t miniStats = ik_MiniChunkStats;
    double      cpuUtilization;
+   char        primeStr[50];
    const char *finishMethod = (IsInterrupted() ? "interrupted" : "completed");
 
+   // Let idle workers help busy workers finish their ranges.
+   DrainWorkers();
+
    // This won't return until all workers have completed processing work assigned to them.
    StopWorkers();
 
+   // Each worker generates its own primes, so include the time they spent doing that.
+   for (uint32_t ii=0; ii<=ii_TotalWorkerCount; ii++)
+   {
+      // ip_Worker[0] is the special CPU worker (if we need one)
+      if (ii == 0 && ip_Workers[0] == NULL)
+         continue;
+
+      sieveUS += ip_Workers[ii]->GetPrimeGenerationUS();
+
+      dispatchCount += ip_Workers[ii]->GetDispatchCount();
+      dispatchLatencyUS += ip_Workers[ii]->GetDispatchLatencyUS();
+
+      if (ip_Workers[ii]->GetMaxDispatchLatencyUS() > maxDispatchLatencyUS)
+         maxDispatchLatencyUS = ip_Workers[ii]->GetMaxDispatchLatencyUS();
+
+      AddKernelStats(megaStats, ip_Workers[ii]->GetMegaChunkStats());
+      AddKernelStats(miniStats, ip_Workers[ii]->GetMiniChunkStats());
+   }
+
    processCpuUS = Clock::GetProcessMicroseconds();
 
    elapsedTimeUS = Clock::GetCurrentMicrosecond() - il_StartSievingUS;
@@ -758,7 +1126,9 @@ void  App::Finish(void)
    GetWorkerStats(workerCpuUS, largestPrimeTestedNoGaps, largestPrimeTested, primesTested);
 
    // Since all threads finished normally, there are no gaps thus we use largestPrimeTested.
-   WriteToConsole(COT_OTHER, "Sieve %s at p=%" PRIu64".", finishMethod, largestPrimeTested);
+   ConvertPrimeToString(largestPrimeTested, primeStr);
+
+   WriteToConsole(COT_OTHER, "Sieve %s at p=%s.", finishMethod, primeStr);
 
    cpuUtilization = ((double) processCpuUS) / ((double) elapsedTimeUS);
 
@@ -769,7 +1139,7 @@ void  App::Finish(void)
    // on this program, thus not including time spent working on other processes
    WriteToConsole(COT_OTHER, "CPU time: %.2f sec. (%.2f sieving) (%.2f cores) GPU time: %.2f sec. ",
             processCpuUS/1000000.0,
-            il_TotalSieveUS/1000000.0,
+            sieveUS/1000000.0,
             cpuUtilization,
             processGpuUS/1000000.0);
 #else
@@ -777,13 +1147,84 @@ void  App::Finish(void)
    // on this program, thus not including time spent working on other processes
    WriteToConsole(COT_OTHER, "CPU time: %.2f sec. (%.2f sieving) (%.2f cores)",
             processCpuUS/1000000.0,
-            il_TotalSieveUS/1000000.0,
+            sieveUS/1000000.0,
             cpuUtilization);
 #endif
 
+   // This is the time from when a worker finished a chunk until it started its next chunk
+   if (dispatchCount > 0)
+      WriteToConsole(COT_OTHER, "Dispatch latency: %.1f us average, %.1f us max over %" PRIu64" chunks",
+               ((double) dispatchLatencyUS) / ((double) dispatchCount),
+               (double) maxDispatchLatencyUS,
+               dispatchCount);
+
+   if (Counters::IsEnabled())
+      WriteCounters(true);
+
    Finish(finishMethod, elapsedTimeUS, largestPrimeTested, primesTested);
 
-   ip_AppStatus->SetValueNoLock(AS_FINISHED);
+   if (IsBenchmarking())
+      WriteBenchResults(elapsedTimeUS, primesTested, megaStats, miniStats);
+
+   SetAppStatus(AS_FINISHED);
+}
+
+void  App::AddKernelStats(kernelstats_t &totalStats, const kernelstats_t &stats)
+{
+   totalStats.calls += stats.calls;
+   totalStats.primes += stats.primes;
+   totalStats.elapsedUS += stats.elapsedUS;
+}
+
+// Write the results of --bench as a single JSON object or as CSV with one row for
+// the entire run followed by one row for each of TestMegaPrimeChunk and TestMiniPrimeChunk.
+// The kernel rows include the primes used to pad each list.
+void  App::WriteBenchResults(uint64_t elapsedTimeUS, uint64_t primesTested, kernelstats_t &megaStats, kernelstats_t &miniStats)
+{
+   char           appName[100];
+   char           appVersion[100];
+   char           kernelRows[3][200];
+   char           results[2000];
+   const char    *kernelNames[3] = { "total", "mega", "mini" };
+   kernelstats_t  totalStats;
+   kernelstats_t *kernelStats[3] = { &totalStats, &megaStats, &miniStats };
+   double         primesPerSecond, nsPerPrime;
+
+   if (sscanf(is_Banner.c_str(), "%99s v%99[^,]", appName, appVersion) != 2)
+      strcpy(appVersion, "unknown");
+
+   // ns per prime is the time a single worker needs to test one prime, while primes per
+   // second for the total row is the rate of all workers.
+   totalStats.calls = megaStats.calls + miniStats.calls;
+   totalStats.primes = primesTested;
+   totalStats.elapsedUS = megaStats.elapsedUS + miniStats.elapsedUS;
+
+   for (uint32_t k=0; k<3; k++)
+   {
+      uint64_t kernelUS = (k == 0 ? elapsedTimeUS : kernelStats[k]->elapsedUS);
+
+      primesPerSecond = (kernelUS == 0 ? 0.0 : ((double) kernelStats[k]->primes * 1000000.0) / (double) kernelUS);
+      nsPerPrime = (kernelStats[k]->primes == 0 ? 0.0 : ((double) kernelStats[k]->elapsedUS * 1000.0) / (double) kernelStats[k]->primes);
+
+      if (ibf_BenchFormat == BF_JSON)
+         sprintf(kernelRows[k], "{\"kernel\": \"%s\", \"calls\": %" PRIu64", \"primes\": %" PRIu64", \"elapsed_us\": %" PRIu64", \"primes_per_sec\": %.1f, \"ns_per_prime\": %.3f}",
+                 kernelNames[k], kernelStats[k]->calls, kernelStats[k]->primes, kernelUS, primesPerSecond, nsPerPrime);
+      else
+         sprintf(kernelRows[k], "%s,%s,%s,%u,%u,%u,%" PRIu64",%" PRIu64",%s,%" PRIu64",%" PRIu64",%" PRIu64",%.1f,%.3f",
+                 appName, appVersion, FRAMEWORK_VERSION, ii_CpuWorkerCount, ii_GpuWorkerCount, ii_CpuWorkSize, il_MinPrime, il_MaxPrime,
+                 kernelNames[k], kernelStats[k]->calls, kernelStats[k]->primes, kernelUS, primesPerSecond, nsPerPrime);
+   }
+
+   if (ibf_BenchFormat == BF_JSON)
+      sprintf(results, "{\"app\": \"%s\", \"version\": \"%s\", \"framework\": \"%s\", \"workers\": %u, \"gpu_workers\": %u, \"worksize\": %u, "
+              "\"min_prime\": %" PRIu64", \"max_prime\": %" PRIu64", \"kernels\": [%s, %s, %s]}",
+              appName, appVersion, FRAMEWORK_VERSION, ii_CpuWorkerCount, ii_GpuWorkerCount, ii_CpuWorkSize, il_MinPrime, il_MaxPrime,
+              kernelRows[0], kernelRows[1], kernelRows[2]);
+   else
+      sprintf(results, "app,version,framework,workers,gpu_workers,worksize,min_prime,max_prime,kernel,calls,primes,elapsed_us,primes_per_sec,ns_per_prime\n%s\n%s\n%s",
+              kernelRows[0], kernelRows[1], kernelRows[2]);
+
+   WriteToConsole(COT_OTHER, "%s", results);
 }
 
 void  App::ReportStatus(void)
@@ -793,8 +1234,10 @@ void  App::ReportStatus(void)
    double   cpuUtilization;
    struct tm   *finish_tm;
    char     primeStats[200];
+   char     nodeStats[1000];
    char     childStats[200];
    char     finishTimeBuffer[32];
+   char     primeStr[50];
    uint64_t workerCpuUS;
    uint64_t processCpuUS, elapsedTimeUS;
    uint64_t largestPrimeTestedNoGaps, largestPrimeTested, primesTested;
@@ -820,6 +1263,7 @@ void  App::ReportStatus(void)
 
    GetPrimeStats(primeStats, primesTested);
    GetReportStats(childStats, cpuUtilization);
+   GetNodeStats(nodeStats);
 
    // Compute the percentage of the range we have completed
    if (largestPrimeTestedNoGaps == 0)
@@ -849,24 +1293,151 @@ void  App::ReportStatus(void)
          finishTimeBuffer[0] = '\0';
    }
 
+   ConvertPrimeToString(largestPrimeTestedNoGaps, primeStr);
+
    if (strlen(childStats) > 0)
    {
       if (!havePercentDone)
-         WriteToConsole(COT_SIEVE, "  p=%" PRIu64", %s, %s                            ",
-                        largestPrimeTestedNoGaps, primeStats, childStats);
+         WriteToConsole(COT_SIEVE, "  p=%s, %s%s, %s                            ",
+                        primeStr, primeStats, nodeStats, childStats);
       else
-         WriteToConsole(COT_SIEVE, "  p=%" PRIu64", %s, %s, %.1f%% done. %s           ",
-                        largestPrimeTestedNoGaps, primeStats, childStats, 100.0*percentDone, finishTimeBuffer);
+         WriteToConsole(COT_SIEVE, "  p=%s, %s%s, %s, %.1f%% done. %s           ",
+                        primeStr, primeStats, nodeStats, childStats, 100.0*percentDone, finishTimeBuffer);
    }
    else
    {
       if (!havePercentDone)
-         WriteToConsole(COT_SIEVE, "  p=%" PRIu64", %s                                ",
-                        largestPrimeTestedNoGaps, primeStats);
+         WriteToConsole(COT_SIEVE, "  p=%s, %s%s                                ",
+                        primeStr, primeStats, nodeStats);
+      else
+         WriteToConsole(COT_SIEVE, "  p=%s, %s%s, %.1f%% done. %s               ",
+                        primeStr, primeStats, nodeStats, 100.0*percentDone, finishTimeBuffer);
+   }
+
+   if (Counters::IsEnabled())
+      WriteCounters(false);
+}
+
+// Get the counters of all workers, including those that have been deleted
+void  App::GetCounterValues(uint64_t *values)
+{
+   for (uint32_t id=0; id<MAX_COUNTERS; id++)
+      values[id] = il_CounterTotals[id];
+
+   for (uint32_t th=0; th<=ii_TotalWorkerCount; th++)
+   {
+      // ip_Worker[0] is the special CPU worker (if we need one)
+      if (th == 0 && ip_Workers[0] == NULL)
+         continue;
+
+      Counters::AddSlot(values, ip_Workers[th]->GetCounters());
+   }
+}
+
+// Status reports put all counters on one line.  When sieving is done each counter
+// is on its own line.  Counters that are still 0 are not output.
+void  App::WriteCounters(bool isFinal)
+{
+   uint64_t values[MAX_COUNTERS];
+   char     counters[2000];
+   char     value[100];
+   uint32_t length = 0;
+
+   GetCounterValues(values);
+
+   counters[0] = 0;
+
+   for (uint32_t id=0; id<Counters::GetCount(); id++)
+   {
+      const counterinfo_t &info = Counters::GetInfo(id);
+
+      if (values[id] == 0)
+         continue;
+
+      if (info.type == CT_TIMER)
+         sprintf(value, "%.3f sec", ((double) values[id]) / 1000000000.0);
+      else
+         sprintf(value, "%" PRIu64"", values[id]);
+
+      if (isFinal)
+         length += sprintf(counters + length, "\n   %-24s %s", info.name, value);
       else
-         WriteToConsole(COT_SIEVE, "  p=%" PRIu64", %s, %.1f%% done. %s               ",
-                        largestPrimeTestedNoGaps, primeStats, 100.0*percentDone, finishTimeBuffer);
+         length += sprintf(counters + length, "%s%s=%s", (length > 0 ? ", " : ""), info.name, value);
    }
+
+   if (length == 0)
+      return;
+
+   WriteToConsole(COT_OTHER, "Counters:%s%s", (isFinal ? "" : " "), counters);
+}
+
+// If workers are pinned to CPUs on more than one NUMA node, then this will give the
+// rate for each node since the last report, such as " [node 0: 1.2M, node 1: 1.1M]".
+void  App::GetNodeStats(char *nodeStats)
+{
+   uint64_t primesTested[MAX_NUMA_NODES];
+   bool     hasWorkers[MAX_NUMA_NODES];
+   uint64_t reportUS = Clock::GetCurrentMicrosecond();
+   uint64_t primesOverTime;
+   uint32_t node;
+   double   primeRate;
+   const char  *primeRateUnit;
+
+   nodeStats[0] = 0;
+
+   if (!ip_Affinity->IsEnabled() || ip_Affinity->GetNodeCount() < 2)
+      return;
+
+   for (node=0; node<MAX_NUMA_NODES; node++)
+   {
+      primesTested[node] = 0;
+      hasWorkers[node] = false;
+   }
+
+   for (uint32_t th=0; th<=ii_TotalWorkerCount; th++)
+   {
+      // ip_Worker[0] is the special CPU worker (if we need one)
+      if (th == 0 && ip_Workers[0] == NULL)
+         continue;
+
+      if (ip_Workers[th]->GetCpu() == NO_CPU)
+         continue;
+
+      node = ip_Workers[th]->GetNode();
+
+      primesTested[node] += ip_Workers[th]->GetPrimesTested();
+      hasWorkers[node] = true;
+   }
+
+   for (node=0; node<MAX_NUMA_NODES; node++)
+   {
+      if (!hasWorkers[node])
+         continue;
+
+      // The workers are recreated after a rebuild, which resets their counts
+      if (primesTested[node] >= il_NodePrimesTested[node])
+         primesOverTime = primesTested[node] - il_NodePrimesTested[node];
+      else
+         primesOverTime = primesTested[node];
+
+      il_NodePrimesTested[node] = primesTested[node];
+
+      if (il_LastNodeReportUS == 0 || reportUS <= il_LastNodeReportUS)
+         continue;
+
+      primeRate = (double) primesOverTime / (double) (reportUS - il_LastNodeReportUS);
+
+      primeRateUnit = "M";
+      if (primeRate < 1.0) primeRate *= 1000.0, primeRateUnit = "K";
+      if (primeRate < 1.0) primeRate *= 1000.0, primeRateUnit = "";
+
+      sprintf(nodeStats + strlen(nodeStats), "%snode %u: %.1f%s", (nodeStats[0] ? ", " : " ["), node, primeRate, primeRateUnit);
+   }
+
+   if (nodeStats[0])
+      strcat(nodeStats, "]");
+
+   il_LastNodeReportUS = reportUS;
 }
 
 void  App::GetPrimeStats(char *primeStats, uint64_t primesTested)
@@ -929,6 +1500,7 @@ void  App::GetPrimeStats(char *primeStats, uint64_t primesTested)
 void  App::GetWorkerStats(uint64_t &workerCpuUS, uint64_t &largestPrimeTestedNoGaps, uint64_t &largestPrimeTested, uint64_t &primesTested)
 {
    uint64_t workerLargestPrimeTested;
+   uint64_t workerLargestPrimeTestedNoGaps;
 
    workerCpuUS = 0;
    primesTested = 0;
@@ -946,37 +1518,37 @@ void  App::GetWorkerStats(uint64_t &workerCpuUS, uint64_t &largestPrimeTestedNoG
       if (ii == 0)
          continue;
 
-      ip_Workers[ii]->LockStats();
-
       workerLargestPrimeTested = ip_Workers[ii]->GetLargestPrimeTested();
 
-      // Ignore worker if it hasn't done any work.
-      if (workerLargestPrimeTested > 0)
+      // If this worker has a range of primes, then every prime below the start of that
+      // range has been given to a worker and the primes in the range are tested in order.
+      // If this worker is waiting for work, then assume that at least one worker will be
+      // working on the next range, so use its stats instead.
+      if (ip_Workers[ii]->IsStatusHasWorkToDo() || ip_Workers[ii]->IsStatusWorking())
       {
-         // If this worker is waiting for work, then aasume that at least one worker
-         // will be working on the next chunk, so use its stats instead.
-         if (!ip_Workers[ii]->IsStatusWaitingForWork())
-         {
-            // If there are multiple workers, this will be the largest prime tested
-            // where we know that all primes less than this prime have been tested.
-            if (workerLargestPrimeTested < largestPrimeTestedNoGaps)
-               largestPrimeTestedNoGaps = workerLargestPrimeTested;
-         }
-
-         if (workerLargestPrimeTested > largestPrimeTested)
-            largestPrimeTested = workerLargestPrimeTested;
+         workerLargestPrimeTestedNoGaps = ip_Workers[ii]->GetRangeStart() - 1;
+
+         // A worker that took part of the range of another worker could have previously
+         // tested primes larger than its current range, so ignore the largest prime it
+         // tested unless that prime is in its current range.
+         if (workerLargestPrimeTested > workerLargestPrimeTestedNoGaps && workerLargestPrimeTested < ip_Workers[ii]->GetRangeEnd())
+            workerLargestPrimeTestedNoGaps = workerLargestPrimeTested;
+
+         // If there are multiple workers, this will be the largest prime tested
+         // where we know that all primes less than this prime have been tested.
+         if (workerLargestPrimeTestedNoGaps < largestPrimeTestedNoGaps)
+            largestPrimeTestedNoGaps = workerLargestPrimeTestedNoGaps;
       }
 
+      if (workerLargestPrimeTested > largestPrimeTested)
+         largestPrimeTested = workerLargestPrimeTested;
+
       primesTested += ip_Workers[ii]->GetPrimesTested();
       workerCpuUS += ip_Workers[ii]->GetWorkerCpuUS();
-
-      ip_Workers[ii]->ReleaseStats();
    }
 
    if (ip_Workers[0] != NULL)
    {
-      ip_Workers[0]->LockStats();
-
       if (largestPrimeTested == 0)
       {
          largestPrimeTestedNoGaps = ip_Workers[0]->GetLargestPrimeTested();
@@ -985,8 +1557,6 @@ void  App::GetWorkerStats(uint64_t &workerCpuUS, uint64_t &largestPrimeTestedNoG
 
       primesTested += ip_Workers[0]->GetPrimesTested();
       workerCpuUS += ip_Workers[0]->GetWorkerCpuUS();
-
-      ip_Workers[0]->ReleaseStats();
    }
 
    if (largestPrimeTestedNoGaps == PMAX_MAX_62BIT)
@@ -1007,8 +1577,6 @@ uint64_t  App::GetLargestPrimeTested(bool finishedNormally)
       if (ii == 0)
          continue;
 
-      ip_Workers[ii]->LockStats();
-
       workerLargestPrimeTested = ip_Workers[ii]->GetLargestPrimeTested();
 
       // Ignore worker if it didn't do any work.
@@ -1029,21 +1597,13 @@ uint64_t  App::GetLargestPrimeTested(bool finishedNormally)
                largestPrimeTested = workerLargestPrimeTested;
          }
       }
-
-      ip_Workers[ii]->ReleaseStats();
    }
 
 
    // If only the special worker has done work, then we will get the larger prime from it.
    if (largestPrimeTested == 0 && ip_Workers[0] != NULL)
-   {
-      ip_Workers[0]->LockStats();
-
       largestPrimeTested = ip_Workers[0]->GetLargestPrimeTested();
 
-      ip_Workers[0]->ReleaseStats();
-   }
-
    return largestPrimeTested;
 }
 
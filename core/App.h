@@ -16,6 +16,7 @@
 #define PMIN_MIN              1
 #define PMAX_MAX_52BIT        (1ULL<<52)
 #define PMAX_MAX_62BIT        (1ULL<<62)
+#define PMAX_MAX_WIDE         (__uint128_t(1)<<127)
 
 #ifndef MIN
 #define MIN(a,b) ((a) < (b) ? (a) : (b))
@@ -23,6 +24,7 @@
 #endif
 
 #include <stdio.h>
+#include <atomic>
 #include "main.h"
 #include "Parser.h"
 
@@ -32,10 +34,19 @@
 
 #define MAX_PRIME_REPORT_COUNT   60
 
+// Unless -p or -P are given, --bench tests the primes in this range
+#define BENCH_MIN_PRIME          1000000000ULL
+#define BENCH_PRIME_RANGE        100000000ULL
+
+// The kernels for Worker::PowModBlock().  This is needed by Worker.h.
+typedef enum { PK_AUTO, PK_FPU, PK_MONT, PK_AVX512 } powmodkernel_t;
+
 class App;
 
 #include "Worker.h"
 #include "SharedMemoryItem.h"
+#include "Affinity.h"
+#include "Counters.h"
 
 #include "../sieve/primesieve.hpp"
 
@@ -43,6 +54,7 @@ class App;
 typedef enum { COT_OTHER = 1, COT_SIEVE } cotype_t;
 typedef enum { AS_INITIALIZING, AS_RUNNING, AS_INTERRUPTED, AS_FINISHED } appstatus_t;
 typedef enum { SS_NOT_STARTED, SS_SIEVING, SS_DONE } sievingstatus_t;
+typedef enum { BF_NONE, BF_JSON, BF_CSV } benchformat_t;
 
 // Although declared here, this must be implemented by a child class of App
 App *get_app(void);
@@ -69,9 +81,13 @@ public:
    uint32_t          GetTotalWorkers(void) { return ii_TotalWorkerCount; };
    uint64_t          GetMaxPrimeForSingleWorker(void) { return il_MaxPrimeForSingleWorker; };
 
-   void              SetRebuildNeeded(void) { ip_NeedToRebuild->SetValueNoLock(1); };
+   void              SetRebuildNeeded(void) { ib_NeedToRebuild.store(true, std::memory_order_release); };
 
    uint32_t          GetCpuWorkerCount(void) { return ii_CpuWorkerCount; };
+
+   // Returns NO_CPU if workers are not pinned to a logical CPU
+   int32_t           GetCpuForWorker(uint32_t id) { return ip_Affinity->GetCpuForWorker(id); };
+   uint32_t          GetNodeForCpu(int32_t cpu) { return ip_Affinity->GetNodeForCpu(cpu); };
    uint32_t          GetGpuWorkerCount(void) { return ii_GpuWorkerCount; };
 
 #if defined(USE_OPENCL) || defined(USE_METAL)
@@ -87,15 +103,35 @@ public:
    uint64_t          GetMinPrime(void) { return il_MinPrime; };
    uint64_t          GetMaxPrime(void) { return il_MaxPrime; };
 
+   // When the app allows primes of 2^62 or more (see AllowWidePrimes()), the primes in
+   // the range are p = base + q where q is what the workers test and what the App reports.
+   __uint128_t       GetPrimeBase(void) { return il_PrimeBase; };
+
    void              ConvertNumberToShortString(uint64_t value, char *buffer);
+   void              ConvertPrimeToString(uint64_t value, char *buffer);
+   static void       ConvertWideNumberToString(__uint128_t value, char *buffer);
+
+   bool              IsSievingDone(void) { return (iss_SievingStatus.load(std::memory_order_acquire) == SS_DONE); };
+   bool              IsInterrupted(void) { return (ias_AppStatus.load(std::memory_order_acquire) == AS_INTERRUPTED); };
+   bool              IsRunning(void) { return (ias_AppStatus.load(std::memory_order_acquire) == AS_RUNNING); };
+
+   // When benchmarking, factors are not logged and the output terms file is not written
+   bool              IsBenchmarking(void) { return (ibf_BenchFormat != BF_NONE); };
 
-   bool              IsSievingDone(void) { return (((sievingstatus_t) ip_SievingStatus->GetValueNoLock()) == SS_DONE); };
-   bool              IsInterrupted(void) { return (((appstatus_t) ip_AppStatus->GetValueNoLock()) == AS_INTERRUPTED); };
-   bool              IsRunning(void) { return (((appstatus_t) ip_AppStatus->GetValueNoLock()) == AS_RUNNING); };
+   // The number of primes per group given with -j or chosen by the first worker to finish
+   // calibrating, 0 if neither has happened yet
+   uint32_t          GetLanes(void) { return ii_Lanes.load(std::memory_order_acquire); };
+   void              SetLanes(uint32_t lanes) { ii_Lanes.store(lanes, std::memory_order_release); };
+
+   // The kernel given with -E for workers that use Worker::PowModBlock()
+   powmodkernel_t    GetPowModKernel(void) { return ipk_PowModKernel; };
 
    void              StopWorkers(void);
    void              Interrupt(void);
 
+   // Workers call this when they are waiting for work or have stopped
+   void              NotifyWorkerReady(void);
+
    void              Run(void);
 
 #ifdef __MINGW_PRINTF_FORMAT
@@ -108,6 +144,9 @@ public:
 
    void              TellAllWorkersToRebuild(void);
 
+   // Each worker thread calls this when it starts, see QueuedFactorApp
+   virtual void      BindFactorQueue(uint32_t workerId) = 0;
+
 protected:
    virtual void      ResetFactorStats(void) = 0;
 
@@ -126,15 +165,20 @@ protected:
    void              SetAppMinPrime(uint64_t minPrime) { il_MinPrime = il_AppMinPrime = minPrime; };
    void              SetAppMaxPrime(uint64_t maxPrime) { il_MaxPrime = il_AppMaxPrime = maxPrime; };
    void              SetMinPrime(uint64_t minPrime);
+   void              SetWideMinPrime(__uint128_t minPrime);
    void              SetMaxPrime(uint64_t maxPrime, const char *why);
    void              SetMinGpuPrime(uint64_t minGpuPrime) { il_MinGpuPrime = minGpuPrime; };
 
+   // Let -p and -P be as large as PMAX_MAX_WIDE.  The workers of the app must handle a
+   // prime base that is not 0.
+   void              AllowWidePrimes(void) { ib_AllowWidePrimes = true; };
+
    void              ParentHelp(void);
    void              ParentAddCommandLineOptions(std::string &shortOpts, struct option *longOpts);
    parse_t           ParentParseOption(int opt, char *arg, const char *source);
    void              ParentValidateOptions(void);
 
-   bool              IsRebuildNeeded(void) { return (ip_NeedToRebuild->GetValueNoLock() > 0); };
+   bool              IsRebuildNeeded(void) { return ib_NeedToRebuild.load(std::memory_order_acquire); };
 
    void              GetWorkerStats(uint64_t &workerCpuUS, uint64_t &largestPrimeTestedNoGaps, uint64_t &largestPrimeTested, uint64_t &primesTested);
    uint64_t          GetLargestPrimeTested(bool finishedNormally);
@@ -152,6 +196,13 @@ protected:
 
    uint64_t          il_LargestPrimeSieved;
 
+   // If -p is at least il_AppMaxPrime, then il_PrimeBase is one less than -p and
+   // il_MinPrime and il_MaxPrime are relative to it.  Otherwise il_PrimeBase is 0.
+   bool              ib_AllowWidePrimes;
+   __uint128_t       il_PrimeBase;
+   __uint128_t       il_WideMinPrime;
+   __uint128_t       il_WideMaxPrime;
+
    // This represents the largest prime that must be tested by a single worker.  There is one
    // restriction, it must be a CPU worker.
    uint64_t          il_MaxPrimeForSingleWorker;
@@ -171,8 +222,6 @@ protected:
    cotype_t          icot_LastConsoleOutputType;
 
 private:
-   primesieve::iterator  ip_PrimeIterator;
-
    void              DeleteWorkers(void);
    void              CreateWorkers(uint64_t largestPrimeTested);
 
@@ -180,15 +229,32 @@ private:
    void              ReportStatus(void);
    uint32_t          GetNextAvailableWorker(bool useSingleThread, uint64_t &largestPrimeSieved);
    uint64_t          GetPrimesForWorker(uint32_t th);
-   void              SetRebuildCompleted(void) { ip_NeedToRebuild->SetValueNoLock(0); };
+   bool              StealPrimesForWorker(uint32_t th);
+   void              DrainWorkers(void);
+   void              WaitForReadyWorker(uint32_t timeoutMS);
+   void              WakeWorkers(void);
+   void              SetRebuildCompleted(void) { ib_NeedToRebuild.store(false, std::memory_order_release); };
+   void              SetAppStatus(appstatus_t appStatus) { ias_AppStatus.store(appStatus, std::memory_order_release); };
+   void              SetSievingStatus(sievingstatus_t sievingStatus) { iss_SievingStatus.store(sievingStatus, std::memory_order_release); };
 
    void              CheckReportStatus(void);
 
    void              Finish(void);
    void              GetPrimeStats(char *primeStats, uint64_t primesTested);
+   void              GetNodeStats(char *nodeStats);
+
+   void              GetCounterValues(uint64_t *values);
+   void              WriteCounters(bool isFinal);
+
+   void              SetBenchRange(void);
+   void              AddKernelStats(kernelstats_t &totalStats, const kernelstats_t &stats);
+   void              WriteBenchResults(uint64_t elapsedTimeUS, uint64_t primesTested, kernelstats_t &megaStats, kernelstats_t &miniStats);
 
 #ifdef USE_X86
    uint32_t          ii_SavedSseMode;
+#endif
+
+#ifdef USE_X87
    uint16_t          ii_SavedFpuMode;
 #endif
 
@@ -197,13 +263,29 @@ private:
 #endif
 
    SharedMemoryItem *ip_Console;
-   SharedMemoryItem *ip_AppStatus;
-   SharedMemoryItem *ip_SievingStatus;
-   SharedMemoryItem *ip_NeedToRebuild;
+
+   // These are read by every worker, so they are atomic rather than behind a mutex
+   std::atomic<appstatus_t>     ias_AppStatus;
+   std::atomic<sievingstatus_t> iss_SievingStatus;
+   std::atomic<bool>            ib_NeedToRebuild;
+
+   // The value is the number of times a worker became ready since the App last checked
+   SharedMemoryItem *ip_WorkerReady;
 
    Worker          **ip_Workers;
 
+   Affinity         *ip_Affinity;
+
+   // These are used to compute the rate for each NUMA node since the last report
+   uint64_t          il_NodePrimesTested[MAX_NUMA_NODES];
+   uint64_t          il_LastNodeReportUS;
+
    bool              ib_SetMinPrimeFromCommandLine;
+   bool              ib_SetMaxPrimeFromCommandLine;
+
+   benchformat_t     ibf_BenchFormat;
+   std::atomic<uint32_t> ii_Lanes;
+   powmodkernel_t    ipk_PowModKernel;
 
    uint32_t          ii_CpuWorkerCount;
    uint32_t          ii_GpuWorkerCount;
@@ -224,6 +306,16 @@ private:
    uint32_t          ii_LastStatusEntry;
 
    uint64_t          il_TotalSieveUS;
+   uint64_t          il_TotalDispatchCount;
+   uint64_t          il_TotalDispatchLatencyUS;
+   uint64_t          il_MaxDispatchLatencyUS;
+
+   // Time spent in the kernels of workers that have been deleted
+   kernelstats_t     ik_MegaChunkStats;
+   kernelstats_t     ik_MiniChunkStats;
+
+   // The counters of workers that have been deleted, see Counters.h
+   uint64_t          il_CounterTotals[MAX_COUNTERS];
 
    time_t            it_ReportTime;
 };
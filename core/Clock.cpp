@@ -48,6 +48,26 @@ uint64_t  Clock::GetCurrentMicrosecond(void)
 #endif
 }
 
+/* Time elapsed since some fixed base time, but with a much finer resolution. */
+uint64_t  Clock::GetCurrentNanosecond(void)
+{
+#ifdef _WIN32
+   static LARGE_INTEGER frequency = { 0 };
+   LARGE_INTEGER counter;
+
+   if (frequency.QuadPart == 0)
+      QueryPerformanceFrequency(&frequency);
+
+   QueryPerformanceCounter(&counter);
+
+   return (uint64_t) ((double) counter.QuadPart * (1000000000.0 / (double) frequency.QuadPart));
+#else
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (uint64_t) t.tv_sec*1000000000 + t.tv_nsec;
+#endif
+}
+
 /* Time consumed by the current thread. */
 uint64_t  Clock::GetThreadMicroseconds(void)
 {
@@ -18,6 +18,9 @@ public:
    ~Clock(void);
 
    static uint64_t       GetCurrentMicrosecond(void);
+
+   // This is a monotonic clock for timing short sections of code
+   static uint64_t       GetCurrentNanosecond(void);
    static uint64_t       GetThreadMicroseconds(void);
    static uint64_t       GetProcessMicroseconds(void);
 };
@@ -0,0 +1,45 @@
+/* Counters.cpp -- (C) Mark Rodenkirch, October 2026
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#include "Counters.h"
+
+// These are zero initialized before any static initializer calls Register()
+bool           Counters::ib_Enabled;
+uint32_t       Counters::ii_CounterCount;
+counterinfo_t  Counters::ir_Counters[MAX_COUNTERS];
+
+thread_local counterslot_t *Counters::tp_Slot = NULL;
+
+uint32_t  Counters::Register(const char *name, countertype_t type)
+{
+   if (ii_CounterCount == MAX_COUNTERS)
+      FatalError("Too many counters.  The limit is %u", MAX_COUNTERS);
+
+   ir_Counters[ii_CounterCount].name = name;
+   ir_Counters[ii_CounterCount].type = type;
+
+   return ii_CounterCount++;
+}
+
+void  Counters::ClearSlot(counterslot_t *slot)
+{
+   for (uint32_t id=0; id<MAX_COUNTERS; id++)
+      slot->value[id].store(0, std::memory_order_relaxed);
+}
+
+void  Counters::BindThread(counterslot_t *slot)
+{
+   if (ib_Enabled)
+      tp_Slot = slot;
+}
+
+void  Counters::AddSlot(uint64_t *values, counterslot_t *slot)
+{
+   for (uint32_t id=0; id<ii_CounterCount; id++)
+      values[id] += slot->value[id].load(std::memory_order_relaxed);
+}
@@ -0,0 +1,101 @@
+/* Counters.h -- (C) Mark Rodenkirch, October 2026
+
+   This is a registry of counters and timers that workers can update in their
+   hot paths.  Each worker has its own slot so no locks are needed.  Only the
+   worker thread writes to its slot, while the main thread reads the slots of
+   all workers when it reports status.
+
+   Counters are registered by static initializers, such as:
+
+      uint32_t SomeWorker::ii_BabyStepCounter = Counters::Register("baby steps", CT_COUNT);
+
+   then updated with Counters::Add() or with Counters::StartTimer() and
+   Counters::StopTimer().  Nothing is counted unless -u is used.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifndef _COUNTERS_H
+#define _COUNTERS_H
+
+#include <atomic>
+#include "main.h"
+#include "Clock.h"
+
+#define MAX_COUNTERS    32
+#define NO_COUNTER      UINT32_MAX
+
+typedef enum { CT_COUNT, CT_TIMER } countertype_t;
+
+typedef struct {
+   const char       *name;
+   countertype_t     type;
+} counterinfo_t;
+
+// Timers are in nanoseconds
+typedef struct {
+   std::atomic<uint64_t> value[MAX_COUNTERS];
+} counterslot_t;
+
+class Counters
+{
+public:
+   // This must only be called before main() is executed
+   static uint32_t   Register(const char *name, countertype_t type);
+
+   static void       Enable(void) { ib_Enabled = true; };
+   static bool       IsEnabled(void) { return ib_Enabled; };
+
+   static uint32_t   GetCount(void) { return ii_CounterCount; };
+   static const counterinfo_t &GetInfo(uint32_t id) { return ir_Counters[id]; };
+
+   static void       ClearSlot(counterslot_t *slot);
+
+   // The counters updated by the calling thread will go to this slot.  This does
+   // nothing unless counting is enabled.
+   static void       BindThread(counterslot_t *slot);
+
+   // Add the values of the slot to values, which must have MAX_COUNTERS entries
+   static void       AddSlot(uint64_t *values, counterslot_t *slot);
+
+   // Use this to skip work that is only needed for counting
+   static inline bool IsCounting(void) { return (tp_Slot != NULL); };
+
+   // Only the thread bound to the slot updates it, so there is no need for an
+   // atomic read-modify-write.
+   static inline void Add(uint32_t id, uint64_t value)
+   {
+      counterslot_t *slot = tp_Slot;
+
+      if (slot == NULL)
+         return;
+
+      slot->value[id].store(slot->value[id].load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+   };
+
+   // This returns 0 without reading the clock if this thread is not counting
+   static inline uint64_t StartTimer(void)
+   {
+      return (tp_Slot == NULL ? 0 : Clock::GetCurrentNanosecond());
+   };
+
+   static inline void StopTimer(uint32_t id, uint64_t startNS)
+   {
+      if (tp_Slot == NULL)
+         return;
+
+      Add(id, Clock::GetCurrentNanosecond() - startNS);
+   };
+
+private:
+   static bool       ib_Enabled;
+   static uint32_t   ii_CounterCount;
+   static counterinfo_t ir_Counters[MAX_COUNTERS];
+
+   static thread_local counterslot_t *tp_Slot;
+};
+
+#endif
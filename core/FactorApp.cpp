@@ -12,13 +12,17 @@
 #include <time.h>
 #include <stdarg.h>
 #include "Clock.h"
+#include "Counters.h"
 #include "FactorApp.h"
 
 #define CHECKPOINT_SECONDS    3600
 
+uint32_t FactorApp::ii_LockWaitCounter = Counters::Register("factor lock wait", CT_TIMER);
+
 FactorApp::FactorApp(void)
 {
    ip_FactorAppLock = new SharedMemoryItem("factorapp");
+   ip_FactorAppLock->SetWaitCounter(ii_LockWaitCounter);
 
    is_InputTermsFileName = "";
    is_InputFactorsFileName = "";
@@ -30,6 +34,7 @@ FactorApp::FactorApp(void)
    il_PreviousFactorCount = 0;
    il_TermCount = 0;
    if_FactorFile = 0;
+   ib_BufferFactorFile = false;
 
    ib_ApplyAndExit = false;
 
@@ -112,10 +117,11 @@ void  FactorApp::ParentValidateOptions(void)
 {
    char     buffer[1000];
    char    *pos;
+   char     primeStr[50];
    uint32_t factors = 0, applied = 0;
-   uint64_t thePrime;
+   __uint128_t thePrime;
 
-   if (is_OutputTermsFileName.length() == 0)
+   if (is_OutputTermsFileName.length() == 0 && !IsBenchmarking())
    {
       FatalError("An output terms file name must be specified");
 
@@ -141,7 +147,8 @@ void  FactorApp::ParentValidateOptions(void)
          if (!StripCRLF(buffer))
             continue;
 
-         if (sscanf(buffer, "%" SCNu64"", &thePrime) != 1)
+         // The prime can be too large for sscanf() if the app calls AllowWidePrimes()
+         if (sscanf(buffer, " %49[0-9]", primeStr) != 1 || Parser::Parse(primeStr, 1, PMAX_MAX_WIDE-1, thePrime) != P_SUCCESS)
             FatalError("Could not parse prime from string %s", buffer);
 
          // All factors are of the form "p | term"
@@ -153,7 +160,12 @@ void  FactorApp::ParentValidateOptions(void)
          *pos = 0;
 
          factors++;
-         if (ApplyFactor(thePrime, pos + 2))
+         if (thePrime > UINT64_MAX || (ib_AllowWidePrimes && thePrime >= il_AppMaxPrime))
+         {
+            if (ApplyWideFactor(thePrime, pos + 2))
+               applied++;
+         }
+         else if (ApplyFactor((uint64_t) thePrime, pos + 2))
             applied++;
       }
 
@@ -173,7 +185,8 @@ void  FactorApp::ParentValidateOptions(void)
       exit(0);
    }
 
-   if (is_OutputFactorsFileName.length() > 0)
+   // When benchmarking LogFactor() will do nothing since the factor file is not opened
+   if (is_OutputFactorsFileName.length() > 0 && !IsBenchmarking())
    {
       if_FactorFile = fopen(is_OutputFactorsFileName.c_str(), "a");
 
@@ -182,6 +195,41 @@ void  FactorApp::ParentValidateOptions(void)
    }
 }
 
+// This is only called for apps that call AllowWidePrimes() and they must override it
+bool  FactorApp::ApplyWideFactor(__uint128_t theFactor, const char *term)
+{
+   char  factorStr[50];
+
+   ConvertWideNumberToString(theFactor, factorStr);
+
+   FatalError("Factor %s for %s is too large", factorStr, term);
+
+   return false;
+}
+
+// Only a QueuedFactorApp has factor queues
+void  FactorApp::BindFactorQueue(uint32_t workerId)
+{
+}
+
+void  FactorApp::FlushFactorQueues(void)
+{
+}
+
+void  FactorApp::BufferFactorFile(void)
+{
+   ib_BufferFactorFile = true;
+
+   if (if_FactorFile)
+      setvbuf(if_FactorFile, NULL, _IOFBF, 1 << 20);
+}
+
+void  FactorApp::FlushFactorFile(void)
+{
+   if (if_FactorFile)
+      fflush(if_FactorFile);
+}
+
 void  FactorApp::ResetFactorStats(void)
 {
    ir_ReportStatus[0].reportTimeUS = Clock::GetCurrentMicrosecond();
@@ -213,9 +261,9 @@ bool  FactorApp::StripCRLF(char *line)
 
 void  FactorApp::LogStartSievingMessage(void)
 {
-   char  minPrime[30];
-   char  maxPrime[30];
-   char  startOfMessage[100];
+   char  minPrime[50];
+   char  maxPrime[50];
+   char  startOfMessage[200];
    char  endOfMessage[100];
    char  extraText[200];
    char  fullMessage[500];
@@ -223,8 +271,16 @@ void  FactorApp::LogStartSievingMessage(void)
    *extraText = 0;
    *endOfMessage = 0;
 
-   ConvertNumberToShortString(il_MinPrime, (char *) minPrime);
-   ConvertNumberToShortString(il_MaxPrime, (char *) maxPrime);
+   if (il_PrimeBase == 0)
+   {
+      ConvertNumberToShortString(il_MinPrime, (char *) minPrime);
+      ConvertNumberToShortString(il_MaxPrime, (char *) maxPrime);
+   }
+   else
+   {
+      ConvertPrimeToString(il_MinPrime, (char *) minPrime);
+      ConvertPrimeToString(il_MaxPrime, (char *) maxPrime);
+   }
 
    sprintf(startOfMessage, "Sieve started: %s < p < %s with %" PRIu64" terms", minPrime, maxPrime, il_TermCount);
 
@@ -232,8 +288,8 @@ void  FactorApp::LogStartSievingMessage(void)
 
    if (il_MaxPrime != il_AppMaxPrime)
    {
-      uint64_t minPrime = ((il_MinPrime == 1) ? 2 : il_MinPrime);
-      double expectedFactors = ((double) il_TermCount) * (1.0 - log(minPrime) / log(il_MaxPrime));
+      double minPrime = (double) (il_PrimeBase + ((il_MinPrime == 1 && il_PrimeBase == 0) ? 2 : il_MinPrime));
+      double expectedFactors = ((double) il_TermCount) * (1.0 - log(minPrime) / log((double) (il_PrimeBase + il_MaxPrime)));
 
       sprintf(endOfMessage, "expecting %.f factors", expectedFactors);
    }
@@ -257,9 +313,15 @@ void  FactorApp::LogStartSievingMessage(void)
 void  FactorApp::Finish(const char *finishMethod, uint64_t elapsedTimeUS, uint64_t largestPrimeTested, uint64_t primesTested)
 {
    double   elapsedSeconds = ((double) elapsedTimeUS) / 1000000.0;
-   uint64_t factorCount = il_FactorCount + il_PreviousFactorCount;
+   uint64_t factorCount;
+   char     largestPrime[50];
+
+   // All workers have stopped, so this applies every factor they found
+   FlushFactorQueues();
+
+   factorCount = il_FactorCount + il_PreviousFactorCount;
 
-   if (IsWritingOutputTermsFile())
+   if (IsWritingOutputTermsFile() && !IsBenchmarking())
    {
       WriteOutputTermsFile(largestPrimeTested);
 
@@ -269,8 +331,10 @@ void  FactorApp::Finish(const char *finishMethod, uint64_t elapsedTimeUS, uint64
    WriteToConsole(COT_OTHER, "Primes tested: %" PRIu64".  Factors found: %" PRIu64".  Remaining terms: %" PRIu64".  Time: %.2f seconds.",
            primesTested, factorCount, il_TermCount, elapsedSeconds);
 
-   WriteToLog("Sieve %s at p=%" PRIu64".  Primes tested %" PRIu64".  Found %" PRIu64" factors.  %" PRIu64" terms remaining.  Time %.2f seconds\n",
-           finishMethod, largestPrimeTested, primesTested, factorCount, il_TermCount, elapsedSeconds);
+   ConvertPrimeToString(largestPrimeTested, largestPrime);
+
+   WriteToLog("Sieve %s at p=%s.  Primes tested %" PRIu64".  Found %" PRIu64" factors.  %" PRIu64" terms remaining.  Time %.2f seconds\n",
+           finishMethod, largestPrime, primesTested, factorCount, il_TermCount, elapsedSeconds);
 }
 
 void  FactorApp::GetReportStats(char *reportStats, double cpuUtilization)
@@ -280,10 +344,14 @@ void  FactorApp::GetReportStats(char *reportStats, double cpuUtilization)
    uint32_t currentStatusEntry;
 
    // Use this as our opportunity to checkpoint current progress
-   if (time(NULL) > it_CheckpointTime)
+   if (time(NULL) > it_CheckpointTime && !IsBenchmarking())
    {
       checkpointPrime = GetLargestPrimeTested(false);
 
+      // Workers queue the factors for a prime before they report it as tested, so this
+      // applies all factors for primes up to checkpointPrime.
+      FlushFactorQueues();
+
       WriteOutputTermsFile(checkpointPrime);
 
       it_CheckpointTime = time(NULL) + CHECKPOINT_SECONDS;
@@ -509,7 +577,34 @@ void  FactorApp::LogFactor(uint64_t p, const char *fmt, ...)
    va_end(args);
 
    fprintf(if_FactorFile, "\n");
-   fflush(if_FactorFile);
+
+   // When using factor queues, the writer flushes after each batch
+   if (!ib_BufferFactorFile)
+      fflush(if_FactorFile);
+}
+
+void  FactorApp::LogWideFactor(__uint128_t p, const char *fmt, ...)
+{
+   char  pStr[50];
+
+   if (if_FactorFile == 0)
+      return;
+
+   ConvertWideNumberToString(p, pStr);
+
+   fprintf(if_FactorFile, "%s | ", pStr);
+
+   va_list args;
+
+   va_start(args, fmt);
+   vfprintf(if_FactorFile, fmt, args);
+   va_end(args);
+
+   fprintf(if_FactorFile, "\n");
+
+   // When using factor queues, the writer flushes after each batch
+   if (!ib_BufferFactorFile)
+      fflush(if_FactorFile);
 }
 
 void  FactorApp::LogFactor(char *factor, const char *fmt, ...)
@@ -526,5 +621,8 @@ void  FactorApp::LogFactor(char *factor, const char *fmt, ...)
    va_end(args);
 
    fprintf(if_FactorFile, "\n");
-   fflush(if_FactorFile);
+
+   // When using factor queues, the writer flushes after each batch
+   if (!ib_BufferFactorFile)
+      fflush(if_FactorFile);
 }
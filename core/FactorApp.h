@@ -13,6 +13,7 @@
 
 #include "App.h"
 #include "SharedMemoryItem.h"
+#include "TermBitmap.h"
 
 // As long as we don't expect the factor rate to fall below 1 per day
 // then this should be sufficient to capture the rate.
@@ -29,11 +30,15 @@ public:
    FactorApp(void);
    ~FactorApp(void);
 
+   // Only a QueuedFactorApp has factor queues, so this does nothing
+   virtual void      BindFactorQueue(uint32_t workerId);
+
 protected:
    virtual void      ProcessInputTermsFile(bool haveBitMap) = 0;
    virtual bool      IsWritingOutputTermsFile(void) = 0;
    virtual void      WriteOutputTermsFile(uint64_t largestPrime) = 0;
    virtual bool      ApplyFactor(uint64_t theFactor, const char *term) = 0;
+   virtual bool      ApplyWideFactor(__uint128_t theFactor, const char *term);
    virtual void      GetExtraTextForSieveStartedMessage(char *extraText) = 0;
 
    void              ParentHelp(void);
@@ -48,13 +53,24 @@ protected:
 
    void              ResetFactorStats(void);
 
+   // Apply all factors queued so far.  Only a QueuedFactorApp has factor queues,
+   // so this does nothing.
+   virtual void      FlushFactorQueues(void);
+
+   // LogFactor() flushes the factor file after each factor unless this is called.
+   // Then the caller must call FlushFactorFile() itself.
+   void              BufferFactorFile(void);
+   void              FlushFactorFile(void);
+
    // Only call this if ip_FactorAppLock has been locked, then release upon return
 #ifdef __MINGW_PRINTF_FORMAT
    void              LogFactor(uint64_t p, const char *fmt, ...) __attribute__ ((format (__MINGW_PRINTF_FORMAT, 3, 4)));
    void              LogFactor(char *factor, const char *fmt, ...) __attribute__ ((format (__MINGW_PRINTF_FORMAT, 3, 4)));
+   void              LogWideFactor(__uint128_t p, const char *fmt, ...) __attribute__ ((format (__MINGW_PRINTF_FORMAT, 3, 4)));
 #else
    void              LogFactor(uint64_t p, const char *fmt, ...) __attribute__ ((format (printf, 3, 4)));
    void              LogFactor(char *factor, const char *fmt, ...) __attribute__ ((format (printf, 3, 4)));
+   void              LogWideFactor(__uint128_t p, const char *fmt, ...) __attribute__ ((format (printf, 3, 4)));
 #endif
 
    bool              ib_ApplyAndExit;
@@ -77,8 +93,12 @@ private:
    bool              BuildSecondsPerFactorRateString(uint32_t currentStatusEntry, double cpuUtilization, char *factoringRate);
 
    FILE             *if_FactorFile;
+   bool              ib_BufferFactorFile;
    time_t            it_CheckpointTime;
 
+   // The time workers wait for ip_FactorAppLock
+   static uint32_t   ii_LockWaitCounter;
+
    // I could use a vector, but I'm lazy
    factor_report_t   ir_ReportStatus[MAX_FACTOR_REPORT_COUNT];
    uint32_t          ii_NextStatusEntry;
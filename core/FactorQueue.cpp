@@ -0,0 +1,24 @@
+/* FactorQueue.cpp -- (C) Mark Rodenkirch, October 2026
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#include "FactorQueue.h"
+
+thread_local FactorQueue *FactorQueue::tp_Queue = NULL;
+
+FactorQueue::FactorQueue(void)
+{
+   ip_Entries = (factorentry_t *) xmalloc(FACTOR_QUEUE_SIZE * sizeof(factorentry_t));
+
+   ii_Head.store(0, std::memory_order_relaxed);
+   ii_Tail.store(0, std::memory_order_relaxed);
+}
+
+FactorQueue::~FactorQueue(void)
+{
+   xfree(ip_Entries);
+}
@@ -0,0 +1,90 @@
+/* FactorQueue.h -- (C) Mark Rodenkirch, October 2026
+
+   This is a lock-free queue of factors found by one worker.  The worker is the only
+   thread that calls Push() and only the thread that holds the factor writer lock of
+   FactorApp calls Pop(), so the head and tail only need acquire/release ordering.
+
+   Each worker thread binds its queue with BindThread() when it starts, then the app
+   uses GetThreadQueue() in ReportFactor() to find it.  A thread with no queue, such
+   as the main thread when reading an input factors file, gets NULL.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifndef _FACTORQUEUE_H
+#define _FACTORQUEUE_H
+
+#include <atomic>
+#include "main.h"
+
+// This must be a power of 2
+#define FACTOR_QUEUE_SIZE     4096
+
+// What termPtr and termIdx refer to is up to the app
+typedef struct {
+   uint64_t          factor;
+   void             *termPtr;
+   uint64_t          termIdx;
+   bool              verifyFactor;
+} factorentry_t;
+
+class FactorQueue
+{
+public:
+   FactorQueue(void);
+
+   ~FactorQueue(void);
+
+   static void       BindThread(FactorQueue *queue) { tp_Queue = queue; };
+   static inline FactorQueue *GetThreadQueue(void) { return tp_Queue; };
+
+   // Returns false if the queue is full
+   inline bool Push(const factorentry_t &entry)
+   {
+      uint32_t tail = ii_Tail.load(std::memory_order_relaxed);
+
+      if (tail - ii_Head.load(std::memory_order_acquire) == FACTOR_QUEUE_SIZE)
+         return false;
+
+      ip_Entries[tail & (FACTOR_QUEUE_SIZE - 1)] = entry;
+
+      ii_Tail.store(tail + 1, std::memory_order_release);
+      return true;
+   };
+
+   // Returns false if the queue is empty
+   inline bool Pop(factorentry_t &entry)
+   {
+      uint32_t head = ii_Head.load(std::memory_order_relaxed);
+
+      if (head == ii_Tail.load(std::memory_order_acquire))
+         return false;
+
+      entry = ip_Entries[head & (FACTOR_QUEUE_SIZE - 1)];
+
+      ii_Head.store(head + 1, std::memory_order_release);
+      return true;
+   };
+
+   // This is only exact when called by the thread that calls Push()
+   inline uint32_t GetSize(void)
+   {
+      return ii_Tail.load(std::memory_order_relaxed) - ii_Head.load(std::memory_order_acquire);
+   };
+
+private:
+   factorentry_t    *ip_Entries;
+
+   // Keep the index written by the writer and the index written by the worker
+   // on different cache lines
+   std::atomic<uint32_t> ii_Head;
+   char              ic_Padding[64];
+   std::atomic<uint32_t> ii_Tail;
+
+   static thread_local FactorQueue *tp_Queue;
+};
+
+#endif
@@ -0,0 +1,59 @@
+/* FastDivisor.h -- (C) Mark Rodenkirch, October 2026
+
+   This computes n % d for a 64-bit n and a 32-bit d that is fixed for the run without
+   a divide instruction.  It uses Lemire's "fastmod" (D. Lemire, O. Kaser, N. Kurz,
+   Faster Remainder by Direct Computation, 2019).  With M = ceil(2^128 / d), the
+   fractional part of n / d is (M * n) mod 2^128 as a 128-bit fixed point number so
+   n % d is that times d shifted right by 128.  Since 128 >= 64 + 32, this is exact for
+   every n < 2^64 and d < 2^32.
+
+   The remainder costs four 64 x 64 bit multiplies, which is much faster than a 64-bit
+   divide on most CPUs, so use this in loops that reduce every prime by the same number.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifndef _FASTDIVISOR_H
+#define _FASTDIVISOR_H
+
+#include <stdint.h>
+
+class FastDivisor
+{
+public:
+   FastDivisor(void) { SetDivisor(1); };
+
+   FastDivisor(uint32_t d) { SetDivisor(d); };
+
+   // d must be greater than 0
+   void     SetDivisor(uint32_t d)
+   {
+      ii_Divisor = d;
+
+      // This is 0 when d = 1, which is correct since n % 1 = 0
+      il_M = ((__uint128_t) 0 - 1) / d + 1;
+   };
+
+   uint32_t GetDivisor(void) { return ii_Divisor; };
+
+   // Returns n % d
+   inline uint32_t Mod(uint64_t n)
+   {
+      __uint128_t lowBits = il_M * n;
+
+      // (lowBits * d) >> 128 split into two 64 x 32 bit multiplies
+      __uint128_t hi = (uint64_t) (lowBits >> 64) * (__uint128_t) ii_Divisor;
+      __uint128_t lo = (uint64_t) lowBits * (__uint128_t) ii_Divisor;
+
+      return (uint32_t) ((hi + (lo >> 64)) >> 64);
+   };
+
+private:
+   __uint128_t il_M;
+   uint32_t    ii_Divisor;
+};
+
+#endif
@@ -10,6 +10,7 @@
 #include <assert.h>
 #include "main.h"
 #include "HashTable.h"
+#include "Counters.h"
 
 #define HASH_MAX_DENSITY      0.60
 #define HASH_MIN_DENSITY      0.10
@@ -17,8 +18,21 @@
 #define HASH_MINIMUM_ELTS     8
 #define L1_CACHE_SIZE         32
 
-HashTable::HashTable(uint32_t elements)
+uint32_t HashTable::ii_EntryCounter = Counters::Register("hash entries", CT_COUNT);
+uint32_t HashTable::ii_ProbeCounter = Counters::Register("hash probes", CT_COUNT);
+
+HashTable::HashTable(uint32_t elements, hashtable_t hashTableType)
 {
+   ip_SwissTable = NULL;
+   htable = olist = NULL;
+   BJ64 = NULL;
+
+   if (hashTableType == HT_SWISS || (hashTableType == HT_AUTO && elements > HASH_MAX_ELTS))
+   {
+      ip_SwissTable = new SwissHashTable(elements);
+      return;
+   }
+
    assert(elements <= HASH_MAX_ELTS);
 
    if (elements < HASH_MINIMUM_ELTS)
@@ -48,8 +62,57 @@ HashTable::HashTable(uint32_t elements)
 
 HashTable::~HashTable(void)
 {
+   if (ip_SwissTable)
+   {
+      delete ip_SwissTable;
+      return;
+   }
+
    xfree(BJ64);
    xfree(olist);
    xfree(htable);
 }
 
+void  HashTable::CountProbes(void)
+{
+   uint64_t entries = 0, probes = 0;
+   uint32_t chainLength;
+   uint16_t elt;
+
+   if (!Counters::IsCounting())
+      return;
+
+   if (ip_SwissTable)
+   {
+      ip_SwissTable->CountProbes(entries, probes);
+
+      Counters::Add(ii_EntryCounter, entries);
+      Counters::Add(ii_ProbeCounter, probes);
+      return;
+   }
+
+   for (uint32_t slot=0; slot<hsize; slot++)
+   {
+      elt = htable[slot];
+
+      if (elt == empty_slot)
+         continue;
+
+      // The n-th entry in the chain for this slot is found with n probes
+      chainLength = 1;
+      probes += chainLength;
+
+      while (elt & HASH_MASK1)
+      {
+         elt = olist[elt & HASH_MASK2];
+
+         chainLength++;
+         probes += chainLength;
+      }
+
+      entries += chainLength;
+   }
+
+   Counters::Add(ii_EntryCounter, entries);
+   Counters::Add(ii_ProbeCounter, probes);
+}
@@ -9,16 +9,22 @@
 #ifndef _HASHTABLE_H
 #define _HASHTABLE_H
 
+#include "SwissHashTable.h"
+
 #define HASH_NOT_FOUND     UINT32_MAX
 #define HASH_MASK1         (1<<15)
 #define HASH_MASK2         (HASH_MASK1-1)
 #define HASH_MAX_ELTS      HASH_MASK2-1
 #define HASH_MINIMUM_SHIFT 10
 
+// HT_CHAINED is limited to HASH_MAX_ELTS entries.  HT_AUTO uses HT_CHAINED unless
+// there are more entries than that, in which case it uses HT_SWISS.
+typedef enum { HT_AUTO = 1, HT_CHAINED, HT_SWISS } hashtable_t;
+
 class HashTable
 {
 public:
-   HashTable(uint32_t elements);
+   HashTable(uint32_t elements, hashtable_t hashTableType = HT_AUTO);
 
    ~HashTable(void);
 
@@ -26,6 +32,12 @@ public:
 
    inline void Clear(void)
    {
+      if (ip_SwissTable)
+      {
+         ip_SwissTable->Clear();
+         return;
+      }
+
       for(uint32_t i=0; i < hsize; i++) {
           htable[i] = empty_slot;
       }
@@ -33,12 +45,26 @@ public:
       BJ64[empty_slot] = UINT64_MAX;
    }
 
-   inline uint64_t get(uint32_t x) {return BJ64[x]; };
+   inline uint64_t get(uint32_t x) {return (ip_SwissTable ? ip_SwissTable->get(x) : BJ64[x]); };
+
+   bool  IsSwissTable(void) { return (ip_SwissTable != NULL); };
+
+   // If this thread is counting (see Counters.h), add the number of entries and the number
+   // of probes needed to find every entry.  The average probe length of a successful Lookup()
+   // is probes/entries.  This is not done in Lookup() as that would slow it down.  For the
+   // Swiss table a probe is a group of control bytes rather than an entry in a chain.
+   void  CountProbes(void);
 
    inline void Insert(uint64_t bj, uint32_t j)
    {
       uint32_t slot;
 
+      if (ip_SwissTable)
+      {
+         ip_SwissTable->Insert(bj, j);
+         return;
+      }
+
       BJ64[j] = bj;
       slot = bj & hsize_minus1;
       if (htable[slot] == empty_slot)
@@ -50,11 +76,24 @@ public:
       }
    };
 
+   // Start loading the group that Lookup(bj) will read first.  When many values are
+   // looked up, calling this for a block of them before the first Lookup() overlaps the
+   // cache misses.  This does nothing for the chained table as it is small enough to
+   // stay in cache.
+   inline void Prefetch(uint64_t bj)
+   {
+      if (ip_SwissTable)
+         ip_SwissTable->Prefetch(bj);
+   };
+
    inline uint32_t Lookup(uint64_t bj)
    {
       uint32_t slot;
       uint16_t elt, elt_low;
 
+      if (ip_SwissTable)
+         return ip_SwissTable->Lookup(bj);
+
       slot = bj & hsize_minus1;
       elt = htable[slot];
       elt_low = elt & HASH_MASK2;
@@ -76,6 +115,12 @@ public:
    };
 
 private:
+   static uint32_t ii_EntryCounter;
+   static uint32_t ii_ProbeCounter;
+
+   // If not NULL, all calls are passed to this table and the fields below are not used
+   SwissHashTable *ip_SwissTable;
+
    /**
     * `hsize` is the size of the hashtable (always a power of two).
     * `hsize_minus1` is a convience constant for MOD hsize.
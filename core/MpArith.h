@@ -12,10 +12,23 @@
 #ifndef _MpArith_H
 #define _MpArith_H
 
+#include "MpPowPlan.h"
+
 //#define DEBUG_MP
 
 typedef uint64_t  MpRes;
 
+// What the MpArith and MpArithVector constructors compute for each prime of a list,
+// stored as a structure of arrays.  The worker computes this once for each prime list
+// so that any number of MpArith or MpArithVector can be built from it without
+// recomputing them.  See Worker::UseMontgomeryContext().
+typedef struct {
+   uint64_t *p;
+   uint64_t *q;         // 1/p mod 2^64
+   MpRes    *one;       // 2^64 mod p
+   MpRes    *r2;        // 2^128 mod p
+} mpcontext_t;
+
 class MpArith
 {
 private:
@@ -55,6 +68,15 @@ private:
 #endif
    }
 
+   // This is used by ComputeContext() before there is an MpArith for p
+   static uint64_t REDC(const __uint128_t t, const uint64_t p, const uint64_t q)
+   {
+      const uint64_t m = uint64_t(t) * q;
+      const int64_t r = int64_t((t >> 64) - uint64_t((m * __uint128_t(p)) >> 64));
+
+      return (r < 0) ? uint64_t(r + p) : uint64_t(r);
+   }
+
 public:
 
 #ifdef DEBUG_MP
@@ -72,6 +94,78 @@ public:
 		_r2exp64 = t;
    }
 
+   MpArith(const mpcontext_t &ctx, size_t idx) : _p(ctx.p[idx]), _q(ctx.q[idx]), _one(ctx.one[idx]), _r2exp64(ctx.r2[idx])
+   {
+   }
+
+   // Compute q, one and r2 for the first count primes of ctx.  This gives the same values
+   // as the constructor, but it uses a fixed number of Newton iterations with no compare
+   // so that the compiler can interleave the primes.
+   static void ComputeContext(const mpcontext_t &ctx, size_t count)
+   {
+      for (size_t i = 0; i < count; ++i)
+      {
+#ifdef DEBUG_MP
+         MpArith mp(ctx.p[i]);
+
+         ctx.q[i] = mp._q;
+         ctx.one[i] = mp._one;
+         ctx.r2[i] = mp._r2exp64;
+#else
+         const uint64_t p = ctx.p[i];
+
+         // (3 * p) ^ 2 is 1/p to 5 bits and each iteration doubles that
+         uint64_t q = (3 * p) ^ 2;
+
+         for (size_t j = 0; j < 4; ++j)
+            q *= 2 - p * q;
+
+         MpRes one, t;
+
+         if (p < (1ULL << 12))
+         {
+            one = (-p) % p;
+
+            // 4 = 2^2, then 4^{2^4} = 2^32 in Montgomery form
+            t = one + one - ((one >= p - one) ? p : 0);
+            t = t + t - ((t >= p - t) ? p : 0);
+
+            for (size_t j = 0; j < 4; ++j)
+               t = REDC(t * __uint128_t(t), p, q);
+         }
+         else
+         {
+            // Both quotients are less than 2^52, so each estimate is within 1 of the
+            // quotient and the remainder is within p of the correct value.  This is
+            // much faster than the division of (-p) % p.
+            const double dp = double(int64_t(p));
+            int64_t r;
+
+            // 2^64 mod p, which is 1 in Montgomery form
+            r = int64_t(0 - uint64_t(int64_t(18446744073709551616.0 / dp)) * p);
+            r += (r < 0) ? p : 0;
+            r -= (r >= int64_t(p)) ? p : 0;
+
+            one = uint64_t(r);
+
+            // 2^96 mod p, which is 2^32 in Montgomery form
+            r = int64_t((one << 32) - uint64_t(int64_t(double(int64_t(one)) * 4294967296.0 / dp)) * p);
+            r += (r < 0) ? p : 0;
+            r -= (r >= int64_t(p)) ? p : 0;
+
+            t = uint64_t(r);
+         }
+
+         // Square 2^32 to get 2^64 in Montgomery form, which is 2^128 mod p
+         t = REDC(t * __uint128_t(t), p, q);
+
+         ctx.q[i] = q;
+         ctx.one[i] = one;
+         ctx.r2[i] = t;
+#endif
+      }
+   }
+
    uint64_t p() const { return _p; }
 
    MpRes one() const { return _one; }
@@ -132,6 +226,40 @@ public:
       return r;
 	}
 
+   // Returns a^exp where exp is the exponent of the plan
+   MpRes pow(MpRes a, const MpPowPlan &plan) const
+   {
+      MpRes table[POWPLAN_MAX_TABLE_SIZE];
+
+      if (plan.exponent() == 0)
+         return _one;
+
+      table[0] = a;
+
+      if (plan.tableSize() > 1)
+      {
+         const MpRes a2 = mul(a, a);
+
+         for (uint32_t t = 1; t < plan.tableSize(); ++t)
+            table[t] = mul(table[t - 1], a2);
+      }
+
+      MpRes y = table[plan.first()];
+
+      for (uint32_t s = 0; s < plan.steps(); ++s)
+      {
+         for (uint32_t q = 0; q < plan.squarings(s); ++q)
+            y = mul(y, y);
+
+         y = mul(y, table[plan.index(s)]);
+      }
+
+      for (uint32_t q = 0; q < plan.finalSquarings(); ++q)
+         y = mul(y, y);
+
+      return y;
+   }
+
    // Compute the residual of n (mod p)
    MpRes nToRes(uint64_t n)
    {
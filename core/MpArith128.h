@@ -0,0 +1,257 @@
+/* MpArith128.h -- (C) Mark Rodenkirch, October 2026
+
+   This is MpArith for primes with more than 64 bits.  It uses Montgomery multiplication
+   with 2^128 in place of 2^64 and __uint128_t in place of uint64_t.  The 256-bit
+   products are built from four 64 x 64 bit products, so this is portable C++ that does
+   not need the routines in x86_asm_ext or GMP.
+
+   p must be odd and less than 2^127 so that a sum of two residues cannot overflow.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifndef _MpArith128_H
+#define _MpArith128_H
+
+#include "MpPowPlan.h"
+
+#define MPARITH128_MAX_PRIME  (__uint128_t(1) << 127)
+
+typedef __uint128_t  MpRes128;
+
+class MpArith128
+{
+private:
+   const __uint128_t _p;
+   const __uint128_t _q;
+   const MpRes128 _one;
+   MpRes128 _r2exp128;
+
+   // hi:lo = a * b
+   static void mul256(const __uint128_t a, const __uint128_t b, __uint128_t &hi, __uint128_t &lo)
+   {
+      const uint64_t a0 = uint64_t(a), a1 = uint64_t(a >> 64);
+      const uint64_t b0 = uint64_t(b), b1 = uint64_t(b >> 64);
+
+      const __uint128_t p00 = a0 * __uint128_t(b0);
+      const __uint128_t p01 = a0 * __uint128_t(b1);
+      const __uint128_t p10 = a1 * __uint128_t(b0);
+      const __uint128_t p11 = a1 * __uint128_t(b1);
+
+      // The middle column can't overflow since each term is less than 2^64
+      const __uint128_t mid = (p00 >> 64) + uint64_t(p01) + uint64_t(p10);
+
+      lo = (mid << 64) | uint64_t(p00);
+      hi = p11 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+   }
+
+   // p * p_inv = 1 (mod 2^128).  (3 * p) ^ 2 is 1/p to 5 bits and each iteration
+   // doubles that.
+   static __uint128_t invert(const __uint128_t p)
+   {
+      __uint128_t p_inv = (3 * p) ^ 2;
+
+      for (uint32_t i = 0; i < 5; ++i)
+         p_inv *= 2 - p * p_inv;
+
+      return p_inv;
+   }
+
+   // Returns hi:lo / 2^128 mod p.  This requires hi < p.
+   MpRes128 REDC(const __uint128_t hi, const __uint128_t lo) const
+   {
+      const __uint128_t m = lo * _q;
+      __uint128_t mpHi, mpLo;
+
+      mul256(m, _p, mpHi, mpLo);
+
+      return (hi < mpHi) ? hi - mpHi + _p : hi - mpHi;
+   }
+
+public:
+   MpArith128(const __uint128_t p) : _p(p), _q(invert(p)), _one((-p) % p)
+   {
+      // 2 in Montgomery form, then 2^{2^7} = 2^128
+      MpRes128 t = add(_one, _one);
+
+      for (uint32_t i = 0; i < 7; ++i)
+         t = mul(t, t);
+
+      _r2exp128 = t;
+   }
+
+   __uint128_t p() const { return _p; }
+
+   MpRes128 one() const { return _one; }
+
+   MpRes128 zero() const { return (MpRes128) 0; }
+
+   MpRes128 add(const MpRes128 a, const MpRes128 b) const
+   {
+      const MpRes128 r = a + b;
+
+      return (r >= _p) ? r - _p : r;
+   }
+
+   MpRes128 sub(const MpRes128 a, const MpRes128 b) const
+   {
+      return (a < b) ? a - b + _p : a - b;
+   }
+
+   MpRes128 mul(const MpRes128 a, const MpRes128 b) const
+   {
+      __uint128_t hi, lo;
+
+      mul256(a, b, hi, lo);
+
+      return REDC(hi, lo);
+   }
+
+   MpRes128 pow(MpRes128 a, __uint128_t exp) const
+   {
+      MpRes128 x = a;
+      MpRes128 y = _one;
+
+      while (true)
+      {
+         if (exp & 1)
+            y = mul(x, y);
+
+         exp >>= 1;
+
+         if (!exp)
+            break;
+
+         x = mul(x, x);
+      }
+
+      return y;
+   }
+
+   // Returns a^exp where exp is the exponent of the plan
+   MpRes128 pow(MpRes128 a, const MpPowPlan &plan) const
+   {
+      MpRes128 table[POWPLAN_MAX_TABLE_SIZE];
+
+      if (plan.exponent() == 0)
+         return _one;
+
+      table[0] = a;
+
+      if (plan.tableSize() > 1)
+      {
+         const MpRes128 a2 = mul(a, a);
+
+         for (uint32_t t = 1; t < plan.tableSize(); ++t)
+            table[t] = mul(table[t - 1], a2);
+      }
+
+      MpRes128 y = table[plan.first()];
+
+      for (uint32_t s = 0; s < plan.steps(); ++s)
+      {
+         for (uint32_t q = 0; q < plan.squarings(s); ++q)
+            y = mul(y, y);
+
+         y = mul(y, table[plan.index(s)]);
+      }
+
+      for (uint32_t q = 0; q < plan.finalSquarings(); ++q)
+         y = mul(y, y);
+
+      return y;
+   }
+
+   // Compute the residual of n (mod p)
+   MpRes128 nToRes(__uint128_t n) const
+   {
+      if (n >= _p)
+         n %= _p;
+
+      return mul(n, _r2exp128);
+   }
+
+   __uint128_t resToN(MpRes128 res) const
+   {
+      return REDC(0, res);
+   }
+
+   // Returns 1/n mod p or 0 if n has no inverse.  This is the binary extended Euclidean
+   // algorithm, which only needs shifts and subtractions.
+   __uint128_t invmod(__uint128_t n) const
+   {
+      __uint128_t u = n % _p, v = _p;
+      __uint128_t x1 = 1, x2 = 0;
+
+      if (u == 0)
+         return 0;
+
+      while (u != 1 && v != 1)
+      {
+         while (!(u & 1))
+         {
+            u >>= 1;
+            x1 = (x1 & 1) ? (x1 + _p) >> 1 : x1 >> 1;
+         }
+
+         while (!(v & 1))
+         {
+            v >>= 1;
+            x2 = (x2 & 1) ? (x2 + _p) >> 1 : x2 >> 1;
+         }
+
+         if (u >= v)
+         {
+            u -= v;
+            x1 = (x1 < x2) ? x1 - x2 + _p : x1 - x2;
+
+            if (u == 0)
+               return 0;
+         }
+         else
+         {
+            v -= u;
+            x2 = (x2 < x1) ? x2 - x1 + _p : x2 - x1;
+         }
+      }
+
+      return (u == 1) ? x1 : x2;
+   }
+
+   // Returns true if p is a strong probable prime to base 2
+   bool isStrongProbablePrime(void) const
+   {
+      __uint128_t d = _p - 1;
+      uint32_t s = 0;
+
+      while (!(d & 1))
+      {
+         d >>= 1;
+         s++;
+      }
+
+      const MpRes128 minusOne = sub(zero(), _one);
+      MpRes128 x = pow(add(_one, _one), d);
+
+      if (x == _one || x == minusOne)
+         return true;
+
+      while (--s > 0)
+      {
+         x = mul(x, x);
+
+         if (x == minusOne)
+            return true;
+
+         if (x == _one)
+            return false;
+      }
+
+      return false;
+   }
+};
+
+#endif
@@ -0,0 +1,385 @@
+/* MpArithFpu.cpp -- (C) Mark Rodenkirch, October 2026
+
+   This is a portable implementation of the routines declared in x86_asm/fpu-asm-x86.h
+   and x86_asm/sse-asm-x86.h.  It uses Montgomery multiplication with __uint128_t
+   instead of the x87 FPU, so it builds on any 64-bit CPU and it does not need to
+   change the FPU control word.  This means that fpu_mod_init() and fpu_mod_fini()
+   do nothing.
+
+   The x87 FPU stack is replaced by a stack for each thread.  fpu_push_1divp() pushes
+   the Montgomery constants for p and fpu_push_adivb() also pushes a in Montgomery
+   form so that fpu_mulmod_iter() needs a single REDC.  As with the x87 routines, the
+   caller must push before calling the routines that use the top of the stack and it
+   must pop what it pushed.
+
+   As with the x87 routines, p < 2^62.  For mulmod at least one of the two values must
+   be less than p.
+
+   Montgomery multiplication needs an odd p, but the x87 routines also work for p = 2,
+   which most sieves test.  Even moduli are computed with __uint128_t division instead.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#include <stdint.h>
+#include "../x86_asm/fpu-asm-x86.h"
+#include "../x86_asm/sse-asm-x86.h"
+
+// The x87 FPU stack has 8 entries
+#define FPU_STACK_SIZE  8
+
+typedef struct {
+   uint64_t p;
+   uint64_t q;          // 1/p mod 2^64
+   uint64_t r2;         // 2^128 mod p
+   uint64_t a;          // a * 2^64 mod p for fpu_push_adivb()
+} fpuentry_t;
+
+static thread_local fpuentry_t  tt_Stack[FPU_STACK_SIZE];
+static thread_local uint32_t    ti_StackTop = 0;
+
+// Returns t / 2^64 mod p.  This requires t < p * 2^64.
+static inline uint64_t REDC(const __uint128_t t, const uint64_t p, const uint64_t q)
+{
+   const uint64_t m = uint64_t(t) * q;
+   const int64_t r = int64_t((t >> 64) - uint64_t((m * __uint128_t(p)) >> 64));
+
+   // This is branchless since r < 0 is not predictable
+   return uint64_t(r) + (p & uint64_t(r >> 63));
+}
+
+// These are only used for even p
+static inline uint64_t DivMulMod(const uint64_t a, const uint64_t b, const uint64_t p)
+{
+   return uint64_t((a * __uint128_t(b)) % p);
+}
+
+static inline uint64_t DivPowMod(uint64_t b, uint64_t n, const uint64_t p)
+{
+   uint64_t y = 1 % p;
+
+   b %= p;
+
+   while (n > 0)
+   {
+      if (n & 1)
+         y = DivMulMod(y, b, p);
+
+      b = DivMulMod(b, b, p);
+      n >>= 1;
+   }
+
+   return y;
+}
+
+// This computes the same values as MpArith::ComputeContext(), but the routines that
+// take 4 primes compute them on every call, so the division of (-p) % p and most of
+// the squarings for 2^128 mod p are replaced by estimating the quotients with doubles.
+// Each step is done for all of the primes before the next step so that the compiler
+// can interleave them.
+template <uint32_t N>
+static inline void ComputeEntries(fpuentry_t *entries, const uint64_t *p)
+{
+   uint64_t q[N], t[N];
+
+   // (3 * p) ^ 2 is 1/p to 5 bits and each iteration doubles that
+   for (uint32_t k=0; k<N; k++)
+      q[k] = (3 * p[k]) ^ 2;
+
+   for (uint32_t j=0; j<4; j++)
+      for (uint32_t k=0; k<N; k++)
+         q[k] *= 2 - p[k] * q[k];
+
+   for (uint32_t k=0; k<N; k++)
+   {
+      if (p[k] < (1ULL << 12))
+      {
+         const uint64_t one = (-p[k]) % p[k];
+
+         // 4 = 2^2, then 4^{2^4} = 2^32 in Montgomery form
+         t[k] = one + one - ((one >= p[k] - one) ? p[k] : 0);
+         t[k] = t[k] + t[k] - ((t[k] >= p[k] - t[k]) ? p[k] : 0);
+
+         for (uint32_t j=0; j<4; j++)
+            t[k] = REDC(t[k] * __uint128_t(t[k]), p[k], q[k]);
+
+         continue;
+      }
+
+      // Both quotients are less than 2^52, so each estimate is within 1 of the quotient
+      // and the remainder is within p of the correct value.
+      const double dp = double(int64_t(p[k]));
+      int64_t r;
+
+      // 2^64 mod p, which is 1 in Montgomery form
+      r = int64_t(0 - uint64_t(int64_t(18446744073709551616.0 / dp)) * p[k]);
+      r += (r < 0) ? p[k] : 0;
+      r -= (r >= int64_t(p[k])) ? p[k] : 0;
+
+      // 2^96 mod p, which is 2^32 in Montgomery form
+      const uint64_t one = uint64_t(r);
+
+      r = int64_t((one << 32) - uint64_t(int64_t(double(int64_t(one)) * 4294967296.0 / dp)) * p[k]);
+      r += (r < 0) ? p[k] : 0;
+      r -= (r >= int64_t(p[k])) ? p[k] : 0;
+
+      t[k] = uint64_t(r);
+   }
+
+   // Square 2^32 to get 2^64 in Montgomery form, which is 2^128 mod p
+   for (uint32_t k=0; k<N; k++)
+      t[k] = REDC(t[k] * __uint128_t(t[k]), p[k], q[k]);
+
+   for (uint32_t k=0; k<N; k++)
+   {
+      entries[k].p = p[k];
+      entries[k].q = q[k];
+      entries[k].r2 = t[k];
+      entries[k].a = 0;
+   }
+}
+
+// Returns a*b mod p.  a*b/2^64 is less than p so one more REDC with 2^128 mod p
+// gives the product without converting a or b to Montgomery form.
+static inline uint64_t MulMod(const uint64_t a, const uint64_t b, const fpuentry_t &entry)
+{
+   if (!(entry.p & 1))
+      return DivMulMod(a, b, entry.p);
+
+   const uint64_t t = REDC(a * __uint128_t(b), entry.p, entry.q);
+
+   return REDC(t * __uint128_t(entry.r2), entry.p, entry.q);
+}
+
+static inline uint64_t PowMod(const uint64_t b, uint64_t n, const fpuentry_t &entry)
+{
+   const uint64_t p = entry.p;
+   const uint64_t q = entry.q;
+
+   if (!(p & 1))
+      return DivPowMod(b, n, p);
+
+   if (n == 0)
+      return 1 % p;
+
+   const uint64_t x = REDC(b * __uint128_t(entry.r2), p, q);
+   uint64_t y = x;
+   uint64_t bit = (1ULL << 63) >> __builtin_clzll(n);
+
+   // Left to right so that every multiply is by the same x
+   while (bit >>= 1)
+   {
+      y = REDC(y * __uint128_t(y), p, q);
+
+      if (n & bit)
+         y = REDC(y * __uint128_t(x), p, q);
+   }
+
+   return REDC(y, p, q);
+}
+
+// The four primes are independent, so the compiler can interleave them
+static inline void PowMod4(uint64_t *b, const uint64_t n, const fpuentry_t *entries)
+{
+   uint64_t x[4], y[4];
+
+   if (!(entries[0].p & entries[1].p & entries[2].p & entries[3].p & 1))
+   {
+      for (uint32_t k=0; k<4; k++)
+         b[k] = PowMod(b[k], n, entries[k]);
+
+      return;
+   }
+
+   if (n == 0)
+   {
+      for (uint32_t k=0; k<4; k++)
+         b[k] = 1 % entries[k].p;
+
+      return;
+   }
+
+   for (uint32_t k=0; k<4; k++)
+      x[k] = y[k] = REDC(b[k] * __uint128_t(entries[k].r2), entries[k].p, entries[k].q);
+
+   uint64_t bit = (1ULL << 63) >> __builtin_clzll(n);
+
+   while (bit >>= 1)
+   {
+      for (uint32_t k=0; k<4; k++)
+         y[k] = REDC(y[k] * __uint128_t(y[k]), entries[k].p, entries[k].q);
+
+      if (n & bit)
+         for (uint32_t k=0; k<4; k++)
+            y[k] = REDC(y[k] * __uint128_t(x[k]), entries[k].p, entries[k].q);
+   }
+
+   for (uint32_t k=0; k<4; k++)
+      b[k] = REDC(y[k], entries[k].p, entries[k].q);
+}
+
+extern "C" {
+
+uint16_t  fpu_mod_init(void)
+{
+   return 0;
+}
+
+void      fpu_mod_fini(uint16_t mode)
+{
+}
+
+void      fpu_push_1divp(uint64_t p)
+{
+   ComputeEntries<1>(&tt_Stack[ti_StackTop & (FPU_STACK_SIZE - 1)], &p);
+
+   ti_StackTop++;
+}
+
+void      fpu_push_adivb(uint64_t a, uint64_t b)
+{
+   fpuentry_t &entry = tt_Stack[ti_StackTop & (FPU_STACK_SIZE - 1)];
+
+   ComputeEntries<1>(&entry, &b);
+
+   if (b & 1)
+      entry.a = REDC(a * __uint128_t(entry.r2), entry.p, entry.q);
+   else
+      entry.a = a % b;
+
+   ti_StackTop++;
+}
+
+void      fpu_pop(void)
+{
+   ti_StackTop--;
+}
+
+uint64_t  fpu_mulmod(uint64_t a, uint64_t b, uint64_t p)
+{
+   return MulMod(a, b, tt_Stack[(ti_StackTop - 1) & (FPU_STACK_SIZE - 1)]);
+}
+
+uint64_t  fpu_mulmod_iter(uint64_t a, uint64_t b, uint64_t p)
+{
+   const fpuentry_t &entry = tt_Stack[(ti_StackTop - 1) & (FPU_STACK_SIZE - 1)];
+
+   if (!(entry.p & 1))
+      return DivMulMod(a, entry.a, entry.p);
+
+   return REDC(a * __uint128_t(entry.a), entry.p, entry.q);
+}
+
+void      fpu_mulmod_iter_4a(uint64_t *a, uint64_t b, uint64_t p)
+{
+   const fpuentry_t &entry = tt_Stack[(ti_StackTop - 1) & (FPU_STACK_SIZE - 1)];
+
+   if (!(entry.p & 1))
+   {
+      for (uint32_t k=0; k<4; k++)
+         a[k] = DivMulMod(a[k], entry.a, entry.p);
+
+      return;
+   }
+
+   for (uint32_t k=0; k<4; k++)
+      a[k] = REDC(a[k] * __uint128_t(entry.a), entry.p, entry.q);
+}
+
+// The caller pushed p[3] first and p[0] last, so p[k] is k entries below the top
+void      fpu_mulmod_4a_4b_4p(uint64_t *a, uint64_t *b, uint64_t *p)
+{
+   const fpuentry_t *stack = tt_Stack;
+   const uint32_t top = ti_StackTop - 1;
+   uint64_t t[4];
+
+   for (uint32_t k=0; k<4; k++)
+   {
+      const fpuentry_t &entry = stack[(top - k) & (FPU_STACK_SIZE - 1)];
+
+      if (!(entry.p & 1))
+      {
+         for (k=0; k<4; k++)
+            a[k] = MulMod(a[k], b[k], stack[(top - k) & (FPU_STACK_SIZE - 1)]);
+
+         return;
+      }
+
+      t[k] = REDC(a[k] * __uint128_t(b[k]), entry.p, entry.q);
+   }
+
+   for (uint32_t k=0; k<4; k++)
+   {
+      const fpuentry_t &entry = stack[(top - k) & (FPU_STACK_SIZE - 1)];
+
+      a[k] = REDC(t[k] * __uint128_t(entry.r2), entry.p, entry.q);
+   }
+}
+
+uint64_t  fpu_powmod(uint64_t b, uint64_t n, uint64_t p)
+{
+   return PowMod(b, n, tt_Stack[(ti_StackTop - 1) & (FPU_STACK_SIZE - 1)]);
+}
+
+void      fpu_powmod_4b_1n_4p(uint64_t *b, uint64_t n, uint64_t *p)
+{
+   fpuentry_t entries[4];
+
+   ComputeEntries<4>(entries, p);
+
+   PowMod4(b, n, entries);
+}
+
+uint16_t  sse_mod_init(void)
+{
+   return 0;
+}
+
+void      sse_mod_fini(uint16_t mode)
+{
+}
+
+uint64_t  sse_mulmod(uint64_t a, uint64_t b, uint64_t p, double *bdivp)
+{
+   fpuentry_t entry;
+
+   ComputeEntries<1>(&entry, &p);
+
+   return MulMod(a, b, entry);
+}
+
+void      sse_mulmod_4a_4b_4p(uint64_t *a, uint64_t *b, uint64_t *p, double *invp)
+{
+   fpuentry_t entries[4];
+
+   ComputeEntries<4>(entries, p);
+
+   for (uint32_t k=0; k<4; k++)
+      a[k] = MulMod(a[k], b[k], entries[k]);
+}
+
+void      sse_powmod_4b_1n_4p(uint64_t *b, uint64_t n, uint64_t *p, double *invp)
+{
+   fpuentry_t entries[4];
+
+   ComputeEntries<4>(entries, p);
+
+   PowMod4(b, n, entries);
+}
+
+void      sse_powmod_4b_1n_4p_mulmod_1k(uint64_t *b, uint64_t n, uint64_t *p, uint64_t mul)
+{
+   fpuentry_t entries[4];
+
+   ComputeEntries<4>(entries, p);
+
+   PowMod4(b, n, entries);
+
+   for (uint32_t k=0; k<4; k++)
+      b[k] = MulMod(b[k], mul, entries[k]);
+}
+
+}
@@ -13,6 +13,7 @@
 #define _MpArithVector_H
 
 #include <cstdlib>
+#include "MpArith.h"
 
 #define		VECTOR_SIZE		4		// must be a power of two
 
@@ -60,6 +61,26 @@ private:
 		return (r < 0) ? uint64_t(r + p) : uint64_t(r);
 	}
 
+	// 1/a (mod p) for 0 < a < p with the extended Euclidean algorithm.  The magnitudes of
+	// the coefficients of a are kept since their signs alternate.
+	static uint64_t invmod(const uint64_t a, const uint64_t p)
+	{
+		uint64_t r0 = p, r1 = a, s0 = 0, s1 = 1;
+		bool positive = true;
+
+		while (r1 > 1)
+		{
+			const uint64_t q = r0 / r1;
+			uint64_t t = r0 - q * r1;
+			r0 = r1; r1 = t;
+			t = s0 + q * s1;
+			s0 = s1; s1 = t;
+			positive = !positive;
+		}
+
+		return positive ? s1 : p - s1;
+	}
+
 public:
 	MpArithVector(const uint64_t * const p)
 	{
@@ -76,6 +97,18 @@ public:
 		_r2 = t;
 	}
 
+	// Build this for the primes of ctx starting at idx, see Worker::UseMontgomeryContext()
+	MpArithVector(const mpcontext_t &ctx, size_t idx)
+	{
+		for (size_t k = 0; k < N; ++k)
+		{
+			_p[k] = ctx.p[idx + k];
+			_q[k] = ctx.q[idx + k];
+			_one[k] = ctx.one[idx + k];
+			_r2[k] = ctx.r2[idx + k];
+		}
+	}
+
 	static MpResVector<N> zero()
 	{
 		MpResVector<N> r;
@@ -157,6 +190,128 @@ public:
       return y;
 	}
 
+	// Returns a[k]^exp[k] for each lane when the exponent is not the same for every lane
+	MpResVector<N> pow(const MpResVector<N> & a, const uint64_t * const exp) const
+	{
+      MpResVector<N> x = a;
+      MpResVector<N> y = _one;
+      uint64_t e[N], bits = 0;
+
+      for (size_t k = 0; k < N; ++k)
+      {
+         e[k] = exp[k];
+         bits |= e[k];
+      }
+
+      while (bits)
+      {
+         const MpResVector<N> xy = mul(x, y);
+
+         bits = 0;
+         for (size_t k = 0; k < N; ++k)
+         {
+            if (e[k] & 1)
+               y[k] = xy[k];
+
+            e[k] >>= 1;
+            bits |= e[k];
+         }
+
+         if (!bits)
+            break;
+
+         x = mul(x, x);
+      }
+
+      return y;
+	}
+
+	// Returns a^exp where exp is the exponent of the plan
+	MpResVector<N> pow(const MpResVector<N> & a, const MpPowPlan & plan) const
+	{
+      MpResVector<N> table[POWPLAN_MAX_TABLE_SIZE];
+
+      if (plan.exponent() == 0)
+         return _one;
+
+      table[0] = a;
+
+      if (plan.tableSize() > 1)
+      {
+         const MpResVector<N> a2 = mul(a, a);
+
+         for (uint32_t t = 1; t < plan.tableSize(); ++t)
+            table[t] = mul(table[t - 1], a2);
+      }
+
+      MpResVector<N> y = table[plan.first()];
+
+      for (uint32_t s = 0; s < plan.steps(); ++s)
+      {
+         for (uint32_t q = 0; q < plan.squarings(s); ++q)
+            y = mul(y, y);
+
+         y = mul(y, table[plan.index(s)]);
+      }
+
+      for (uint32_t q = 0; q < plan.finalSquarings(); ++q)
+         y = mul(y, y);
+
+      return y;
+	}
+
+	// Returns a / 2.  If a is odd then a + p is even and (a + p) / 2 = (a >> 1) + (p >> 1) + 1.
+	MpResVector<N> half(const MpResVector<N> & a) const
+	{
+		MpResVector<N> r;
+		for (size_t k = 0; k < N; ++k)
+		{
+			const uint64_t c = (a[k] & 1) ? (_p[k] >> 1) + 1 : 0;
+			r[k] = (a[k] >> 1) + c;
+		}
+		return r;
+	}
+
+	// Returns 2^exp.  This is left-to-right binary exponentiation, but since the base is 2
+	// the multiply for each set bit is an addition, so only the squarings are mulmods.
+	// That is fewer mulmods than pow() with a plan for the same exponent.
+	MpResVector<N> pow2(const uint64_t exp) const
+	{
+		if (exp == 0)
+			return _one;
+
+		MpResVector<N> y = add(_one, _one);
+
+		for (int32_t bit = 62 - __builtin_clzll(exp); bit >= 0; --bit)
+		{
+			y = mul(y, y);
+
+			if ((exp >> bit) & 1)
+				y = add(y, y);
+		}
+
+		return y;
+	}
+
+	// Returns (1/2)^exp in the same way as pow2() with halving in place of doubling
+	MpResVector<N> powHalf(const uint64_t exp) const
+	{
+		if (exp == 0)
+			return _one;
+
+		MpResVector<N> y = half(_one);
+
+		for (int32_t bit = 62 - __builtin_clzll(exp); bit >= 0; --bit)
+		{
+			y = mul(y, y);
+
+			if ((exp >> bit) & 1)
+				y = half(y);
+		}
+
+		return y;
+	}
+
 	// Convert n to Montgomery representation
 	MpResVector<N> nToRes(const uint64_t *n) const
 	{
@@ -193,6 +348,64 @@ public:
 		return mul(r, _r2);
 	}
 
+	// Returns 1/a, or 0 for each k where a[k] is 0
+	MpResVector<N> inv(const MpResVector<N> & a) const
+	{
+		MpResVector<N> r;
+		for (size_t k = 0; k < N; ++k)
+		{
+			if (a[k] == 0)
+			{
+				r[k] = 0;
+				continue;
+			}
+
+			// a = x * 2^64, so 1/x * 2^64 = (1/a) * 2^64 * 2^64
+			const uint64_t x = invmod(REDC(a[k], _p[k], _q[k]), _p[k]);
+			r[k] = REDC(x * __uint128_t(_r2[k]), _p[k], _q[k]);
+		}
+		return r;
+	}
+
+	// Sets r[i] = 1/a[i] for 0 <= i < count with Montgomery's trick, so there is only one
+	// inversion for each p no matter how large count is.  It costs 3 * (count - 1) mulmods.
+	// Like inv() above, r[i][k] is 0 where a[i][k] is 0.  r must not be the same as a.
+	void inv(const MpResVector<N> * a, MpResVector<N> * r, size_t count) const
+	{
+		MpResVector<N> t;
+
+		if (count == 0)
+			return;
+
+		// r[i] = a[0] * a[1] * ... * a[i] skipping those that are 0
+		for (size_t k = 0; k < N; ++k)
+			r[0][k] = (a[0][k] == 0) ? _one[k] : a[0][k];
+
+		for (size_t i = 1; i < count; ++i)
+			for (size_t k = 0; k < N; ++k)
+				r[i][k] = (a[i][k] == 0) ? r[i-1][k] : REDC(r[i-1][k] * __uint128_t(a[i][k]), _p[k], _q[k]);
+
+		t = inv(r[count-1]);
+
+		// t = 1 / (a[0] * ... * a[i]), so 1/a[i] = t * r[i-1] and then t * a[i] is the
+		// inverse of the product without a[i]
+		for (size_t i = count-1; i > 0; --i)
+			for (size_t k = 0; k < N; ++k)
+			{
+				if (a[i][k] == 0)
+				{
+					r[i][k] = 0;
+					continue;
+				}
+
+				r[i][k] = REDC(t[k] * __uint128_t(r[i-1][k]), _p[k], _q[k]);
+				t[k] = REDC(t[k] * __uint128_t(a[i][k]), _p[k], _q[k]);
+			}
+
+		for (size_t k = 0; k < N; ++k)
+			r[0][k] = (a[0][k] == 0) ? 0 : t[k];
+	}
+
    // Convert Montgomery representation to n
 	MpResVector<N> resToN(const MpResVector<N> & a) const
 	{
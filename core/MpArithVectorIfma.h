@@ -0,0 +1,281 @@
+/* MpArithVectorIfma.h -- (C) Mark Rodenkirch, October 2026
+
+   This is MpArithVector for 8 primes at a time using the AVX-512 IFMA instructions
+   (vpmadd52luq/vpmadd52huq).  It has the same interface as MpArithVector, but the
+   Montgomery form uses 2^52 instead of 2^64 so all primes must be less than 2^52 and
+   all values passed to nToRes() must be less than 2^52.
+
+   The functions are compiled for AVX-512 IFMA regardless of the compiler flags, so a
+   worker must only use this class from functions marked with IFMA_TARGET and only
+   after checking Worker::CpuSupportsAvx512Ifma().
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifndef _MpArithVectorIfma_H
+#define _MpArithVectorIfma_H
+
+#ifdef USE_X86
+
+#include <immintrin.h>
+#include "MpPowPlan.h"
+
+#define IFMA_VECTOR_SIZE   8
+
+#define IFMA_TARGET        __attribute__((target("avx512f,avx512ifma")))
+
+#define IFMA_MASK52        ((1ULL << 52) - 1)
+
+// Montgomery form: if 0 <= a < p then r is 2^52 * a mod p
+class MpResVectorIfma
+{
+public:
+   union {
+      __m512i  v;
+      uint64_t r[IFMA_VECTOR_SIZE];
+   };
+
+   uint64_t operator [](const size_t i) const { return r[i]; }
+   uint64_t & operator [](const size_t i) { return r[i]; }
+};
+
+class MpArithVectorIfma
+{
+private:
+   uint64_t _ps[IFMA_VECTOR_SIZE];
+   __m512i  _p, _q;           // q = -1/p mod 2^52
+   MpResVectorIfma _one;      // 2^52 mod p
+   MpResVectorIfma _r2;       // (2^52)^2 mod p
+
+   // p * p_inv = 1 (mod 2^64) with a fixed number of Newton iterations
+   static uint64_t invert(const uint64_t p)
+   {
+      uint64_t p_inv = (3 * p) ^ 2;
+
+      for (size_t i = 0; i < 4; ++i)
+         p_inv *= 2 - p * p_inv;
+
+      return p_inv;
+   }
+
+   // Returns a * b / 2^52 mod p
+   IFMA_TARGET __m512i REDC(const __m512i a, const __m512i b) const
+   {
+      const __m512i zero = _mm512_setzero_si512();
+      const __m512i lo = _mm512_madd52lo_epu64(zero, a, b);
+      const __m512i hi = _mm512_madd52hi_epu64(zero, a, b);
+      const __m512i m = _mm512_madd52lo_epu64(zero, lo, _q);
+
+      // lo + low52(m * p) is 0 when lo is 0 and 2^52 otherwise
+      __m512i r = _mm512_madd52hi_epu64(hi, m, _p);
+
+      r = _mm512_mask_add_epi64(r, _mm512_cmpneq_epu64_mask(lo, zero), r, _mm512_set1_epi64(1));
+
+      return _mm512_mask_sub_epi64(r, _mm512_cmpge_epu64_mask(r, _p), r, _p);
+   }
+
+public:
+   IFMA_TARGET MpArithVectorIfma(const uint64_t * const p)
+   {
+      uint64_t qs[IFMA_VECTOR_SIZE], ones[IFMA_VECTOR_SIZE];
+
+      for (size_t k = 0; k < IFMA_VECTOR_SIZE; ++k)
+      {
+         _ps[k] = p[k];
+         qs[k] = (0 - invert(p[k])) & IFMA_MASK52;
+         ones[k] = (1ULL << 52) % p[k];
+      }
+
+      _p = _mm512_loadu_si512(_ps);
+      _q = _mm512_loadu_si512(qs);
+      _one.v = _mm512_loadu_si512(ones);
+
+      // Square the Montgomery form of 2 to get that of 2^32, then 2^52 = 2^32 * 2^16 * 2^4
+      MpResVectorIfma t2 = add(_one, _one);
+      MpResVectorIfma t4 = mul(t2, t2);
+      MpResVectorIfma t16 = mul(t4, t4);
+      MpResVectorIfma t256 = mul(t16, t16);
+      MpResVectorIfma t65536 = mul(t256, t256);
+      MpResVectorIfma t32 = mul(t65536, t65536);
+
+      _r2 = mul(mul(t32, t65536), t16);
+   }
+
+   IFMA_TARGET static MpResVectorIfma zero()
+   {
+      MpResVectorIfma r;
+      r.v = _mm512_setzero_si512();
+      return r;
+   }
+
+   IFMA_TARGET MpResVectorIfma one() const { return _one; }	// Montgomery form of 1
+
+   IFMA_TARGET uint64_t p(size_t k) const { return _ps[k]; }
+
+   IFMA_TARGET static bool at_least_one_is_equal(const MpResVectorIfma & a, const MpResVectorIfma & b)
+   {
+      return (_mm512_cmpeq_epu64_mask(a.v, b.v) != 0);
+   }
+
+   IFMA_TARGET MpResVectorIfma add(const MpResVectorIfma & a, const MpResVectorIfma & b) const
+   {
+      MpResVectorIfma r;
+      r.v = _mm512_add_epi64(a.v, b.v);
+      r.v = _mm512_mask_sub_epi64(r.v, _mm512_cmpge_epu64_mask(r.v, _p), r.v, _p);
+      return r;
+   }
+
+   IFMA_TARGET MpResVectorIfma sub(const MpResVectorIfma & a, const MpResVectorIfma & b) const
+   {
+      MpResVectorIfma r;
+      r.v = _mm512_sub_epi64(a.v, b.v);
+      r.v = _mm512_mask_add_epi64(r.v, _mm512_cmplt_epu64_mask(a.v, b.v), r.v, _p);
+      return r;
+   }
+
+   IFMA_TARGET MpResVectorIfma mul(const MpResVectorIfma & a, const MpResVectorIfma & b) const
+   {
+      MpResVectorIfma r;
+      r.v = REDC(a.v, b.v);
+      return r;
+   }
+
+   IFMA_TARGET MpResVectorIfma pow(const MpResVectorIfma & a, size_t exp) const
+   {
+      MpResVectorIfma x = a;
+      MpResVectorIfma y = _one;
+
+      while (true)
+      {
+         if (exp & 1)
+            y = mul(x, y);
+
+         exp >>= 1;
+
+         if (!exp)
+            break;
+
+         x = mul(x, x);
+      }
+
+      return y;
+   }
+
+   // Returns a^exp where exp is the exponent of the plan
+   IFMA_TARGET MpResVectorIfma pow(const MpResVectorIfma & a, const MpPowPlan & plan) const
+   {
+      MpResVectorIfma table[POWPLAN_MAX_TABLE_SIZE];
+
+      if (plan.exponent() == 0)
+         return _one;
+
+      table[0] = a;
+
+      if (plan.tableSize() > 1)
+      {
+         const MpResVectorIfma a2 = mul(a, a);
+
+         for (uint32_t t = 1; t < plan.tableSize(); ++t)
+            table[t] = mul(table[t - 1], a2);
+      }
+
+      MpResVectorIfma y = table[plan.first()];
+
+      for (uint32_t s = 0; s < plan.steps(); ++s)
+      {
+         for (uint32_t q = 0; q < plan.squarings(s); ++q)
+            y = mul(y, y);
+
+         y = mul(y, table[plan.index(s)]);
+      }
+
+      for (uint32_t q = 0; q < plan.finalSquarings(); ++q)
+         y = mul(y, y);
+
+      return y;
+   }
+
+   // Returns a / 2.  If a is odd then a + p is even and (a + p) / 2 = (a >> 1) + (p >> 1) + 1.
+   // The shifts use the masked form with all lanes set and a zero source because GCC warns
+   // that the undefined source of _mm512_srli_epi64() may be used uninitialized.
+   IFMA_TARGET MpResVectorIfma half(const MpResVectorIfma & a) const
+   {
+      const __m512i zero = _mm512_setzero_si512();
+      const __mmask8 odd = _mm512_test_epi64_mask(a.v, _mm512_set1_epi64(1));
+      const __m512i halfP = _mm512_add_epi64(_mm512_mask_srli_epi64(zero, 0xff, _p, 1), _mm512_set1_epi64(1));
+
+      MpResVectorIfma r;
+      r.v = _mm512_mask_srli_epi64(zero, 0xff, a.v, 1);
+      r.v = _mm512_mask_add_epi64(r.v, odd, r.v, halfP);
+      return r;
+   }
+
+   // Returns 2^exp with a squaring per bit and an addition per set bit, see MpArithVector
+   IFMA_TARGET MpResVectorIfma pow2(const uint64_t exp) const
+   {
+      if (exp == 0)
+         return _one;
+
+      MpResVectorIfma y = add(_one, _one);
+
+      for (int32_t bit = 62 - __builtin_clzll(exp); bit >= 0; --bit)
+      {
+         y = mul(y, y);
+
+         if ((exp >> bit) & 1)
+            y = add(y, y);
+      }
+
+      return y;
+   }
+
+   // Returns (1/2)^exp in the same way as pow2() with halving in place of doubling
+   IFMA_TARGET MpResVectorIfma powHalf(const uint64_t exp) const
+   {
+      if (exp == 0)
+         return _one;
+
+      MpResVectorIfma y = half(_one);
+
+      for (int32_t bit = 62 - __builtin_clzll(exp); bit >= 0; --bit)
+      {
+         y = mul(y, y);
+
+         if ((exp >> bit) & 1)
+            y = half(y);
+      }
+
+      return y;
+   }
+
+   // Convert n to Montgomery representation
+   IFMA_TARGET MpResVectorIfma nToRes(const uint64_t *n) const
+   {
+      MpResVectorIfma r;
+      r.v = _mm512_loadu_si512(n);
+      return mul(r, _r2);
+   }
+
+   // Convert n to Montgomery representation
+   IFMA_TARGET MpResVectorIfma nToRes(uint64_t n) const
+   {
+      MpResVectorIfma r;
+      r.v = _mm512_set1_epi64(n);
+      return mul(r, _r2);
+   }
+
+   // Convert Montgomery representation to n
+   IFMA_TARGET MpResVectorIfma resToN(const MpResVectorIfma & a) const
+   {
+      MpResVectorIfma r;
+      r.v = REDC(a.v, _mm512_set1_epi64(1));
+      return r;
+   }
+};
+
+#endif
+
+#endif
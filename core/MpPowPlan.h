@@ -0,0 +1,134 @@
+/* MpPowPlan.h -- (C) Mark Rodenkirch, October 2026
+
+   This is a plan for raising many values to the same exponent with the sliding window
+   method.  The plan is built once for the exponent, then MpArith::pow(),
+   MpArithVector::pow() and MpArithVectorIfma::pow() follow it for each value.  If the
+   exponent is 0 then pow() returns 1.
+
+   For the window size w the odd powers a, a^3, ..., a^(2^w - 1) are computed first.
+   The exponent is then scanned from the top bit down.  Each window of at most w bits
+   that ends with a 1 costs one multiply by one of the odd powers, and each bit costs
+   one squaring.  The constructor chooses the window size with the fewest multiplies,
+   including those for the odd powers, so w = 1 is the left-to-right binary method.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifndef _MpPowPlan_H
+#define _MpPowPlan_H
+
+#include <stdint.h>
+
+#define POWPLAN_MAX_WINDOW_BITS  5
+#define POWPLAN_MAX_TABLE_SIZE   (1 << (POWPLAN_MAX_WINDOW_BITS - 1))
+#define POWPLAN_MAX_STEPS        64
+
+class MpPowPlan
+{
+private:
+   uint64_t _exp;
+   uint32_t _tableSize;                         // number of odd powers
+   uint32_t _first;                             // index of the odd power to start with
+   uint32_t _steps;
+   uint8_t  _squarings[POWPLAN_MAX_STEPS];      // squarings before the multiply of each step
+   uint8_t  _index[POWPLAN_MAX_STEPS];          // index of the odd power for each step
+   uint32_t _finalSquarings;
+   uint32_t _multiplies;
+
+   void build(const uint32_t windowBits)
+   {
+      int32_t i = 63 - __builtin_clzll(_exp);
+      int32_t j;
+      uint32_t squarings = 0;
+
+      _tableSize = 1 << (windowBits - 1);
+      _steps = 0;
+
+      // The first window only selects the odd power to start with
+      j = (i - int32_t(windowBits) + 1 > 0 ? i - int32_t(windowBits) + 1 : 0);
+      while (!((_exp >> j) & 1))
+         j++;
+
+      _first = uint32_t((_exp >> j) & ((2ULL << (i - j)) - 1)) >> 1;
+      i = j - 1;
+
+      while (i >= 0)
+      {
+         if (!((_exp >> i) & 1))
+         {
+            squarings++;
+            i--;
+            continue;
+         }
+
+         j = (i - int32_t(windowBits) + 1 > 0 ? i - int32_t(windowBits) + 1 : 0);
+         while (!((_exp >> j) & 1))
+            j++;
+
+         _squarings[_steps] = squarings + (i - j + 1);
+         _index[_steps] = uint32_t((_exp >> j) & ((2ULL << (i - j)) - 1)) >> 1;
+         _steps++;
+
+         squarings = 0;
+         i = j - 1;
+      }
+
+      _finalSquarings = squarings;
+
+      // Computing the odd powers needs a^2 and one multiply for each after a
+      _multiplies = (_tableSize > 1 ? _tableSize : 0) + _steps + _finalSquarings;
+
+      for (uint32_t s = 0; s < _steps; ++s)
+         _multiplies += _squarings[s];
+   }
+
+public:
+   MpPowPlan(void) : MpPowPlan(0) {}
+
+   MpPowPlan(const uint64_t exp)
+   {
+      _exp = exp;
+      _tableSize = 1;
+      _first = 0;
+      _steps = 0;
+      _finalSquarings = 0;
+      _multiplies = 0;
+
+      if (exp == 0)
+         return;
+
+      uint32_t bestBits = 1;
+      uint32_t bestMultiplies = UINT32_MAX;
+
+      for (uint32_t windowBits = 1; windowBits <= POWPLAN_MAX_WINDOW_BITS; ++windowBits)
+      {
+         build(windowBits);
+
+         if (_multiplies < bestMultiplies)
+         {
+            bestBits = windowBits;
+            bestMultiplies = _multiplies;
+         }
+      }
+
+      build(bestBits);
+   }
+
+   uint64_t exponent(void) const { return _exp; }
+
+   // The number of multiplies and squarings needed for each value
+   uint32_t multiplies(void) const { return _multiplies; }
+
+   // These describe the plan for the pow() of each arithmetic class
+   uint32_t tableSize(void) const { return _tableSize; }
+   uint32_t first(void) const { return _first; }
+   uint32_t steps(void) const { return _steps; }
+   uint32_t squarings(const uint32_t s) const { return _squarings[s]; }
+   uint32_t index(const uint32_t s) const { return _index[s]; }
+   uint32_t finalSquarings(void) const { return _finalSquarings; }
+};
+
+#endif
@@ -183,6 +183,77 @@ parse_t  Parser::Parse(const char *str, uint64_t lo, uint64_t hi, uint64_t &valu
    return P_SUCCESS;
 }
 
+// This only accepts decimal digits with an optional e or b suffix, such as 1e21 or 1b70
+parse_t  Parser::Parse(const char *str, __uint128_t lo, __uint128_t hi, __uint128_t &value)
+{
+   __uint128_t num;
+   uint32_t expt;
+   char *tail;
+
+   if (*str == '-')
+      return P_OUT_OF_RANGE;
+
+   if (*str < '0' || *str > '9')
+      return P_FAILURE;
+
+   num = 0;
+
+   for ( ; *str >= '0' && *str <= '9'; str++)
+   {
+      uint32_t digit = *str - '0';
+
+      if (num > (hi - digit) / 10)
+         return P_OUT_OF_RANGE;
+
+      num = num * 10 + digit;
+   }
+
+   switch (*str)
+   {
+      case 'e':
+      case 'E':
+         errno = 0;
+         expt = strtoul(str+1,&tail,0);
+         if (errno != 0)
+            return P_OUT_OF_RANGE;
+         if (*tail != '\0')
+            return P_FAILURE;
+         while (expt-- > 0)
+            if (num > hi/10)
+               return P_OUT_OF_RANGE;
+            else
+               num *= 10;
+         break;
+
+      case 'b':
+      case 'B':
+         errno = 0;
+         expt = strtoul(str+1,&tail,0);
+         if (errno != 0)
+            return P_OUT_OF_RANGE;
+         if (*tail != '\0')
+            return P_FAILURE;
+         while (expt-- > 0)
+            if (num > (hi>>1))
+               return P_OUT_OF_RANGE;
+            else
+               num <<= 1;
+         break;
+
+      case '\0':
+         break;
+
+      default:
+         return P_FAILURE;
+   }
+
+   if (num < lo)
+      return P_OUT_OF_RANGE;
+
+   value = num;
+   return P_SUCCESS;
+}
+
 parse_t  Parser::Parse(const char *str, double lo, double hi, double &value)
 {
    double num;
@@ -0,0 +1,221 @@
+/* QueuedFactorApp.cpp -- (C) Mark Rodenkirch, October 2026
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#include "Counters.h"
+#include "QueuedFactorApp.h"
+
+// How long the factor writer waits before it looks at the queues again if no worker wakes it
+#define FACTOR_WRITER_WAIT_MS 100
+
+// The most factors passed to ApplyQueuedFactors() at a time
+#define FACTOR_BATCH_SIZE     1024
+
+uint32_t QueuedFactorApp::ii_QueueFullCounter = Counters::Register("factor queue full wait", CT_TIMER);
+
+#ifdef WIN32
+static DWORD WINAPI FactorWriterEntryPoint(LPVOID threadInfo)
+#else
+static void *FactorWriterEntryPoint(void *threadInfo)
+#endif
+{
+   QueuedFactorApp *app = (QueuedFactorApp *) threadInfo;
+
+   app->ProcessFactorQueues();
+
+#ifdef WIN32
+   return 0;
+#else
+   pthread_exit(0);
+#endif
+}
+
+QueuedFactorApp::QueuedFactorApp(void)
+{
+   ip_FactorWriterLock = new SharedMemoryItem("factorwriter", true);
+   ip_FactorQueues = NULL;
+   ii_FactorQueueCount = 0;
+   ip_FactorBatch = NULL;
+   ib_StopFactorWriter = false;
+   ib_FactorWriterStopped = false;
+}
+
+QueuedFactorApp::~QueuedFactorApp(void)
+{
+   if (ip_FactorQueues != NULL)
+   {
+      StopFactorWriter();
+
+      for (uint32_t idx=0; idx<ii_FactorQueueCount; idx++)
+         delete ip_FactorQueues[idx];
+
+      xfree(ip_FactorQueues);
+      xfree(ip_FactorBatch);
+   }
+
+   delete ip_FactorWriterLock;
+}
+
+void  QueuedFactorApp::UseFactorQueues(void)
+{
+   // Worker 0 is the special CPU worker
+   ii_FactorQueueCount = GetTotalWorkers() + 1;
+
+   ip_FactorQueues = (FactorQueue **) xmalloc(ii_FactorQueueCount * sizeof(FactorQueue *));
+
+   for (uint32_t idx=0; idx<ii_FactorQueueCount; idx++)
+      ip_FactorQueues[idx] = new FactorQueue();
+
+   ip_FactorBatch = (factorentry_t *) xmalloc(FACTOR_BATCH_SIZE * sizeof(factorentry_t));
+
+   // Only the factor writer writes to the factor file, so flush it after each
+   // time the queues are drained rather than for each factor.
+   BufferFactorFile();
+
+#ifdef WIN32
+   CreateThread(0, 0, FactorWriterEntryPoint, this, 0, 0);
+#else
+   pthread_t writerThread;
+
+   pthread_create(&writerThread, NULL, &FactorWriterEntryPoint, this);
+   pthread_detach(writerThread);
+#endif
+}
+
+void  QueuedFactorApp::BindFactorQueue(uint32_t workerId)
+{
+   if (ip_FactorQueues == NULL)
+      return;
+
+   if (workerId >= ii_FactorQueueCount)
+      FatalError("There is no factor queue for worker %u", workerId);
+
+   FactorQueue::BindThread(ip_FactorQueues[workerId]);
+}
+
+bool  QueuedFactorApp::QueueFactor(uint64_t theFactor, void *termPtr, uint64_t termIdx, bool verifyFactor)
+{
+   FactorQueue  *queue = FactorQueue::GetThreadQueue();
+   factorentry_t entry;
+   uint64_t      startNS;
+
+   if (queue == NULL)
+      return false;
+
+   entry.factor = theFactor;
+   entry.termPtr = termPtr;
+   entry.termIdx = termIdx;
+   entry.verifyFactor = verifyFactor;
+
+   if (queue->Push(entry))
+   {
+      // Wake the writer once the queue is half full rather than for each factor
+      if (queue->GetSize() >= FACTOR_QUEUE_SIZE / 2)
+         WakeFactorWriter();
+
+      return true;
+   }
+
+   startNS = Counters::StartTimer();
+
+   // The writer is not keeping up, so help it
+   while (!queue->Push(entry))
+   {
+      ip_FactorWriterLock->Lock();
+      DrainFactorQueues();
+      ip_FactorWriterLock->Release();
+   }
+
+   Counters::StopTimer(ii_QueueFullCounter, startNS);
+
+   return true;
+}
+
+void  QueuedFactorApp::FlushFactorQueues(void)
+{
+   if (ip_FactorQueues == NULL)
+      return;
+
+   ip_FactorWriterLock->Lock();
+   DrainFactorQueues();
+
+   // LogFactor() does not flush when using factor queues, so flush here even if the
+   // queues were empty.  This is called before each checkpoint, so no factor found
+   // before the checkpoint can be lost.
+   FlushFactorFile();
+
+   ip_FactorWriterLock->Release();
+}
+
+// This is executed in the factor writer thread
+void  QueuedFactorApp::ProcessFactorQueues(void)
+{
+   ip_FactorWriterLock->Lock();
+
+   while (!ib_StopFactorWriter)
+   {
+      DrainFactorQueues();
+
+      ip_FactorWriterLock->WaitForCondition(FACTOR_WRITER_WAIT_MS);
+   }
+
+   DrainFactorQueues();
+
+   ib_FactorWriterStopped = true;
+   ip_FactorWriterLock->ClearCondition();
+
+   ip_FactorWriterLock->Release();
+}
+
+// The caller must hold ip_FactorWriterLock
+void  QueuedFactorApp::DrainFactorQueues(void)
+{
+   uint32_t count;
+   bool     haveFactors = false;
+
+   for (uint32_t idx=0; idx<ii_FactorQueueCount; idx++)
+   {
+      do
+      {
+         for (count=0; count<FACTOR_BATCH_SIZE; count++)
+            if (!ip_FactorQueues[idx]->Pop(ip_FactorBatch[count]))
+               break;
+
+         if (count > 0)
+         {
+            ApplyQueuedFactors(ip_FactorBatch, count);
+            haveFactors = true;
+         }
+      } while (count == FACTOR_BATCH_SIZE);
+   }
+
+   if (haveFactors)
+      FlushFactorFile();
+}
+
+void  QueuedFactorApp::WakeFactorWriter(void)
+{
+   // If the lock is held, then someone is already draining the queues
+   if (!ip_FactorWriterLock->TryLock())
+      return;
+
+   ip_FactorWriterLock->ClearCondition();
+   ip_FactorWriterLock->Release();
+}
+
+void  QueuedFactorApp::StopFactorWriter(void)
+{
+   ip_FactorWriterLock->Lock();
+
+   ib_StopFactorWriter = true;
+   ip_FactorWriterLock->ClearCondition();
+
+   while (!ib_FactorWriterStopped)
+      ip_FactorWriterLock->WaitForCondition(1000);
+
+   ip_FactorWriterLock->Release();
+}
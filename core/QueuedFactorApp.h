@@ -0,0 +1,64 @@
+/* QueuedFactorApp.h -- (C) Mark Rodenkirch, October 2026
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifndef _QueuedFactorApp_H
+#define _QueuedFactorApp_H
+
+#include "FactorApp.h"
+#include "SharedMemoryItem.h"
+#include "FactorQueue.h"
+
+// Instead of removing terms and logging factors in ReportFactor(), workers put them into
+// a FactorQueue which is drained by a factor writer thread.  Child classes must implement
+// ApplyQueuedFactors().  Only srsieve2 uses this.
+class QueuedFactorApp : public FactorApp
+{
+public:
+   QueuedFactorApp(void);
+   ~QueuedFactorApp(void);
+
+   // Each worker thread calls this when it starts
+   void              BindFactorQueue(uint32_t workerId);
+
+   // This is executed in the factor writer thread
+   void              ProcessFactorQueues(void);
+
+protected:
+   // This is called by the factor writer thread with the next batch of queued factors
+   virtual void      ApplyQueuedFactors(factorentry_t *entries, uint32_t count) = 0;
+
+   // This creates the queues and starts the factor writer.  It must be called after
+   // ParentValidateOptions() since it needs the number of workers.
+   void              UseFactorQueues(void);
+
+   // If the calling thread has a FactorQueue, then put the factor into it and return true.
+   // If the queue is full, then this drains the queues itself.
+   bool              QueueFactor(uint64_t theFactor, void *termPtr, uint64_t termIdx, bool verifyFactor);
+
+   // Apply all factors queued so far.  This must be called before the terms are read
+   // from a thread other than the factor writer thread.
+   void              FlushFactorQueues(void);
+
+private:
+   void              DrainFactorQueues(void);
+   void              WakeFactorWriter(void);
+   void              StopFactorWriter(void);
+
+   // The time workers spend draining the factor queues when their queue is full
+   static uint32_t   ii_QueueFullCounter;
+
+   // ip_FactorWriterLock must be held to call Pop() on any of the queues
+   FactorQueue     **ip_FactorQueues;      // one per worker, NULL until UseFactorQueues()
+   uint32_t          ii_FactorQueueCount;
+   factorentry_t    *ip_FactorBatch;
+   SharedMemoryItem *ip_FactorWriterLock;
+   bool              ib_StopFactorWriter;
+   bool              ib_FactorWriterStopped;
+};
+
+#endif
@@ -14,18 +14,24 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#ifndef WIN32
+#include <sys/time.h>
+#endif
 #include "SharedMemoryItem.h"
+#include "Counters.h"
 
 // Constructor
 SharedMemoryItem::SharedMemoryItem(const char *itemName, bool withCondition)
 {
    il_Value = 0;
+   ii_WaitCounter = NO_COUNTER;
    is_ItemName = itemName;
    ib_HasCondition = withCondition;
 
 #ifdef WIN32
    ih_CriticalSection = &im_CriticalSection;
    ih_Condition = 0;
+   ii_CountWaiting = 0;
 
    InitializeCriticalSection(ih_CriticalSection);
 
@@ -74,6 +80,7 @@ bool     SharedMemoryItem::TryLock(void)
 
 void     SharedMemoryItem::Lock(void)
 {
+   uint64_t startNS = (ii_WaitCounter == NO_COUNTER ? 0 : Counters::StartTimer());
 
 #ifdef WIN32
    EnterCriticalSection(ih_CriticalSection);
@@ -84,6 +91,9 @@ void     SharedMemoryItem::Lock(void)
       exit(0);
    }
 #endif
+
+   if (ii_WaitCounter != NO_COUNTER)
+      Counters::StopTimer(ii_WaitCounter, startNS);
 }
 
 void     SharedMemoryItem::Release(void)
@@ -121,6 +131,37 @@ void     SharedMemoryItem::ClearCondition(void)
 #endif
 }
 
+void     SharedMemoryItem::WaitForCondition(uint32_t timeoutMS)
+{
+#ifdef WIN32
+   ii_CountWaiting++;
+
+   Release();
+   DWORD result = WaitForSingleObject(ih_Condition, timeoutMS);
+   Lock();
+
+   // If we timed out, then nobody released the semaphore for us
+   if (result == WAIT_TIMEOUT && ii_CountWaiting > 0)
+      ii_CountWaiting--;
+#else
+   struct timeval  now;
+   struct timespec timeout;
+
+   gettimeofday(&now, NULL);
+
+   timeout.tv_sec = now.tv_sec + (timeoutMS / 1000);
+   timeout.tv_nsec = (now.tv_usec + (timeoutMS % 1000) * 1000) * 1000;
+
+   if (timeout.tv_nsec >= 1000000000)
+   {
+      timeout.tv_sec++;
+      timeout.tv_nsec -= 1000000000;
+   }
+
+   pthread_cond_timedwait(&ih_Condition, &ih_PthreadMutex, &timeout);
+#endif
+}
+
 int64_t  SharedMemoryItem::GetValueNoLock(void)
 {
    int64_t returnValue;
@@ -35,6 +35,9 @@ public:
 
    void        Release(void);
 
+   // If set, the time worker threads wait in Lock() is added to this timer, see Counters.h
+   void        SetWaitCounter(uint32_t counterId) { ii_WaitCounter = counterId; };
+
    // These assume that the mutex is locked
    int64_t     GetValueHaveLock(void) { return il_Value; };
    void        SetValueHaveLock(int64_t newValue) { il_Value = newValue; };
@@ -50,10 +53,16 @@ public:
    void        SetCondition(void);
    void        ClearCondition(void);
 
+   // This assumes that the mutex is locked.  It waits until another thread calls
+   // ClearCondition() or until timeoutMS has elapsed.  Callers must recheck whatever
+   // they are waiting for when this returns as wakeups can be spurious.
+   void        WaitForCondition(uint32_t timeoutMS);
+
 private:
    std::string is_ItemName;
    bool        ib_HasCondition;
    int64_t     il_Value;
+   uint32_t    ii_WaitCounter;
 
 #ifdef WIN32
    uint32_t    ii_CountWaiting;
@@ -0,0 +1,71 @@
+/* SwissHashTable.cpp -- (C) Mark Rodenkirch, October 2026
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#include <inttypes.h>
+#include <assert.h>
+#include "main.h"
+#include "HashTable.h"
+#include "SwissHashTable.h"
+
+#define SWISS_MAX_DENSITY     0.75
+
+SwissHashTable::SwissHashTable(uint32_t elements)
+{
+   uint32_t slots;
+
+   assert(elements <= SWISS_MAX_ELTS);
+
+   ii_Elements = elements;
+
+   // Keep the same minimum size as the chained table
+   for (slots = 1<<HASH_MINIMUM_SHIFT; slots < elements/SWISS_MAX_DENSITY; )
+      slots *= 2;
+
+   ii_GroupCount = slots / SWISS_GROUP_SIZE;
+   ii_GroupMask = ii_GroupCount - 1;
+
+   // The home group comes from the high bits of the hash
+   ii_GroupShift = 64 - __builtin_ctz(ii_GroupCount);
+
+   ip_Control = (uint8_t *) xmalloc(slots*sizeof(uint8_t));
+   ip_Slots = (uint32_t *) xmalloc(slots*sizeof(uint32_t));
+   il_BJ64 = (uint64_t *) xmalloc(elements*sizeof(uint64_t));
+
+   Clear();
+}
+
+SwissHashTable::~SwissHashTable(void)
+{
+   xfree(il_BJ64);
+   xfree(ip_Slots);
+   xfree(ip_Control);
+}
+
+void  SwissHashTable::CountProbes(uint64_t &entries, uint64_t &probes)
+{
+   uint32_t slot, homeGroup;
+
+   entries = probes = 0;
+
+   for (uint32_t group=0; group<ii_GroupCount; group++)
+   {
+      for (uint32_t idx=0; idx<SWISS_GROUP_SIZE; idx++)
+      {
+         slot = group * SWISS_GROUP_SIZE + idx;
+
+         if (ip_Control[slot] == SWISS_EMPTY)
+            continue;
+
+         homeGroup = HomeGroup(Hash(il_BJ64[ip_Slots[slot]]));
+
+         // Lookup() reads every group from the home group to this one
+         entries++;
+         probes += ((group - homeGroup) & ii_GroupMask) + 1;
+      }
+   }
+}
@@ -0,0 +1,191 @@
+/* SwissHashTable.h -- (C) Mark Rodenkirch, October 2026
+
+   This is an open addressing hash table for the baby steps of BSGS that is not limited
+   to HASH_MAX_ELTS entries like the chained table in HashTable.h.  It follows the layout
+   of Google's "Swiss table".  The slots are split into groups.  Each slot has a control
+   byte that is either SWISS_EMPTY or a 7-bit fingerprint of the value in that slot, so
+   that a Lookup() compares the fingerprint to every control byte of a group at once and
+   only reads BJ64 for the slots that match.  The group width is 16 bytes when SSE2 can be
+   used and 8 bytes otherwise, in which case the bytes are compared within a 64-bit word.
+
+   Each slot holds the 32-bit index j of the baby step, so a table can hold up to 2^30
+   entries.  There are no deletions, so there are no tombstones.  As for HashTable, the
+   values inserted between two calls to Clear() must be distinct.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifndef _SWISSHASHTABLE_H
+#define _SWISSHASHTABLE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef USE_X86
+#include <emmintrin.h>
+#define SWISS_GROUP_SIZE   16
+#else
+#define SWISS_GROUP_SIZE   8
+#endif
+
+#define SWISS_EMPTY        0x80
+#define SWISS_MAX_ELTS     (1 << 30)
+#define SWISS_NOT_FOUND    UINT32_MAX
+
+class SwissHashTable
+{
+public:
+   SwissHashTable(uint32_t elements);
+
+   ~SwissHashTable(void);
+
+   inline void Clear(void)
+   {
+      memset(ip_Control, SWISS_EMPTY, ii_GroupCount * SWISS_GROUP_SIZE);
+   };
+
+   inline uint64_t get(uint32_t x) { return il_BJ64[x]; };
+
+   // Set entries to the number of entries and probes to the number of groups read to
+   // find every entry.  The average number of groups read by a successful Lookup() is
+   // probes/entries.
+   void  CountProbes(uint64_t &entries, uint64_t &probes);
+
+   inline void Insert(uint64_t bj, uint32_t j)
+   {
+      uint64_t hash = Hash(bj);
+      uint32_t group = HomeGroup(hash);
+      uint32_t slot;
+      groupmask_t empty;
+
+      il_BJ64[j] = bj;
+
+      // The table is never full, so this will find an empty slot
+      while (true)
+      {
+         empty = MatchEmpty(ip_Control + group * SWISS_GROUP_SIZE);
+
+         if (empty)
+         {
+            slot = group * SWISS_GROUP_SIZE + FirstIndex(empty);
+
+            ip_Control[slot] = Fingerprint(hash);
+            ip_Slots[slot] = j;
+            return;
+         }
+
+         group = (group + 1) & ii_GroupMask;
+      }
+   };
+
+   // Load the control bytes and slots of the home group of bj
+   inline void Prefetch(uint64_t bj)
+   {
+      uint32_t group = HomeGroup(Hash(bj));
+
+      __builtin_prefetch(ip_Control + group * SWISS_GROUP_SIZE);
+      __builtin_prefetch(ip_Slots + group * SWISS_GROUP_SIZE);
+   };
+
+   inline uint32_t Lookup(uint64_t bj)
+   {
+      uint64_t hash = Hash(bj);
+      uint32_t group = HomeGroup(hash);
+      uint8_t  fingerprint = Fingerprint(hash);
+      uint8_t *control;
+      uint32_t j;
+      groupmask_t match;
+
+      while (true)
+      {
+         control = ip_Control + group * SWISS_GROUP_SIZE;
+         match = MatchFingerprint(control, fingerprint);
+
+         while (match)
+         {
+            j = ip_Slots[group * SWISS_GROUP_SIZE + FirstIndex(match)];
+
+            if (il_BJ64[j] == bj)
+               return j;
+
+            match &= (match - 1);
+         }
+
+         // An empty slot in this group means that bj would have been put in this group
+         if (MatchEmpty(control))
+            return SWISS_NOT_FOUND;
+
+         group = (group + 1) & ii_GroupMask;
+      }
+   };
+
+private:
+#ifdef USE_X86
+   // One bit per control byte
+   typedef uint32_t groupmask_t;
+
+   inline groupmask_t MatchFingerprint(const uint8_t *control, uint8_t fingerprint)
+   {
+      __m128i ctrl = _mm_loadu_si128((const __m128i *) control);
+
+      return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(fingerprint)));
+   };
+
+   // SWISS_EMPTY is the only control byte with the high bit set
+   inline groupmask_t MatchEmpty(const uint8_t *control)
+   {
+      return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) control));
+   };
+
+   inline uint32_t FirstIndex(groupmask_t mask) { return __builtin_ctz(mask); };
+#else
+   // The high bit of each control byte
+   typedef uint64_t groupmask_t;
+
+   // This can also set the bit for a byte that is one more than the fingerprint when
+   // the byte before it matches.  Lookup() checks BJ64 for each match so that is harmless.
+   inline groupmask_t MatchFingerprint(const uint8_t *control, uint8_t fingerprint)
+   {
+      uint64_t ctrl;
+
+      memcpy(&ctrl, control, sizeof(ctrl));
+
+      ctrl ^= 0x0101010101010101ULL * fingerprint;
+
+      return (ctrl - 0x0101010101010101ULL) & ~ctrl & 0x8080808080808080ULL;
+   };
+
+   inline groupmask_t MatchEmpty(const uint8_t *control)
+   {
+      uint64_t ctrl;
+
+      memcpy(&ctrl, control, sizeof(ctrl));
+
+      return ctrl & 0x8080808080808080ULL;
+   };
+
+   inline uint32_t FirstIndex(groupmask_t mask) { return __builtin_ctzll(mask) >> 3; };
+#endif
+
+   // Residues are less than p, so their high bits are often 0.  Mix all bits of
+   // bj into the high bits used for the group and the low bits used for the fingerprint.
+   inline uint64_t Hash(uint64_t bj) { return bj * 0x9E3779B97F4A7C15ULL; };
+
+   inline uint32_t HomeGroup(uint64_t hash) { return (uint32_t) (hash >> ii_GroupShift); };
+
+   inline uint8_t  Fingerprint(uint64_t hash) { return (uint8_t) (hash & 0x7f); };
+
+   uint8_t   *ip_Control;
+   uint32_t  *ip_Slots;
+   uint64_t  *il_BJ64;
+
+   uint32_t   ii_Elements;
+   uint32_t   ii_GroupCount;
+   uint32_t   ii_GroupMask;
+   uint32_t   ii_GroupShift;
+};
+
+#endif
@@ -0,0 +1,155 @@
+/* TermBitmap.cpp -- (C) Mark Rodenkirch, October 2026
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#include "TermBitmap.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define POPCOUNT64(x)   __popcnt64(x)
+
+static inline uint32_t CTZ64(uint64_t x)
+{
+   unsigned long idx;
+
+   _BitScanForward64(&idx, x);
+   return idx;
+}
+#else
+#define POPCOUNT64(x)   __builtin_popcountll(x)
+#define CTZ64(x)        __builtin_ctzll(x)
+#endif
+
+TermBitmap::TermBitmap(void)
+{
+   ip_Words = NULL;
+   il_WordCount = 0;
+   il_BitCount = 0;
+}
+
+TermBitmap::TermBitmap(const TermBitmap &other)
+{
+   ip_Words = NULL;
+   il_WordCount = 0;
+   il_BitCount = 0;
+
+   CopyFrom(other);
+}
+
+TermBitmap::~TermBitmap(void)
+{
+   Free();
+}
+
+TermBitmap &TermBitmap::operator=(const TermBitmap &other)
+{
+   if (this != &other)
+   {
+      Free();
+      CopyFrom(other);
+   }
+
+   return *this;
+}
+
+void  TermBitmap::CopyFrom(const TermBitmap &other)
+{
+   Resize(other.il_BitCount);
+
+   for (uint64_t wordIdx=0; wordIdx<il_WordCount; wordIdx++)
+      ip_Words[wordIdx].store(other.GetWord(wordIdx), std::memory_order_relaxed);
+}
+
+void  TermBitmap::Resize(uint64_t bitCount, bool value)
+{
+   std::atomic<uint64_t> *newWords = NULL;
+   uint64_t newWordCount = (bitCount + TB_WORD_BITS - 1) / TB_WORD_BITS;
+   uint64_t wordIdx;
+
+   if (newWordCount > 0)
+   {
+      newWords = new std::atomic<uint64_t>[newWordCount];
+
+      for (wordIdx=0; wordIdx<newWordCount; wordIdx++)
+         newWords[wordIdx].store((wordIdx < il_WordCount ? GetWord(wordIdx) : 0), std::memory_order_relaxed);
+   }
+
+   if (ip_Words != NULL)
+      delete [] ip_Words;
+
+   uint64_t oldBitCount = il_BitCount;
+
+   ip_Words = newWords;
+   il_WordCount = newWordCount;
+   il_BitCount = bitCount;
+
+   if (bitCount > oldBitCount && value)
+   {
+      for (uint64_t bit=oldBitCount; bit<bitCount && (bit & (TB_WORD_BITS - 1)) != 0; bit++)
+         Set(bit);
+
+      for (wordIdx=TB_WORD(oldBitCount + TB_WORD_BITS - 1); wordIdx<il_WordCount; wordIdx++)
+         ip_Words[wordIdx].store(UINT64_MAX, std::memory_order_relaxed);
+   }
+
+   // Clear the bits past the end so that Count() and FindNextSet() do not see them
+   if (il_BitCount & (TB_WORD_BITS - 1))
+      ip_Words[il_WordCount - 1].store(GetWord(il_WordCount - 1) & (TB_MASK(il_BitCount) - 1), std::memory_order_relaxed);
+}
+
+void  TermBitmap::Free(void)
+{
+   if (ip_Words != NULL)
+      delete [] ip_Words;
+
+   ip_Words = NULL;
+   il_WordCount = 0;
+   il_BitCount = 0;
+}
+
+void  TermBitmap::Fill(bool value)
+{
+   for (uint64_t wordIdx=0; wordIdx<il_WordCount; wordIdx++)
+      ip_Words[wordIdx].store((value ? UINT64_MAX : 0), std::memory_order_relaxed);
+
+   if (value && (il_BitCount & (TB_WORD_BITS - 1)))
+      ip_Words[il_WordCount - 1].store(TB_MASK(il_BitCount) - 1, std::memory_order_relaxed);
+}
+
+uint64_t  TermBitmap::Count(void) const
+{
+   uint64_t count = 0;
+
+   for (uint64_t wordIdx=0; wordIdx<il_WordCount; wordIdx++)
+      count += POPCOUNT64(GetWord(wordIdx));
+
+   return count;
+}
+
+uint64_t  TermBitmap::FindNextSet(uint64_t bit) const
+{
+   uint64_t wordIdx = TB_WORD(bit);
+   uint64_t word;
+
+   if (bit >= il_BitCount)
+      return il_BitCount;
+
+   // Ignore the bits before this one in the first word
+   word = GetWord(wordIdx) & ~(TB_MASK(bit) - 1);
+
+   while (word == 0)
+   {
+      wordIdx++;
+
+      if (wordIdx == il_WordCount)
+         return il_BitCount;
+
+      word = GetWord(wordIdx);
+   }
+
+   return wordIdx * TB_WORD_BITS + CTZ64(word);
+}
@@ -0,0 +1,83 @@
+/* TermBitmap.h -- (C) Mark Rodenkirch, October 2026
+
+   This is a bitmap of the remaining terms of a sieve, one bit per term.  It replaces
+   std::vector<bool> so that the bits are stored in 64-bit words that can be read a
+   word at a time.  Count() uses popcount and FindNextSet() skips words that have no
+   terms, which is what WriteOutputTermsFile() needs.
+
+   Reads use operator[] like std::vector<bool>, but bits are changed with Set() and
+   Clear().  These are not atomic, so the caller must hold ip_FactorAppLock (or be the
+   factor writer thread) if other threads can change bits in the same word.
+
+   Bits past GetSize() in the last word are always 0.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifndef _TERMBITMAP_H
+#define _TERMBITMAP_H
+
+#include <atomic>
+#include "main.h"
+
+#define TB_WORD_BITS    64
+#define TB_WORD(bit)    ((bit) >> 6)
+#define TB_MASK(bit)    (1ULL << ((bit) & 63))
+
+class TermBitmap
+{
+public:
+   TermBitmap(void);
+
+   TermBitmap(const TermBitmap &other);
+
+   ~TermBitmap(void);
+
+   TermBitmap       &operator=(const TermBitmap &other);
+
+   // Change the number of bits.  Bits that are added are set to value.
+   void              Resize(uint64_t bitCount, bool value = false);
+
+   // Release the memory, leaving a bitmap with no bits
+   void              Free(void);
+
+   void              Fill(bool value);
+
+   uint64_t          GetSize(void) const { return il_BitCount; };
+   uint64_t          GetWordCount(void) const { return il_WordCount; };
+
+   inline uint64_t   GetWord(uint64_t wordIdx) const { return ip_Words[wordIdx].load(std::memory_order_relaxed); };
+
+   inline bool       operator[](uint64_t bit) const
+   {
+      return ((GetWord(TB_WORD(bit)) & TB_MASK(bit)) != 0);
+   };
+
+   inline void       Set(uint64_t bit)
+   {
+      ip_Words[TB_WORD(bit)].store(GetWord(TB_WORD(bit)) | TB_MASK(bit), std::memory_order_relaxed);
+   };
+
+   inline void       Clear(uint64_t bit)
+   {
+      ip_Words[TB_WORD(bit)].store(GetWord(TB_WORD(bit)) & ~TB_MASK(bit), std::memory_order_relaxed);
+   };
+
+   // Returns the number of bits that are set
+   uint64_t          Count(void) const;
+
+   // Returns the first bit >= bit that is set or GetSize() if there are none
+   uint64_t          FindNextSet(uint64_t bit) const;
+
+private:
+   std::atomic<uint64_t> *ip_Words;
+   uint64_t          il_WordCount;
+   uint64_t          il_BitCount;
+
+   void              CopyFrom(const TermBitmap &other);
+};
+
+#endif
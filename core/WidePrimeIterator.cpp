@@ -0,0 +1,100 @@
+/* WidePrimeIterator.cpp -- (C) Mark Rodenkirch, October 2026
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#include <stdint.h>
+#include "WidePrimeIterator.h"
+#include "MpArith128.h"
+
+#include "../sieve/primesieve.hpp"
+
+// When the end of the range is near, sieve shorter segments, but not shorter than this
+#define MIN_SEGMENT_SIZE   4096
+
+WidePrimeIterator::WidePrimeIterator(void)
+{
+   il_Base = 0;
+   il_SegmentStart = 0;
+   il_Stop = 0;
+   ii_NextIndex = 0;
+}
+
+void  WidePrimeIterator::jump_to(__uint128_t base, uint64_t start, uint64_t stop)
+{
+   // Only the odd primes are needed since the segments only have odd numbers
+   if (iv_SievingPrimes.size() == 0)
+   {
+      primesieve::generate_primes(3, WIDE_SIEVE_LIMIT, &iv_SievingPrimes);
+
+      iv_NextMultiple.resize(iv_SievingPrimes.size());
+   }
+
+   il_Base = base;
+   il_Stop = stop;
+
+   if (!((base + start) & 1))
+      start++;
+
+   il_SegmentStart = start;
+
+   // The index of base + start + 2*i in the segment is i, so the first odd multiple of q
+   // is at i = -(base + start) / 2 (mod q)
+   for (uint32_t i=0; i<iv_SievingPrimes.size(); i++)
+   {
+      uint64_t q = iv_SievingPrimes[i];
+      uint64_t r = (uint64_t) ((base + start) % q);
+
+      iv_NextMultiple[i] = (uint32_t) ((((q - r) % q) * ((q + 1) >> 1)) % q);
+   }
+
+   iv_Primes.clear();
+   ii_NextIndex = 0;
+}
+
+void  WidePrimeIterator::SieveNextSegment(void)
+{
+   uint32_t segmentSize = WIDE_SEGMENT_SIZE;
+
+   if (il_SegmentStart < il_Stop && (il_Stop - il_SegmentStart) / 2 < WIDE_SEGMENT_SIZE)
+      segmentSize = (uint32_t) ((il_Stop - il_SegmentStart) / 2 + 1);
+
+   if (segmentSize < MIN_SEGMENT_SIZE)
+      segmentSize = MIN_SEGMENT_SIZE;
+
+   iv_Composite.assign(segmentSize, 0);
+
+   uint8_t *composite = iv_Composite.data();
+
+   for (uint32_t i=0; i<iv_SievingPrimes.size(); i++)
+   {
+      uint32_t q = iv_SievingPrimes[i];
+      uint32_t idx = iv_NextMultiple[i];
+
+      for ( ; idx < segmentSize; idx += q)
+         composite[idx] = 1;
+
+      iv_NextMultiple[i] = idx - segmentSize;
+   }
+
+   iv_Primes.clear();
+   ii_NextIndex = 0;
+
+   for (uint32_t idx=0; idx<segmentSize; idx++)
+   {
+      if (composite[idx])
+         continue;
+
+      uint64_t offset = il_SegmentStart + 2 * (uint64_t) idx;
+
+      MpArith128 mp(il_Base + offset);
+
+      if (mp.isStrongProbablePrime())
+         iv_Primes.push_back(offset);
+   }
+
+   il_SegmentStart += 2 * (uint64_t) segmentSize;
+}
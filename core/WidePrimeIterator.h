@@ -0,0 +1,70 @@
+/* WidePrimeIterator.h -- (C) Mark Rodenkirch, October 2026
+
+   This generates the primes above a base that can be larger than 2^64, so it is used
+   in place of primesieve::iterator when App::GetPrimeBase() is not 0.  Like the rest
+   of the framework it works with offsets from the base, which must be less than 2^64,
+   so next_prime() returns p - base.
+
+   The odd numbers above the base are sieved in segments by the primes up to
+   WIDE_SIEVE_LIMIT.  Those that remain are then checked with a base 2 strong probable
+   prime test.  A pseudoprime could get through, but a composite divisor of a term still
+   proves that the term is composite, so that is harmless for a sieve.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifndef _WIDEPRIMEITERATOR_H
+#define _WIDEPRIMEITERATOR_H
+
+#include <stdint.h>
+#include <vector>
+
+// The primes used to sieve each segment
+#define WIDE_SIEVE_LIMIT      (1 << 22)
+
+// The number of odd numbers in each segment
+#define WIDE_SEGMENT_SIZE     (1 << 18)
+
+class WidePrimeIterator
+{
+public:
+   WidePrimeIterator(void);
+
+   ~WidePrimeIterator(void) {};
+
+   // Start with the first prime p with p >= base + start.  The sieving primes must be
+   // less than base + start.  Primes are generated until the iterator is moved again,
+   // so stop is only used to avoid sieving a full segment for a short range.
+   void              jump_to(__uint128_t base, uint64_t start, uint64_t stop);
+
+   uint64_t          next_prime(void)
+   {
+      while (ii_NextIndex >= iv_Primes.size())
+         SieveNextSegment();
+
+      return iv_Primes[ii_NextIndex++];
+   };
+
+private:
+   void              SieveNextSegment(void);
+
+   std::vector<uint32_t> iv_SievingPrimes;
+
+   // For each sieving prime, the index in the next segment of its first odd multiple
+   std::vector<uint32_t> iv_NextMultiple;
+
+   std::vector<uint8_t>  iv_Composite;
+
+   // The offsets of the primes in the last segment that was sieved
+   std::vector<uint64_t> iv_Primes;
+   uint32_t          ii_NextIndex;
+
+   __uint128_t       il_Base;
+   uint64_t          il_SegmentStart;
+   uint64_t          il_Stop;
+};
+
+#endif
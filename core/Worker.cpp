@@ -17,9 +17,9 @@
 
 #include "../sieve/primesieve.hpp"
 
-#ifdef USE_X86
+#include "MpArithVector.h"
+#include "MpArithVectorIfma.h"
 #include "../x86_asm/fpu-asm-x86.h"
-#endif
 
 #ifdef WIN32
    static DWORD WINAPI ThreadEntryPoint(LPVOID threadInfo);
@@ -29,33 +29,84 @@
 
 Worker::Worker(uint32_t myId, App *theApp)
 {
-   char        name1[30], name3[30];
+   char        name[30];
+
+   sprintf(name, "thread_%d_wakeup", myId);
+
+   ip_WorkerWakeup = new SharedMemoryItem(name, true);
+
+   sprintf(name, "thread_%d_range", myId);
+
+   ip_RangeLocker = new SharedMemoryItem(name);
 
-   sprintf(name1, "thread_%d_stats", myId);
-   sprintf(name3, "thread_%d_worker", myId);
+   sprintf(name, "thread_%d_producer", myId);
 
-   ip_StatsLocker = new SharedMemoryItem(name1);
-   ip_WorkerStatus = new SharedMemoryItem(name3);
+   ip_ProducerLocker = new SharedMemoryItem(name, true);
+
+   iws_WorkerStatus = WS_INITIALIZING;
 
    ib_Initialized = false;
 
    ip_App = theApp;
    ii_MyId = myId;
 
+   ii_Cpu = ip_App->GetCpuForWorker(myId);
+   ii_Node = (ii_Cpu == NO_CPU ? 0 : ip_App->GetNodeForCpu(ii_Cpu));
+
    il_PrimesTested = 0;
    il_LargestPrimeTested = 0;
    il_WorkerCpuUS = 0;
+   il_PrimeGenerationUS = 0;
+
+   il_ReadyUS = 0;
+   il_DispatchCount = 0;
+   il_DispatchLatencyUS = 0;
+   il_MaxDispatchLatencyUS = 0;
+
+   ik_MegaChunkStats.calls = ik_MegaChunkStats.primes = ik_MegaChunkStats.elapsedUS = 0;
+   ik_MiniChunkStats.calls = ik_MiniChunkStats.primes = ik_MiniChunkStats.elapsedUS = 0;
+
+   Counters::ClearSlot(&ic_Counters);
 
    ib_GpuWorker = false;
 
    ii_MaxWorkSize = ip_App->GetCpuWorkSize();
+   ii_PrimeListSize = 0;
+   ii_PrimesInList = 0;
+   ii_PaddedPrimesInList = 0;
+   ii_PrimesLeftToCount = 0;
 
    il_PrimeList = NULL;
 
+   il_PrimeBase = ip_App->GetPrimeBase();
+   il_RangeStart = 0;
+   il_RangeEnd = 0;
+   il_ClaimedEnd = 0;
+   il_TaskSize = 0;
+   il_NextPrime = 0;
+   ib_RangeWasSplit = false;
+
+   ib_HasNextRange = false;
+   il_NextRangeStart = 0;
+   il_NextRangeEnd = 0;
+
+   ib_UseProducer = false;
+   ips_ProducerStatus = PS_IDLE;
+   il_NextPrimeList = NULL;
+   ii_NextPrimesInList = 0;
+
    ii_MiniChunkSize = 0;
    il_MinPrimeForMiniChunkMode = PMAX_MAX_62BIT;
    il_MaxPrimeForMiniChunkMode = PMAX_MAX_62BIT;
 
+   ib_UseMontgomeryContext = false;
+   ik_MpContext.p = ik_MpContext.q = ik_MpContext.one = ik_MpContext.r2 = NULL;
+
+   ib_UseLanes = false;
+   ii_LanesForList = DEFAULT_LANES;
+
+   ipk_PowModKernel = PK_FPU;
+
 #ifdef WIN32
    // Ignore the thread handle return since the parent process won't suspend
    // or terminate the thread.
@@ -73,14 +124,21 @@ Worker::Worker(uint32_t myId, App *theApp)
 
 Worker::~Worker()
 {
-   delete ip_StatsLocker;
-   delete ip_WorkerStatus;
+   delete ip_WorkerWakeup;
+   delete ip_RangeLocker;
+   delete ip_ProducerLocker;
 
    // GPU worker memory is freed in the Kernel destructor
    if (!ib_GpuWorker && il_PrimeList != NULL)
       xfree(il_PrimeList);
 
+   if (il_NextPrimeList != NULL)
+      xfree(il_NextPrimeList);
+
    il_PrimeList = NULL;
+   il_NextPrimeList = NULL;
+
+   FreeMontgomeryContext();
 }
 
 #ifdef WIN32
@@ -107,16 +165,289 @@ static void *ThreadEntryPoint(void *threadInfo)
 
 void  Worker::AllocatePrimeList(void)
 {
+#if defined(USE_OPENCL) || defined(USE_METAL)
+   // GPU workers set ii_PrimesInList to the number of primes that the kernel
+   // tests with each execution and the list must always be full.
+   if (ib_GpuWorker)
+   {
+      if (ii_PrimesInList == 0)
+         ii_PrimesInList = ip_App->GetGpuPrimesPerWorker();
+
+      ii_MaxWorkSize = ii_PrimesInList;
+      ii_PrimeListSize = ii_PrimesInList;
+
+      // Generate the next list of primes while the kernel is testing the current list
+      ib_UseProducer = true;
+
+      if (il_NextPrimeList == NULL)
+         il_NextPrimeList = (uint64_t *) xmalloc((ii_PrimeListSize + PRIME_LIST_MULTIPLE + 10) * sizeof(uint64_t));
+   }
+#endif
+
    if (il_PrimeList != NULL)
       return;
 
-#if defined(USE_OPENCL) || defined(USE_METAL)
+   // The work size can grow much larger than we want to hold in memory at one time,
+   // so the range of primes will be tested with multiple passes of the list.
+   if (!ib_GpuWorker)
+      ii_PrimeListSize = MIN(ii_MaxWorkSize, MAX_PRIMES_PER_LIST);
+
+   // Get a little extra space because we want to pad the list and use 0 to end the list.
+   // xmalloc returns 64-byte aligned memory, which TestMiniPrimeSpan() relies on.
+   il_PrimeList = (uint64_t *) xmalloc((ii_PrimeListSize + MAX_MINI_CHUNK_SIZE + 10) * sizeof(uint64_t));
+
+   AllocateMontgomeryContext();
+}
+
+void  Worker::AllocateMontgomeryContext(void)
+{
+   FreeMontgomeryContext();
+
+   if (!ib_UseMontgomeryContext)
+      return;
+
+   ik_MpContext.p = il_PrimeList;
+   ik_MpContext.q = (uint64_t *) xmalloc((ii_PrimeListSize + MAX_MINI_CHUNK_SIZE) * sizeof(uint64_t));
+   ik_MpContext.one = (MpRes *) xmalloc((ii_PrimeListSize + MAX_MINI_CHUNK_SIZE) * sizeof(MpRes));
+   ik_MpContext.r2 = (MpRes *) xmalloc((ii_PrimeListSize + MAX_MINI_CHUNK_SIZE) * sizeof(MpRes));
+}
+
+void  Worker::FreeMontgomeryContext(void)
+{
+   if (ik_MpContext.q != NULL)
+   {
+      xfree(ik_MpContext.q);
+      xfree(ik_MpContext.one);
+      xfree(ik_MpContext.r2);
+   }
+
+   ik_MpContext.p = ik_MpContext.q = ik_MpContext.one = ik_MpContext.r2 = NULL;
+}
+
+// The GPU kernels always test a full list.  Many CPU workers test primes in groups
+// of 4 or 16, so their lists are padded to a multiple of PRIME_LIST_MULTIPLE.
+uint32_t  Worker::GetPaddedPrimeCount(uint32_t primesInList)
+{
    if (ib_GpuWorker)
-      ii_MaxWorkSize = ip_App->GetGpuPrimesPerWorker();
-#endif
+      return ii_PrimeListSize;
+
+   return PRIME_LIST_MULTIPLE * ((primesInList + PRIME_LIST_MULTIPLE - 1) / PRIME_LIST_MULTIPLE);
+}
+
+// Generate the next set of primes in the range assigned to this worker directly into
+// primeList and pad it with copies of the last prime.  primesInList does not include
+// the padding.  This returns false when all primes in the range have been generated.
+bool  Worker::FillPrimeList(uint64_t *primeList, uint32_t &primesInList)
+{
+   uint64_t  generateStartUS = Clock::GetThreadMicroseconds();
+   uint32_t  pIdx = 0;
+   uint32_t  paddedCount;
+
+   while (pIdx < ii_PrimeListSize)
+   {
+      if (il_NextPrime >= il_ClaimedEnd && !ClaimNextTask())
+         break;
+
+      primeList[pIdx] = il_NextPrime;
+      il_NextPrime = (il_PrimeBase == 0 ? ip_PrimeIterator.next_prime() : ip_WidePrimeIterator.next_prime());
+      pIdx++;
+   }
+
+   if (pIdx == 0)
+      return false;
+
+   primesInList = pIdx;
+
+   paddedCount = GetPaddedPrimeCount(primesInList);
+
+   for ( ; pIdx < paddedCount; pIdx++)
+      primeList[pIdx] = primeList[pIdx-1];
+
+   // GPU worker memory is allocated by the Kernel so we cannot write past the end of it.
+   if (!ib_GpuWorker)
+      primeList[pIdx] = 0;
+
+   il_PrimeGenerationUS += (Clock::GetThreadMicroseconds() - generateStartUS);
+
+   return true;
+}
+
+// Claim the next piece of the range.  Returns false if the entire range has been claimed
+// and there are no more primes to generate.
+bool  Worker::ClaimNextTask(void)
+{
+   bool  claimed;
+
+   ip_RangeLocker->Lock();
 
-   // Get a little extra space because we want to use 0 to end the list.
-   il_PrimeList = (uint64_t *) xmalloc((ii_MaxWorkSize + 10) * sizeof(uint64_t));
+   while (il_NextPrime >= il_ClaimedEnd && il_ClaimedEnd < il_RangeEnd)
+   {
+      il_ClaimedEnd += il_TaskSize;
+
+      if (il_ClaimedEnd > il_RangeEnd)
+         il_ClaimedEnd = il_RangeEnd;
+   }
+
+   claimed = (il_NextPrime < il_ClaimedEnd);
+
+   ip_RangeLocker->Release();
+
+   return claimed;
+}
+
+void  Worker::StartPrimeIterator(void)
+{
+   // The end of the range could change if the App gives part of it to another worker.
+   ip_RangeLocker->Lock();
+
+   if (il_PrimeBase == 0)
+      ip_PrimeIterator.jump_to(il_RangeStart, il_RangeEnd);
+   else
+      ip_WidePrimeIterator.jump_to(il_PrimeBase, il_RangeStart, il_RangeEnd);
+
+   ip_RangeLocker->Release();
+
+   il_NextPrime = (il_PrimeBase == 0 ? ip_PrimeIterator.next_prime() : ip_WidePrimeIterator.next_prime());
+}
+
+static uint64_t ComputeTaskSize(bool gpuWorker, uint64_t rangeStart, uint64_t rangeEnd)
+{
+   // GPU workers always test a full list, so there is no point in letting another
+   // worker take part of its range until it is nearly done.
+   if (gpuWorker)
+      return rangeEnd - rangeStart;
+
+   return (rangeEnd - rangeStart + TASKS_PER_RANGE - 1) / TASKS_PER_RANGE;
+}
+
+void  Worker::SetPrimeRange(uint64_t rangeStart, uint64_t rangeEnd, bool isStolen)
+{
+   ip_RangeLocker->Lock();
+
+   il_RangeStart = rangeStart;
+   il_RangeEnd = rangeEnd;
+   il_ClaimedEnd = rangeStart;
+   il_TaskSize = ComputeTaskSize(ib_GpuWorker, rangeStart, rangeEnd);
+   ib_RangeWasSplit = isStolen;
+
+   ip_RangeLocker->Release();
+}
+
+bool  Worker::AssignPrimeRange(uint64_t rangeStart, uint64_t rangeEnd)
+{
+   ip_RangeLocker->Lock();
+
+   // The worker changes its status to waiting while holding the lock, so if it is busy
+   // now it will see the queued range when it finishes its current range.
+   if (IsStatusWorking() || IsStatusHasWorkToDo())
+   {
+      // There is only room for one queued range.  Don't replace it as the primes in
+      // that range would never be tested.
+      if (ib_HasNextRange)
+      {
+         ip_RangeLocker->Release();
+         return false;
+      }
+
+      il_NextRangeStart = rangeStart;
+      il_NextRangeEnd = rangeEnd;
+      ib_HasNextRange = true;
+
+      ip_RangeLocker->Release();
+      return true;
+   }
+
+   ip_RangeLocker->Release();
+
+   SetPrimeRange(rangeStart, rangeEnd);
+   SetStatusHasWorkToDo();
+   return true;
+}
+
+// In both cases the App is notified so that it can queue another range for this
+// worker or give work to this worker.
+bool  Worker::TakeNextPrimeRange(void)
+{
+   ip_RangeLocker->Lock();
+
+   if (!ib_HasNextRange)
+   {
+      iws_WorkerStatus.store(WS_WAITING_FOR_WORK, std::memory_order_release);
+
+      ip_RangeLocker->Release();
+
+      ip_App->NotifyWorkerReady();
+      return false;
+   }
+
+   il_RangeStart = il_NextRangeStart;
+   il_RangeEnd = il_NextRangeEnd;
+   il_ClaimedEnd = il_NextRangeStart;
+   il_TaskSize = ComputeTaskSize(ib_GpuWorker, il_NextRangeStart, il_NextRangeEnd);
+   ib_RangeWasSplit = false;
+   ib_HasNextRange = false;
+
+   ip_RangeLocker->Release();
+
+   ip_App->NotifyWorkerReady();
+   return true;
+}
+
+uint64_t  Worker::GetUnclaimedRange(void)
+{
+   uint64_t  unclaimed = 0;
+
+   ip_RangeLocker->Lock();
+
+   if (il_RangeEnd > il_ClaimedEnd)
+      unclaimed = il_RangeEnd - il_ClaimedEnd;
+
+   if (ib_HasNextRange)
+      unclaimed += il_NextRangeEnd - il_NextRangeStart;
+
+   ip_RangeLocker->Release();
+
+   return unclaimed;
+}
+
+bool  Worker::SplitPrimeRange(uint64_t minSplitPoint, uint64_t &stolenStart, uint64_t &stolenEnd)
+{
+   uint64_t  splitPoint;
+   bool      wasSplit = false;
+
+   ip_RangeLocker->Lock();
+
+   // The worker hasn't started on the queued range, so give all of it away
+   if (ib_HasNextRange && il_NextRangeStart >= minSplitPoint)
+   {
+      stolenStart = il_NextRangeStart;
+      stolenEnd = il_NextRangeEnd;
+
+      ib_HasNextRange = false;
+
+      ip_RangeLocker->Release();
+      return true;
+   }
+
+   // Only split if both this worker and the thief will have at least one task to do
+   if (il_RangeEnd > il_ClaimedEnd && il_RangeEnd - il_ClaimedEnd >= 2 * il_TaskSize)
+   {
+      splitPoint = il_ClaimedEnd + (il_RangeEnd - il_ClaimedEnd) / 2;
+
+      if (splitPoint >= minSplitPoint)
+      {
+         stolenStart = splitPoint;
+         stolenEnd = il_RangeEnd;
+
+         il_RangeEnd = splitPoint;
+         ib_RangeWasSplit = true;
+         wasSplit = true;
+      }
+   }
+
+   ip_RangeLocker->Release();
+
+   return wasSplit;
 }
 
 // This is executed in a thread that is not the main thread
@@ -124,88 +455,320 @@ void  Worker::StartProcessing(void)
 {
    uint64_t startTime, endTime;
 
-#ifdef USE_X86
-   uint16_t savedFpuMode;
-#endif
+   // Pin before allocating so that the prime list is first touched on this worker's node
+   if (ii_Cpu != NO_CPU && !Affinity::PinCurrentThread(ii_Cpu))
+      ip_App->WriteToConsole(COT_OTHER, "Unable to pin worker %u to CPU %d", ii_MyId, ii_Cpu);
+
+   Counters::BindThread(&ic_Counters);
+
+   ip_App->BindFactorQueue(ii_MyId);
 
    AllocatePrimeList();
 
+   if (ib_UseProducer)
+      StartProducer();
+
    SetStatusWaitingForWork();
 
    while (true)
    {
+      WaitForWork();
+
+      // If we are still waiting for work, then sieving is done
       if (IsStatusWaitingForWork())
+         break;
+
+      SetStatusWorking();
+
+      // Keep testing ranges until the App stops queueing them for this worker
+      do
       {
-         if (ip_App->IsSievingDone())
-            break;
+         if (il_ReadyUS > 0)
+         {
+            uint64_t latencyUS = Clock::GetCurrentMicrosecond() - il_ReadyUS;
 
-         Sleep(1);
-         continue;
-      }
+            il_DispatchCount++;
+            il_DispatchLatencyUS += latencyUS;
 
-      SetStatusWorking();
+            if (latencyUS > il_MaxDispatchLatencyUS)
+               il_MaxDispatchLatencyUS = latencyUS;
+         }
 
-      startTime = Clock::GetThreadMicroseconds();
+         startTime = Clock::GetThreadMicroseconds();
 
-#ifdef USE_X86
-      // This is so the worker classes don't need to do this.
-      savedFpuMode = fpu_mod_init();
+         TestPrimeRange();
+
+         endTime = Clock::GetThreadMicroseconds();
+
+         // The main thread can read this at any time, but only this thread updates it.
+         il_WorkerCpuUS.store(il_WorkerCpuUS.load(std::memory_order_relaxed) + (endTime - startTime), std::memory_order_release);
+
+         // Don't change the worksize if part of the range was given to another worker
+         // since the time needed to test the range doesn't reflect the worksize.
+         if (!ib_GpuWorker && !ib_RangeWasSplit && il_LargestPrimeTested.load(std::memory_order_relaxed) > 100000)
+         {
+            uint64_t newWorkSize = ComputeOptimalWorkSize(startTime, endTime);
+
+            // This is the hard-coded limit in App.cpp
+            if (newWorkSize > 1000000000)
+               newWorkSize = 1000000000;
+
+            if (ii_MyId == 1 && newWorkSize > ii_MaxWorkSize)
+               ip_App->WriteToConsole(COT_OTHER, "Increasing worksize to %llu since each chunk is tested in less than a second", newWorkSize);
+
+            if (ii_MyId == 1 && newWorkSize < ii_MaxWorkSize)
+               ip_App->WriteToConsole(COT_OTHER, "Decreasing worksize to %llu since each chunk needs more than 5 seconds to test", newWorkSize);
+
+            if (newWorkSize != ii_MaxWorkSize)
+            {
+               ii_MaxWorkSize = (uint32_t) newWorkSize;
+
+               if (ii_PrimeListSize != MIN(ii_MaxWorkSize, MAX_PRIMES_PER_LIST))
+               {
+                  xfree(il_PrimeList);
+                  il_PrimeList = NULL;
+
+                  AllocatePrimeList();
+               }
+            }
+         }
+
+         il_ReadyUS = Clock::GetCurrentMicrosecond();
+      } while (TakeNextPrimeRange());
+   }
+
+   if (ib_UseProducer)
+      StopProducer();
+
+   SetStatusStopped();
+}
+
+void  Worker::TestPrimeRange(void)
+{
+   if (ib_UseProducer)
+   {
+      ip_ProducerLocker->Lock();
+      ips_ProducerStatus = PS_START_RANGE;
+      ip_ProducerLocker->ClearCondition();
+      ip_ProducerLocker->Release();
+
+      while (GetProducedPrimeList())
+         TestPrimeList();
+
+      return;
+   }
+
+   StartPrimeIterator();
+
+   while (FillPrimeList(il_PrimeList, ii_PrimesInList))
+      TestPrimeList();
+}
+
+void  Worker::TestPrimeList(void)
+{
+   uint64_t startUS = Clock::GetCurrentMicrosecond();
+
+   ii_PaddedPrimesInList = GetPaddedPrimeCount(ii_PrimesInList);
+   ii_PrimesLeftToCount = ii_PrimesInList;
+
+#ifdef USE_X87
+   // This is so the worker classes don't need to do this.
+   uint16_t savedFpuMode = fpu_mod_init();
 #endif
 
-      if (ii_MiniChunkSize > 0 &&
-         il_PrimeList[0] > il_MinPrimeForMiniChunkMode &&
-         il_PrimeList[ii_PrimesInList-1] < il_MaxPrimeForMiniChunkMode)
-         TestWithMiniChunks();
+   if (ii_MiniChunkSize > 0 &&
+      il_PrimeList[0] > il_MinPrimeForMiniChunkMode &&
+      il_PrimeList[ii_PrimesInList-1] < il_MaxPrimeForMiniChunkMode)
+   {
+      TestWithMiniChunks();
+
+      ik_MiniChunkStats.calls += (ii_PrimesInList + ii_MiniChunkSize - 1) / ii_MiniChunkSize;
+      ik_MiniChunkStats.primes += ii_PrimesInList;
+      ik_MiniChunkStats.elapsedUS += (Clock::GetCurrentMicrosecond() - startUS);
+   }
+   else
+   {
+      if (ik_MpContext.q != NULL)
+         MpArith::ComputeContext(ik_MpContext, ii_PaddedPrimesInList);
+
+      if (ib_UseLanes && ip_App->GetLanes() > 0)
+         ii_LanesForList = ip_App->GetLanes();
+
+      if (ib_UseLanes && ip_App->GetLanes() == 0 && ii_PrimesInList >= MIN_CALIBRATION_PRIMES)
+         CalibrateLanes();
       else
          TestMegaPrimeChunk();
 
-#ifdef USE_X86
-      fpu_mod_fini(savedFpuMode);
+      ik_MegaChunkStats.calls++;
+      ik_MegaChunkStats.primes += ii_PrimesInList;
+      ik_MegaChunkStats.elapsedUS += (Clock::GetCurrentMicrosecond() - startUS);
+   }
+
+#ifdef USE_X87
+   fpu_mod_fini(savedFpuMode);
 #endif
+}
 
-      // We need to lock while updating these variables as the main thread can read them.
-      ip_StatsLocker->Lock();
+#ifdef WIN32
+static DWORD WINAPI ProducerEntryPoint(LPVOID threadInfo)
+#else
+static void *ProducerEntryPoint(void *threadInfo)
+#endif
+{
+   Worker *worker = (Worker *) threadInfo;
 
-      endTime = Clock::GetThreadMicroseconds();
+   worker->ProducePrimes();
 
-      il_WorkerCpuUS += (endTime - startTime);
+#ifdef WIN32
+   return 0;
+#else
+   pthread_exit(0);
+#endif
+}
 
-      ip_StatsLocker->Release();
+void  Worker::StartProducer(void)
+{
+   ips_ProducerStatus = PS_IDLE;
 
-      if (!ib_GpuWorker && il_LargestPrimeTested > 100000)
-      {
-         uint64_t newWorkSize = ComputeOptimalWorkSize(startTime, endTime);
+#ifdef WIN32
+   CreateThread(0, 0, ProducerEntryPoint, this, 0, 0);
+#else
+   pthread_t producerThread;
 
-         // This is the hard-coded limit in App.cpp
-         if (newWorkSize > 1000000000)
-            newWorkSize = 1000000000;
+   pthread_create(&producerThread, NULL, &ProducerEntryPoint, this);
+   pthread_detach(producerThread);
+#endif
+}
 
-         if (ii_MyId == 1 && newWorkSize > ii_MaxWorkSize)
-            ip_App->WriteToConsole(COT_OTHER, "Increasing worksize to %llu since each chunk is tested in less than a second", newWorkSize);
+void  Worker::StopProducer(void)
+{
+   ip_ProducerLocker->Lock();
 
-         if (ii_MyId == 1 && newWorkSize < ii_MaxWorkSize)
-            ip_App->WriteToConsole(COT_OTHER, "Decreasing worksize to %llu since each chunk needs more than 5 seconds to test", newWorkSize);
+   ips_ProducerStatus = PS_STOP;
+   ip_ProducerLocker->ClearCondition();
 
-         if (newWorkSize != ii_MaxWorkSize)
-         {
-            ii_MaxWorkSize = (uint32_t) newWorkSize;
+   while (ips_ProducerStatus != PS_STOPPED)
+      ip_ProducerLocker->WaitForCondition(1000);
 
-            xfree(il_PrimeList);
-            il_PrimeList = NULL;
+   ip_ProducerLocker->Release();
+}
 
-            AllocatePrimeList();
-         }
+// Wait for the producer to fill il_NextPrimeList, then copy it to il_PrimeList
+// and tell the producer to start on the next list.  This returns false when there
+// are no more primes in the range.
+bool  Worker::GetProducedPrimeList(void)
+{
+   ip_ProducerLocker->Lock();
+
+   while (ips_ProducerStatus == PS_START_RANGE || ips_ProducerStatus == PS_FILLING)
+      ip_ProducerLocker->WaitForCondition(1000);
+
+   if (ips_ProducerStatus == PS_RANGE_DONE)
+   {
+      ips_ProducerStatus = PS_IDLE;
+
+      ip_ProducerLocker->Release();
+      return false;
+   }
+
+   // The list for a GPU worker is owned by its kernel, so copy rather than swap
+   memcpy(il_PrimeList, il_NextPrimeList, ii_PrimeListSize * sizeof(uint64_t));
+   ii_PrimesInList = ii_NextPrimesInList;
+
+   ips_ProducerStatus = PS_FILLING;
+   ip_ProducerLocker->ClearCondition();
+
+   ip_ProducerLocker->Release();
+   return true;
+}
+
+// This is executed in the thread that generates primes for a GPU worker.  It fills
+// il_NextPrimeList while the worker is testing il_PrimeList.
+void  Worker::ProducePrimes(void)
+{
+   bool  filled;
+
+   ip_ProducerLocker->Lock();
+
+   while (true)
+   {
+      while (ips_ProducerStatus == PS_IDLE || ips_ProducerStatus == PS_FULL || ips_ProducerStatus == PS_RANGE_DONE)
+         ip_ProducerLocker->WaitForCondition(1000);
+
+      if (ips_ProducerStatus == PS_STOP)
+         break;
+
+      if (ips_ProducerStatus == PS_START_RANGE)
+      {
+         ip_ProducerLocker->Release();
+
+         StartPrimeIterator();
+
+         ip_ProducerLocker->Lock();
       }
 
-      SetStatusWaitingForWork();
+      ip_ProducerLocker->Release();
+
+      filled = FillPrimeList(il_NextPrimeList, ii_NextPrimesInList);
+
+      ip_ProducerLocker->Lock();
+
+      ips_ProducerStatus = (filled ? PS_FULL : PS_RANGE_DONE);
+      ip_ProducerLocker->ClearCondition();
    }
 
-   SetStatusStopped();
+   ips_ProducerStatus = PS_STOPPED;
+   ip_ProducerLocker->ClearCondition();
+
+   ip_ProducerLocker->Release();
+}
+
+void  Worker::WaitForWork(void)
+{
+   ip_WorkerWakeup->Lock();
+
+   // The timeout is only a safety net.  The App will wake us when it gives us work
+   // or when sieving is done.
+   while (IsStatusWaitingForWork() && !ip_App->IsSievingDone())
+      ip_WorkerWakeup->WaitForCondition(1000);
+
+   ip_WorkerWakeup->Release();
+}
+
+void  Worker::Wake(void)
+{
+   ip_WorkerWakeup->Lock();
+   ip_WorkerWakeup->ClearCondition();
+   ip_WorkerWakeup->Release();
+}
+
+// The status is changed while holding the wakeup lock so that the worker cannot
+// miss the wakeup between checking its status and waiting.
+void  Worker::SetStatusHasWorkToDo(void)
+{
+   ip_WorkerWakeup->Lock();
+   iws_WorkerStatus.store(WS_HAS_WORK_TO_DO, std::memory_order_release);
+   ip_WorkerWakeup->ClearCondition();
+   ip_WorkerWakeup->Release();
+}
+
+void  Worker::SetStatusWaitingForWork(void)
+{
+   iws_WorkerStatus.store(WS_WAITING_FOR_WORK, std::memory_order_release);
+
+   ip_App->NotifyWorkerReady();
+}
+
+void  Worker::SetStatusStopped(void)
+{
+   iws_WorkerStatus.store(WS_STOPPED, std::memory_order_release);
+
+   ip_App->NotifyWorkerReady();
 }
 
 void   Worker::SetMiniChunkRange(uint64_t minPrimeForMiniChunkMode, uint64_t maxPrimeForMiniChunkMode, uint32_t chunkSize)
 {
-   if (chunkSize < 2 || chunkSize > 128)
+   if (chunkSize < 2 || chunkSize > MAX_MINI_CHUNK_SIZE)
       FatalError("Invalid number for chunk size");
 
    ii_MiniChunkSize = chunkSize;
@@ -213,43 +776,249 @@ void   Worker::SetMiniChunkRange(uint64_t minPrimeForMiniChunkMode, uint64_t max
    il_MaxPrimeForMiniChunkMode = maxPrimeForMiniChunkMode;
 }
 
+// The span is taken directly from il_PrimeList so that the primes do not have to be
+// copied.  It is padded in place to a multiple of the chunk size.
 void    Worker::TestWithMiniChunks(void)
 {
-   uint64_t maxPrime = ip_App->GetMaxPrime();
-   uint32_t countInChunk = 0;
-   uint64_t miniPrimeChunk[128];
-   uint32_t pIdx = 0;
+   uint64_t    maxPrime = ip_App->GetMaxPrime();
+   uint32_t    chunks = (ii_PrimesInList + ii_MiniChunkSize - 1) / ii_MiniChunkSize;
+   uint32_t    pIdx;
+   primespan_t span;
+
+   // A chunk is not tested if its first prime is above the max prime
+   while (chunks > 0 && il_PrimeList[(chunks-1) * ii_MiniChunkSize] >= maxPrime)
+      chunks--;
 
-   while (pIdx < ii_PrimesInList && il_PrimeList[pIdx] < maxPrime)
+   if (chunks == 0)
+      return;
+
+   span.primes = il_PrimeList;
+   span.count = chunks * ii_MiniChunkSize;
+
+   for (pIdx=ii_PrimesInList; pIdx<span.count; pIdx++)
+      il_PrimeList[pIdx] = il_PrimeList[pIdx-1];
+
+   span.context = NULL;
+
+   if (ik_MpContext.q != NULL)
    {
-      countInChunk = 0;
+      MpArith::ComputeContext(ik_MpContext, span.count);
 
-      while (pIdx < ii_PrimesInList && countInChunk < ii_MiniChunkSize)
-      {
-         miniPrimeChunk[countInChunk] = il_PrimeList[pIdx];
+      span.context = &ik_MpContext;
+   }
 
-         pIdx++;
+   TestMiniPrimeSpan(span);
 
-         countInChunk++;
-      }
+   // Publish the stats once for the span rather than for each chunk
+   SetLargestPrimeTested(span.primes[span.count-1], span.count);
+}
 
-      if (countInChunk == 0)
-         break;
+void    Worker::TestMiniPrimeSpan(const primespan_t &span)
+{
+   for (uint32_t pIdx=0; pIdx<span.count; pIdx+=ii_MiniChunkSize)
+      TestMiniPrimeChunk(&span.primes[pIdx]);
+}
+
+static const uint32_t laneChoices[LANE_CHOICES] = { 4, 8, 16 };
+
+// Test the list in slices, trying each number of lanes on CALIBRATION_PASSES slices.
+// Each slice is a multiple of PRIME_LIST_MULTIPLE primes so every lane choice can
+// process it without running past the end.
+void  Worker::CalibrateLanes(void)
+{
+   uint64_t      *primeList = il_PrimeList;
+   uint32_t       primesInList = ii_PrimesInList;
+   mpcontext_t    mpContext = ik_MpContext;
+   uint32_t       slices = LANE_CHOICES * CALIBRATION_PASSES;
+   uint32_t       sliceSize = PRIME_LIST_MULTIPLE * ((primesInList / slices) / PRIME_LIST_MULTIPLE);
+   uint64_t       laneUS[LANE_CHOICES] = { 0 };
+   uint64_t       lanePrimes[LANE_CHOICES] = { 0 };
+   uint32_t       idx, bestIdx = 0;
+
+   for (uint32_t slice=0; slice<slices; slice++)
+   {
+      uint32_t first = slice * sliceSize;
+      uint64_t startUS = Clock::GetCurrentMicrosecond();
+
+      idx = slice % LANE_CHOICES;
 
-      // Fill the rest of the array with useful values
-      while (countInChunk < ii_MiniChunkSize)
+      il_PrimeList = primeList + first;
+      ii_PrimesInList = (slice == slices - 1 ? primesInList - first : sliceSize);
+      ii_LanesForList = laneChoices[idx];
+
+      if (mpContext.q != NULL)
       {
-         miniPrimeChunk[countInChunk] = miniPrimeChunk[countInChunk-1];
-         countInChunk++;
+         ik_MpContext.p = mpContext.p + first;
+         ik_MpContext.q = mpContext.q + first;
+         ik_MpContext.one = mpContext.one + first;
+         ik_MpContext.r2 = mpContext.r2 + first;
       }
 
-      TestMiniPrimeChunk(miniPrimeChunk);
+      TestMegaPrimeChunk();
+
+      laneUS[idx] += Clock::GetCurrentMicrosecond() - startUS;
+      lanePrimes[idx] += ii_PrimesInList;
+   }
+
+   il_PrimeList = primeList;
+   ii_PrimesInList = primesInList;
+   ik_MpContext = mpContext;
+
+   // Choose the number of lanes with the lowest time per prime
+   for (idx=1; idx<LANE_CHOICES; idx++)
+      if ((double) laneUS[idx] / (double) lanePrimes[idx] < (double) laneUS[bestIdx] / (double) lanePrimes[bestIdx])
+         bestIdx = idx;
+
+   ii_LanesForList = laneChoices[bestIdx];
+
+   // Another worker might have finished calibrating first
+   if (ip_App->GetLanes() > 0)
+      return;
+
+   ip_App->SetLanes(laneChoices[bestIdx]);
+
+   ip_App->WriteToConsole(COT_OTHER, "Using %u lanes since that is the fastest on this CPU", laneChoices[bestIdx]);
+}
+
+void  Worker::UsePowModKernel(void)
+{
+   ipk_PowModKernel = ip_App->GetPowModKernel();
+
+   if (ipk_PowModKernel == PK_AUTO)
+      ipk_PowModKernel = (CpuSupportsAvx512Ifma() ? PK_AVX512 : PK_MONT);
+
+   if (ipk_PowModKernel == PK_AVX512 && !CpuSupportsAvx512Ifma())
+      FatalError("The avx512 kernel requires a CPU that supports AVX-512 IFMA");
+
+   // The IFMA kernel computes its own constants and calibrating the lanes would
+   // only time the IFMA code for most ranges
+   if (ipk_PowModKernel == PK_MONT)
+   {
+      UseMontgomeryContext();
+      UseLanes();
+   }
+}
+
+void  Worker::PowModBlock(uint32_t idx, uint64_t *b, const MpPowPlan &plan)
+{
+   uint32_t k;
+
+   // Montgomery arithmetic needs an odd p.  Sieves starting at p = 1 have 2 in
+   // their first block, so that block uses the FPU kernel, which handles p = 2.
+   bool  useFpu = (ipk_PowModKernel == PK_FPU || !(il_PrimeList[idx] & 1));
+
+#ifdef USE_X86
+   if (!useFpu && ipk_PowModKernel == PK_AVX512 && il_PrimeList[idx + PRIME_LIST_MULTIPLE - 1] < PMAX_MAX_52BIT)
+   {
+      PowModBlockIfma(idx, b, plan);
+      return;
+   }
+#endif
+
+   if (useFpu)
+   {
+      for (k=0; k<PRIME_LIST_MULTIPLE; k+=4)
+         fpu_powmod_4b_1n_4p(&b[k], plan.exponent(), &il_PrimeList[idx + k]);
+
+      return;
+   }
+
+   if (ii_LanesForList == 16)
+      PowModBlockMont<16>(idx, b, plan);
+   else if (ii_LanesForList == 8)
+      PowModBlockMont<8>(idx, b, plan);
+   else
+      PowModBlockMont<4>(idx, b, plan);
+}
+
+template <size_t N>
+void  Worker::PowModBlockMont(uint32_t idx, uint64_t *b, const MpPowPlan &plan)
+{
+   for (uint32_t k=0; k<PRIME_LIST_MULTIPLE; k+=N)
+   {
+      // There is no context when the IFMA kernel falls back to this for p >= 2^52
+      MpArithVector<N> mp = (ik_MpContext.q != NULL ? MpArithVector<N>(ik_MpContext, idx + k) : MpArithVector<N>(&il_PrimeList[idx + k]));
+
+      MpResVector<N> res = mp.resToN(mp.pow(mp.nToRes(&b[k]), plan));
+
+      for (size_t j=0; j<N; j++)
+         b[k + j] = res[j];
+   }
+}
+
+void  Worker::PowModBlockBase2(uint32_t idx, uint64_t *r, const MpPowPlan &plan, bool inverse)
+{
+   uint32_t k;
+   bool  useFpu = (ipk_PowModKernel == PK_FPU || !(il_PrimeList[idx] & 1));
+
+#ifdef USE_X86
+   if (!useFpu && ipk_PowModKernel == PK_AVX512 && il_PrimeList[idx + PRIME_LIST_MULTIPLE - 1] < PMAX_MAX_52BIT)
+   {
+      PowModBlockBase2Ifma(idx, r, plan, inverse);
+      return;
+   }
+#endif
+
+   // The FPU kernel has no special case for base 2.  It is also used for p = 2.
+   if (useFpu)
+   {
+      for (k=0; k<PRIME_LIST_MULTIPLE; k++)
+         r[k] = (inverse ? (il_PrimeList[idx + k] + 1) >> 1 : 2);
+
+      PowModBlock(idx, r, plan);
+      return;
+   }
+
+   if (ii_LanesForList == 16)
+      PowModBlockBase2Mont<16>(idx, r, plan, inverse);
+   else if (ii_LanesForList == 8)
+      PowModBlockBase2Mont<8>(idx, r, plan, inverse);
+   else
+      PowModBlockBase2Mont<4>(idx, r, plan, inverse);
+}
+
+template <size_t N>
+void  Worker::PowModBlockBase2Mont(uint32_t idx, uint64_t *r, const MpPowPlan &plan, bool inverse)
+{
+   for (uint32_t k=0; k<PRIME_LIST_MULTIPLE; k+=N)
+   {
+      MpArithVector<N> mp = (ik_MpContext.q != NULL ? MpArithVector<N>(ik_MpContext, idx + k) : MpArithVector<N>(&il_PrimeList[idx + k]));
+
+      MpResVector<N> res = mp.resToN(inverse ? mp.powHalf(plan.exponent()) : mp.pow2(plan.exponent()));
+
+      for (size_t j=0; j<N; j++)
+         r[k + j] = res[j];
+   }
+}
+
+#ifdef USE_X86
+IFMA_TARGET void  Worker::PowModBlockBase2Ifma(uint32_t idx, uint64_t *r, const MpPowPlan &plan, bool inverse)
+{
+   for (uint32_t k=0; k<PRIME_LIST_MULTIPLE; k+=IFMA_VECTOR_SIZE)
+   {
+      MpArithVectorIfma mp(&il_PrimeList[idx + k]);
+
+      MpResVectorIfma res = mp.resToN(inverse ? mp.powHalf(plan.exponent()) : mp.pow2(plan.exponent()));
 
-      il_PrimesTested += countInChunk;
-      il_LargestPrimeTested = miniPrimeChunk[countInChunk-1];
+      for (size_t j=0; j<IFMA_VECTOR_SIZE; j++)
+         r[k + j] = res[j];
    }
 }
 
+IFMA_TARGET void  Worker::PowModBlockIfma(uint32_t idx, uint64_t *b, const MpPowPlan &plan)
+{
+   for (uint32_t k=0; k<PRIME_LIST_MULTIPLE; k+=IFMA_VECTOR_SIZE)
+   {
+      MpArithVectorIfma mp(&il_PrimeList[idx + k]);
+
+      MpResVectorIfma res = mp.resToN(mp.pow(mp.nToRes(&b[k]), plan));
+
+      for (size_t j=0; j<IFMA_VECTOR_SIZE; j++)
+         b[k + j] = res[j];
+   }
+}
+#endif
+
 uint64_t Worker::ComputeOptimalWorkSize(uint64_t startTime, uint64_t endTime)
 {
    uint64_t optimalWorkSize = ii_MaxWorkSize;
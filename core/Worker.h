@@ -14,15 +14,74 @@
 
 #include "main.h"
 #include <vector>
+#include <atomic>
 
 class Worker;
 
+// The time spent in the TestMegaPrimeChunk() or TestMiniPrimeChunk() of a worker
+typedef struct {
+   uint64_t calls;
+   uint64_t primes;
+   uint64_t elapsedUS;
+} kernelstats_t;
+
 #ifndef WIN32
 #include <pthread.h>
 #endif
 
 #include "App.h"
 #include "SharedMemoryItem.h"
+#include "Counters.h"
+#include "MpArith.h"
+#include "WidePrimeIterator.h"
+
+#include "../sieve/primesieve.hpp"
+
+// The prime list for a CPU worker never needs to be larger than this.  If the range
+// of primes given to a worker has more primes than this, then it will test that range
+// with multiple passes of the list.
+#define MAX_PRIMES_PER_LIST   4000000
+
+// Some workers (especially those using AVX) require that the number of primes in the
+// list be a multiple of this.
+#define PRIME_LIST_MULTIPLE   16
+
+// The largest chunk size that can be passed to SetMiniChunkRange().  The prime list has
+// room for this many extra primes so that a span can be padded in place.
+#define MAX_MINI_CHUNK_SIZE   128
+
+// When -j is not given, a worker that calls UseLanes() splits its first list with at
+// least MIN_CALIBRATION_PRIMES primes into slices and tests each of these numbers of
+// lanes on CALIBRATION_PASSES slices each.  The fastest is then used by all workers.
+#define LANE_CHOICES            3
+#define CALIBRATION_PASSES      2
+#define MIN_CALIBRATION_PRIMES  (LANE_CHOICES * CALIBRATION_PASSES * 1024)
+#define DEFAULT_LANES           4
+
+// A CPU worker claims its range in pieces of this fraction of the range.  The part of the
+// range that has not been claimed can be split off and given to an idle worker.
+#define TASKS_PER_RANGE       16
+
+// These are used to synchronize a GPU worker with the thread generating its primes
+typedef enum { PS_IDLE,             // Indicates the producer has no range to generate primes for
+               PS_START_RANGE,      // Indicates the worker has a new range for the producer
+               PS_FILLING,          // Indicates the producer is filling the next list
+               PS_FULL,             // Indicates the next list is ready for the worker
+               PS_RANGE_DONE,       // Indicates there are no more primes in the range
+               PS_STOP,             // Indicates the producer should exit
+               PS_STOPPED           // Indicates the producer has exited
+             } producerstatus_t;
+
+// A span of the prime list that is given to TestMiniPrimeSpan().  primes is 64-byte
+// aligned and count is a multiple of the mini chunk size.  The end of the span is
+// padded with copies of the last prime.
+typedef struct {
+   uint64_t *primes;
+   uint32_t  count;
+
+   // This is NULL unless the worker called UseMontgomeryContext().  context->p is primes.
+   const mpcontext_t *context;
+} primespan_t;
 
 typedef enum { WS_INITIALIZING,
                WS_WAITING_FOR_WORK, // Indicates this thread is initialized and waiting for work
@@ -46,38 +105,85 @@ public:
 
    virtual void      TestMiniPrimeChunk(uint64_t *miniPrimeChunk) = 0;
 
+   // This is called once for each prime list that is tested in mini-chunk mode.  The
+   // default calls TestMiniPrimeChunk() for each chunk of the span.  Override it to
+   // set up state once for the span rather than once for each chunk.
+   virtual void      TestMiniPrimeSpan(const primespan_t &span);
+
    virtual void      TestMegaPrimeChunk(void) = 0;
 
    virtual void      CleanUp(void) = 0;
 
-   // These are only to be used if calling multiple getters in succession
-   void              LockStats(void)    { ip_StatsLocker->Lock(); };
-   void              ReleaseStats(void) { ip_StatsLocker->Release(); };
-
    void              AllocatePrimeList(void);
 
    uint32_t          GetMaxWorkSize(void) { return ii_MaxWorkSize; };
    uint64_t         *GetPrimeList(void) { return il_PrimeList; };
 
-   uint64_t          GetWorkerCpuUS(void)  { return il_WorkerCpuUS; }
-   uint64_t          GetPrimesTested(void)    { return il_PrimesTested; }
-   uint64_t          GetLargestPrimeTested(void)  { return il_LargestPrimeTested; }
+   // These can be called by any thread without blocking the worker
+   uint64_t          GetWorkerCpuUS(void)  { return il_WorkerCpuUS.load(std::memory_order_acquire); }
+   uint64_t          GetPrimesTested(void)    { return il_PrimesTested.load(std::memory_order_acquire); }
+   uint64_t          GetLargestPrimeTested(void)  { return il_LargestPrimeTested.load(std::memory_order_acquire); }
+
+   // These should only be called after the worker has stopped.  Dispatch latency is the
+   // time from when this worker finished a chunk until it started the next one.
+   uint64_t          GetPrimeGenerationUS(void)  { return il_PrimeGenerationUS; }
+   uint64_t          GetDispatchCount(void)  { return il_DispatchCount; }
+   uint64_t          GetDispatchLatencyUS(void)  { return il_DispatchLatencyUS; }
+   uint64_t          GetMaxDispatchLatencyUS(void)  { return il_MaxDispatchLatencyUS; }
+   const kernelstats_t &GetMegaChunkStats(void)  { return ik_MegaChunkStats; }
+   const kernelstats_t &GetMiniChunkStats(void)  { return ik_MiniChunkStats; }
+
+   // The main thread can read these at any time
+   counterslot_t    *GetCounters(void) { return &ic_Counters; };
 
    bool              IsInitialized(void) { return ib_Initialized; };
 
-   bool              IsStatusHasWorkToDo(void) { return (((workerstatus_t) ip_WorkerStatus->GetValueNoLock()) == WS_HAS_WORK_TO_DO); };
-   bool              IsStatusWaitingForWork(void) { return (((workerstatus_t) ip_WorkerStatus->GetValueNoLock()) == WS_WAITING_FOR_WORK); };
-   bool              IsStatusWorking(void) { return (((workerstatus_t) ip_WorkerStatus->GetValueNoLock()) == WS_WORKING); };
-   bool              IsStatusStopped(void) { return (((workerstatus_t) ip_WorkerStatus->GetValueNoLock()) == WS_STOPPED); };
+   bool              IsStatusHasWorkToDo(void) { return (iws_WorkerStatus.load(std::memory_order_acquire) == WS_HAS_WORK_TO_DO); };
+   bool              IsStatusWaitingForWork(void) { return (iws_WorkerStatus.load(std::memory_order_acquire) == WS_WAITING_FOR_WORK); };
+   bool              IsStatusWorking(void) { return (iws_WorkerStatus.load(std::memory_order_acquire) == WS_WORKING); };
+   bool              IsStatusStopped(void) { return (iws_WorkerStatus.load(std::memory_order_acquire) == WS_STOPPED); };
+
+   // The worker will generate and test all primes where rangeStart <= p < rangeEnd.
+   // isStolen indicates that the range was split from the range of another worker.
+   // This must only be called when the worker is waiting for work.
+   void              SetPrimeRange(uint64_t rangeStart, uint64_t rangeEnd, bool isStolen = false);
+   uint64_t          GetRangeStart(void) { return il_RangeStart.load(std::memory_order_acquire); };
+   uint64_t          GetRangeEnd(void) { return il_RangeEnd.load(std::memory_order_acquire); };
+
+   // If the worker is busy, this queues the range so that the worker can start on it as
+   // soon as it finishes its current range.  If the worker is waiting for work, this will
+   // give it the range and wake it.  This returns false if the worker is busy and already
+   // has a queued range, in which case the caller still owns the range.
+   bool              AssignPrimeRange(uint64_t rangeStart, uint64_t rangeEnd);
+
+   // Returns true if the worker is busy and has room for another range in its queue
+   bool              CanQueuePrimeRange(void) { return ((IsStatusWorking() || IsStatusHasWorkToDo()) && !ib_HasNextRange.load(std::memory_order_acquire)); };
+
+   // This returns the size of the part of the range that the worker has not started on
+   uint64_t          GetUnclaimedRange(void);
+
+   // This gives the queued range or the upper half of the unclaimed part of the current
+   // range to the caller.  It will not split below minSplitPoint.  It returns false if
+   // there is nothing large enough to take.
+   bool              SplitPrimeRange(uint64_t minSplitPoint, uint64_t &stolenStart, uint64_t &stolenEnd);
 
-   void              SetPrimesInList(uint32_t primesInList) { ii_PrimesInList = primesInList; };
+   // This wakes the worker if it is waiting for work
+   void              SetStatusHasWorkToDo(void);
 
-   void              SetStatusHasWorkToDo(void) { ip_WorkerStatus->SetValueNoLock(WS_HAS_WORK_TO_DO); };
+   // This wakes the worker so that it can check if sieving is done
+   void              Wake(void);
 
    void              StartProcessing(void);
 
+   // This is executed by the thread that generates primes for a GPU worker
+   void              ProducePrimes(void);
+
    bool              IsGpuWorker(void) { return ib_GpuWorker; };
 
+   // The logical CPU (NO_CPU if not pinned) and NUMA node this worker runs on
+   int32_t           GetCpu(void) { return ii_Cpu; };
+   uint32_t          GetNode(void) { return ii_Node; };
+
 protected:
    bool              IsQuadraticResidue(uint64_t n, uint64_t p);
    uint64_t          InvMod32(uint32_t a, uint64_t p);
@@ -85,53 +191,231 @@ protected:
 
    // This function will return a boolean indicating if the CPU supports the instructions used
    // by the avx256_xxx.S assembler code which rely on the ymm registers.
+#ifdef USE_X86
    bool              CpuSupportsAvx(void) { return (__builtin_cpu_supports("avx") && __builtin_cpu_supports("fma")); };
+#else
+   bool              CpuSupportsAvx(void) { return false; };
+#endif
 
    // This function will return a boolean indicating if the CPU supports the instructions used
    // by the avx512_xxx.S assembler code which rely on the zmm registers.
+#ifdef USE_X86
    bool              CpuSupportsAvx512(void) { return (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")); };
+#else
+   bool              CpuSupportsAvx512(void) { return false; };
+#endif
+
+   // This function will return a boolean indicating if the CPU supports the instructions used
+   // by MpArithVectorIfma, which relies on the 52-bit multiply-add of AVX-512 IFMA.
+#ifdef USE_X86
+   bool              CpuSupportsAvx512Ifma(void) { return (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma")); };
+#else
+   bool              CpuSupportsAvx512Ifma(void) { return false; };
+#endif
 
    void              SetMiniChunkRange(uint64_t minPrimeForMiniChunkMode, uint64_t maxPrimeForMiniChunkMode, uint32_t chunkSize);
 
-   void              SetLargestPrimeTested(uint64_t largestPrimeTested, uint64_t primesTested) { il_LargestPrimeTested = largestPrimeTested; il_PrimesTested += primesTested; };
+   // Call this from the constructor of the worker if it builds an MpArith or MpArithVec
+   // for the primes in its list.  ik_MpContext will then be computed once for each list
+   // before TestMegaPrimeChunk() is called and the primespan_t given to TestMiniPrimeSpan()
+   // will point to it.  Use the MpArith and MpArithVector constructors that take an
+   // mpcontext_t with the index of the prime in il_PrimeList.
+   void              UseMontgomeryContext(void) { ib_UseMontgomeryContext = true; };
+
+   // Workers with loops that are templated on the number of MpArithVector lanes call
+   // UseLanes() from their constructor and GetLanes() from TestMegaPrimeChunk().  This is
+   // the value given with -j, otherwise the fastest number of lanes as determined by
+   // calibration.  While calibrating, TestMegaPrimeChunk() is called for slices of the
+   // list, so il_PrimeList and ii_PrimesInList only describe the current slice.
+   void              UseLanes(void) { ib_UseLanes = true; };
+   uint32_t          GetLanes(void) { return ii_LanesForList; };
+
+   // Workers that compute b^n mod p for every prime in the list call UsePowModKernel() from
+   // their constructor and PowModBlock() from TestMegaPrimeChunk().  The kernel is the one
+   // given with -E, otherwise AVX-512 IFMA if the CPU supports it and MpArithVector if it
+   // does not.  This calls UseMontgomeryContext() and UseLanes() as needed.
+   void              UsePowModKernel(void);
+
+   // For the PRIME_LIST_MULTIPLE primes starting at il_PrimeList[idx], set b[k] = b[k]^n mod p
+   // where n is the exponent of the plan.  Build the plan once in the constructor of the
+   // worker since the exponent is usually fixed.  Each b[k] must be less than its p or 2^52.  Workers
+   // that remove primes from the list must use MovePrime() so that the Montgomery context
+   // stays with the prime.
+   void              PowModBlock(uint32_t idx, uint64_t *b, const MpPowPlan &plan);
+
+   // This is PowModBlock() for b = 2 or b = 1/2 (mod p), which is what most runs use.  It
+   // sets r[k] = 2^n mod p, or (1/2)^n mod p if inverse is true.  Since multiplying by 2 is
+   // a doubling and dividing by 2 is a halving, only the squarings are mulmods.  Workers
+   // with a base given at runtime should check for 2 once in their constructor.
+   void              PowModBlockBase2(uint32_t idx, uint64_t *r, const MpPowPlan &plan, bool inverse);
+
+   void              MovePrime(uint32_t from, uint32_t to)
+   {
+      il_PrimeList[to] = il_PrimeList[from];
+
+      if (ik_MpContext.q != NULL)
+      {
+         ik_MpContext.q[to] = ik_MpContext.q[from];
+         ik_MpContext.one[to] = ik_MpContext.one[from];
+         ik_MpContext.r2[to] = ik_MpContext.r2[from];
+      }
+   };
+
+   // Only the worker updates its stats, so there is no need for an atomic read-modify-write.
+   // Workers also test the padding at the end of the list, so this never counts more than
+   // ii_PrimesInList primes for a list.
+   void              SetLargestPrimeTested(uint64_t largestPrimeTested, uint64_t primesTested)
+   {
+      if (primesTested > ii_PrimesLeftToCount)
+         primesTested = ii_PrimesLeftToCount;
+
+      ii_PrimesLeftToCount -= (uint32_t) primesTested;
+
+      il_PrimesTested.store(il_PrimesTested.load(std::memory_order_relaxed) + primesTested, std::memory_order_release);
+      il_LargestPrimeTested.store(largestPrimeTested, std::memory_order_release);
+   };
 
    uint32_t          ii_MyId;
+   int32_t           ii_Cpu;
+   uint32_t          ii_Node;
    bool              ib_Initialized;
    bool              ib_GpuWorker;
 
    // The actual number of primes in the chunk
    uint32_t          ii_PrimesInList;
+
+   // The number of primes in il_PrimeList including the copies of the last prime that pad
+   // it.  This is the full list for GPU workers, so their kernels use this.  For CPU workers
+   // it is ii_PrimesInList rounded up to a multiple of PRIME_LIST_MULTIPLE.
+   uint32_t          ii_PaddedPrimesInList;
    uint64_t         *il_PrimeList;
 
+   // If this is not 0, then the primes are il_PrimeBase + il_PrimeList[i], see
+   // App::GetPrimeBase()
+   __uint128_t       il_PrimeBase;
+
+   // The Montgomery context of each prime in il_PrimeList, see UseMontgomeryContext()
+   mpcontext_t       ik_MpContext;
+
    App              *ip_App;
 
-   SharedMemoryItem *ip_StatsLocker;
-   SharedMemoryItem *ip_WorkerStatus;
+   // This is only used to wake the worker when it is waiting for work.  The
+   // status itself is iws_WorkerStatus.
+   SharedMemoryItem *ip_WorkerWakeup;
 
 #ifndef WIN32
    pthread_t         ih_Thread;
 #endif
 
 private:
-   void              SetStatusWorking(void) { ip_WorkerStatus->SetValueNoLock(WS_WORKING); };
-   void              SetStatusWaitingForWork(void) { ip_WorkerStatus->SetValueNoLock(WS_WAITING_FOR_WORK); };
-   void              SetStatusStopped(void) { ip_WorkerStatus->SetValueNoLock(WS_STOPPED); };
+   void              SetStatusWorking(void) { iws_WorkerStatus.store(WS_WORKING, std::memory_order_release); };
+   void              SetStatusWaitingForWork(void);
+   void              SetStatusStopped(void);
 
+   // This will block until the App gives this worker work or until sieving is done
+   void              WaitForWork(void);
+
+   bool              FillPrimeList(uint64_t *primeList, uint32_t &primesInList);
+   uint32_t          GetPaddedPrimeCount(uint32_t primesInList);
+   bool              ClaimNextTask(void);
+   void              StartPrimeIterator(void);
+
+   // Returns false and sets the status to waiting if there is no queued range
+   bool              TakeNextPrimeRange(void);
+
+   void              TestPrimeRange(void);
+   void              TestPrimeList(void);
    void              TestWithMiniChunks(void);
 
+   void              CalibrateLanes(void);
+
+   template <size_t N>
+   void              PowModBlockMont(uint32_t idx, uint64_t *b, const MpPowPlan &plan);
+
+   template <size_t N>
+   void              PowModBlockBase2Mont(uint32_t idx, uint64_t *r, const MpPowPlan &plan, bool inverse);
+
+#ifdef USE_X86
+   void              PowModBlockIfma(uint32_t idx, uint64_t *b, const MpPowPlan &plan);
+   void              PowModBlockBase2Ifma(uint32_t idx, uint64_t *r, const MpPowPlan &plan, bool inverse);
+#endif
+
+   void              AllocateMontgomeryContext(void);
+   void              FreeMontgomeryContext(void);
+
+   void              StartProducer(void);
+   void              StopProducer(void);
+   bool              GetProducedPrimeList(void);
+
    uint64_t          ComputeOptimalWorkSize(uint64_t startTime, uint64_t endTime);
 
    // The maximum number of primes per chunk
    uint32_t          ii_MaxWorkSize;
 
+   // The number of primes that il_PrimeList can hold, excluding padding
+   uint32_t          ii_PrimeListSize;
+
+   // The primes of the current list that SetLargestPrimeTested() has not counted yet
+   uint32_t          ii_PrimesLeftToCount;
+
+   // Each worker generates its own primes for the range assigned to it by the App.  The
+   // worker only generates primes below il_ClaimedEnd.  ip_RangeLocker must be held when
+   // changing il_ClaimedEnd or il_RangeEnd after the range has been assigned.
+   primesieve::iterator ip_PrimeIterator;
+   WidePrimeIterator ip_WidePrimeIterator;
+   SharedMemoryItem *ip_RangeLocker;
+   std::atomic<uint64_t> il_RangeStart;
+   std::atomic<uint64_t> il_RangeEnd;
+   uint64_t          il_ClaimedEnd;
+   uint64_t          il_TaskSize;
+   uint64_t          il_NextPrime;
+   bool              ib_RangeWasSplit;
+
+   // The range the worker will test after the current range.  ip_RangeLocker must be held
+   // when changing these.
+   std::atomic<bool> ib_HasNextRange;
+   uint64_t          il_NextRangeStart;
+   uint64_t          il_NextRangeEnd;
+
+   // GPU workers use a separate thread to generate primes into il_NextPrimeList while the
+   // kernel is testing il_PrimeList.  ip_ProducerLocker must be held when accessing these.
+   bool              ib_UseProducer;
+   SharedMemoryItem *ip_ProducerLocker;
+   producerstatus_t  ips_ProducerStatus;
+   uint64_t         *il_NextPrimeList;
+   uint32_t          ii_NextPrimesInList;
+
    uint32_t          ii_MiniChunkSize;
    uint64_t          il_MinPrimeForMiniChunkMode;
    uint64_t          il_MaxPrimeForMiniChunkMode;
 
-   // Total number of milliseconds spent in the thread.
-   uint64_t          il_WorkerCpuUS;
-   uint64_t          il_PrimesTested;
-   uint64_t          il_LargestPrimeTested;
+   bool              ib_UseMontgomeryContext;
+
+   bool              ib_UseLanes;
+   uint32_t          ii_LanesForList;
+
+   powmodkernel_t    ipk_PowModKernel;
+
+   std::atomic<workerstatus_t> iws_WorkerStatus;
+
+   // Total number of microseconds spent in the thread.
+   std::atomic<uint64_t> il_WorkerCpuUS;
+   std::atomic<uint64_t> il_PrimesTested;
+   std::atomic<uint64_t> il_LargestPrimeTested;
+
+   uint64_t          il_PrimeGenerationUS;
+
+   // When this worker last finished a range, 0 if it hasn't finished one yet
+   uint64_t          il_ReadyUS;
+   uint64_t          il_DispatchCount;
+   uint64_t          il_DispatchLatencyUS;
+   uint64_t          il_MaxDispatchLatencyUS;
+
+   kernelstats_t     ik_MegaChunkStats;
+   kernelstats_t     ik_MiniChunkStats;
+
+   // The counters and timers updated by this worker thread, see Counters.h
+   counterslot_t     ic_Counters;
 };
 
 #endif
@@ -158,11 +158,11 @@ void CullenWoodallApp::ValidateOptions(void)
 
       il_TermCount = ii_MaxN - ii_MinN + 1;
 
-      iv_CullenTerms.resize(il_TermCount);
-      std::fill(iv_CullenTerms.begin(), iv_CullenTerms.end(), false);
+      iv_CullenTerms.Resize(il_TermCount);
+      iv_CullenTerms.Fill(false);
 
-      iv_WoodallTerms.resize(il_TermCount);
-      std::fill(iv_WoodallTerms.begin(), iv_WoodallTerms.end(), false);
+      iv_WoodallTerms.Resize(il_TermCount);
+      iv_WoodallTerms.Fill(false);
 
       il_TermCount = 0;
 
@@ -187,11 +187,11 @@ void CullenWoodallApp::ValidateOptions(void)
 
       il_TermCount = ii_MaxN - ii_MinN + 1;
 
-      iv_CullenTerms.resize(il_TermCount);
-      std::fill(iv_CullenTerms.begin(), iv_CullenTerms.end(), false);
+      iv_CullenTerms.Resize(il_TermCount);
+      iv_CullenTerms.Fill(false);
 
-      iv_WoodallTerms.resize(il_TermCount);
-      std::fill(iv_WoodallTerms.begin(), iv_WoodallTerms.end(), false);
+      iv_WoodallTerms.Resize(il_TermCount);
+      iv_WoodallTerms.Fill(false);
 
       SetInitialTerms();
 
@@ -293,10 +293,10 @@ void CullenWoodallApp::ProcessInputTermsFile(bool haveBitMap)
       if (haveBitMap)
       {
          if (c == +1)
-            iv_CullenTerms[BIT(n)] = true;
+            iv_CullenTerms.Set(BIT(n));
 
          if (c == -1)
-            iv_WoodallTerms[BIT(n)] = true;
+            iv_WoodallTerms.Set(BIT(n));
 
          il_TermCount++;
       }
@@ -346,14 +346,14 @@ bool CullenWoodallApp::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (c == +1 && iv_CullenTerms[bit])
    {
-      iv_CullenTerms[bit] = false;
+      iv_CullenTerms.Clear(bit);
       il_TermCount--;
       return true;
    }
 
    if (c == -1 && iv_WoodallTerms[bit])
    {
-      iv_WoodallTerms[bit] = false;
+      iv_WoodallTerms.Clear(bit);
       il_TermCount--;
       return true;
    }
@@ -442,13 +442,13 @@ void  CullenWoodallApp::SetInitialTerms(void)
       if (ib_Cullen)
       {
          il_TermCount++;
-         iv_CullenTerms[BIT(n)] = true;
+         iv_CullenTerms.Set(BIT(n));
       }
 
       if (ib_Woodall)
       {
          il_TermCount++;
-         iv_WoodallTerms[BIT(n)] = true;
+         iv_WoodallTerms.Set(BIT(n));
       }
    }
 
@@ -468,14 +468,14 @@ void  CullenWoodallApp::EliminateGfnAndMersenneTerms(void)
       if (iv_CullenTerms[bit] && IsGfnOrMersenneForm(n, ii_Base, +1))
       {
          il_TermCount--;
-         iv_CullenTerms[bit] = false;
+         iv_CullenTerms.Clear(bit);
          removedCount++;
       }
 
       if (iv_WoodallTerms[bit] && IsGfnOrMersenneForm(n, ii_Base, -1))
       {
          il_TermCount--;
-         iv_WoodallTerms[bit] = false;
+         iv_WoodallTerms.Clear(bit);
          removedCount++;
       }
    }
@@ -544,7 +544,7 @@ bool  CullenWoodallApp::CheckAlgebraicFactor(uint32_t n, int32_t c, const char *
 
    if (c == +1 && iv_CullenTerms[bit])
    {
-      iv_CullenTerms[bit] = false;
+      iv_CullenTerms.Clear(bit);
       removedTerm = true;
 
       LogFactor(factor, "%u*%u^%u+1", n, ii_Base, n);
@@ -555,7 +555,7 @@ bool  CullenWoodallApp::CheckAlgebraicFactor(uint32_t n, int32_t c, const char *
 
    if (c == -1 && iv_WoodallTerms[bit])
    {
-      iv_WoodallTerms[bit] = false;
+      iv_WoodallTerms.Clear(bit);
       removedTerm = true;
 
       LogFactor(factor, "%u*%u^%u-1", n, ii_Base, n);
@@ -623,7 +623,7 @@ bool CullenWoodallApp::ReportFactor(uint64_t theFactor, uint32_t n, int32_t c)
 
    if (ib_Cullen && c == +1 && iv_CullenTerms[bit])
    {
-      iv_CullenTerms[bit] = false;
+      iv_CullenTerms.Clear(bit);
       il_TermCount--;
       il_FactorCount++;
       removedTerm = true;
@@ -634,7 +634,7 @@ bool CullenWoodallApp::ReportFactor(uint64_t theFactor, uint32_t n, int32_t c)
 
    if (ib_Woodall && c == -1 && iv_WoodallTerms[bit])
    {
-      iv_WoodallTerms[bit] = false;
+      iv_WoodallTerms.Clear(bit);
       il_TermCount--;
       il_FactorCount++;
       removedTerm = true;
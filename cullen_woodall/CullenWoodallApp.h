@@ -76,8 +76,8 @@ private:
    void              VerifyFactor(uint64_t theFactor, uint32_t n, int32_t c);
 
    format_t          it_Format;
-   std::vector<bool> iv_CullenTerms;
-   std::vector<bool> iv_WoodallTerms;
+   TermBitmap        iv_CullenTerms;
+   TermBitmap        iv_WoodallTerms;
 
    uint32_t          ii_Base;
    uint32_t          ii_MinN;
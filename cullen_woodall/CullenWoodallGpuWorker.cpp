@@ -95,7 +95,7 @@ void  CullenWoodallGpuWorker::TestMegaPrimeChunk(void)
 
       memcpy(ii_KernelTerms, &ii_Terms[idx], ii_GroupSize * sizeof(uint32_t));
 
-      ip_Kernel->Execute(ii_PrimesInList);
+      ip_Kernel->Execute(ii_PaddedPrimesInList);
 
       for (uint32_t ii=0; ii<ii_FactorCount[0]; ii++)
       {
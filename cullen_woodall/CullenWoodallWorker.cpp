@@ -11,9 +11,10 @@
 
 #include "CullenWoodallWorker.h"
 
-#ifdef USE_X86
 #include "../x86_asm/fpu-asm-x86.h"
-#include "../x86_asm/avx-asm-x86.h"
+
+#ifdef USE_X86
+#include "../x86_asm/avx512-asm-x86.h"
 #endif
 
 // This is for building a list of even powers for b
@@ -39,12 +40,16 @@ CullenWoodallWorker::CullenWoodallWorker(uint32_t myId, App *theApp) : Worker(my
    ib_Initialized = true;
 
 #ifdef USE_X86
+   ib_UseAvx512 = CpuSupportsAvx512();
+
    if (CpuSupportsAvx())
    {
+      uint32_t chunkSize = (ib_UseAvx512 ? AVX512_ARRAY_SIZE : AVX_ARRAY_SIZE);
+
       if (ii_Base < ii_MaxN)
-         SetMiniChunkRange(ii_MaxN + 1, PMAX_MAX_52BIT, AVX_ARRAY_SIZE);
+         SetMiniChunkRange(ii_MaxN + 1, PMAX_MAX_52BIT, chunkSize);
       else
-         SetMiniChunkRange(ii_Base + 1, PMAX_MAX_52BIT, AVX_ARRAY_SIZE);
+         SetMiniChunkRange(ii_Base + 1, PMAX_MAX_52BIT, chunkSize);
    }
 #endif
 }
@@ -99,10 +104,18 @@ void  CullenWoodallWorker::TestMiniPrimeChunk(uint64_t *miniPrimeChunk)
    {
       ip_CullenWoodallApp->GetTerms(ii_Terms, ii_MaxTermCount, ii_MaxTermCount);
 
-      il_NextTermsBuild = (miniPrimeChunk[AVX_ARRAY_SIZE-1] << 1);
+      il_NextTermsBuild = (miniPrimeChunk[(ib_UseAvx512 ? AVX512_ARRAY_SIZE : AVX_ARRAY_SIZE) - 1] << 1);
    }
 
-   TestPrimesAVX(miniPrimeChunk);
+   if (ib_UseAvx512)
+      TestPrimesAVX<AVX512_ARRAY_SIZE>(miniPrimeChunk);
+   else
+      TestPrimesAVX<AVX_ARRAY_SIZE>(miniPrimeChunk);
+}
+#else
+void  CullenWoodallWorker::TestMiniPrimeChunk(uint64_t *miniPrimeChunk)
+{
+   FatalError("CullenWoodallWorker::TestMiniPrimeChunk not implemented");
 }
 #endif
 
@@ -332,30 +345,31 @@ void  CullenWoodallWorker::TestLargePrimesFPU(uint64_t *ps)
 }
 
 #ifdef USE_X86
-// Same as TestLargePrimesFPU, but using AVX
+// Same as TestLargePrimesFPU, but using AVX to test N primes at a time
+template <uint32_t N>
 void  CullenWoodallWorker::TestPrimesAVX(uint64_t *ps)
 {
    uint32_t theN, prevN;
    uint32_t termIndex;
    uint32_t power;
-   double __attribute__((aligned(32))) powers[MAX_POWERS+1][AVX_ARRAY_SIZE];
-   double __attribute__((aligned(32))) dps[AVX_ARRAY_SIZE];
-   double __attribute__((aligned(32))) reciprocals[AVX_ARRAY_SIZE];
-   double __attribute__((aligned(32))) multinvs[AVX_ARRAY_SIZE];
+   double __attribute__((aligned(64))) powers[MAX_POWERS+1][N];
+   double __attribute__((aligned(64))) dps[N];
+   double __attribute__((aligned(64))) reciprocals[N];
+   double __attribute__((aligned(64))) multinvs[N];
 
    // compute the inverse of b (mod p)
-   for (int i=0; i<AVX_ARRAY_SIZE; i++)
+   for (uint32_t i=0; i<N; i++)
    {
       dps[i] = (double) ps[i];
       multinvs[i] = (double) ComputeMultiplicativeInverse(ii_Base, ps[i]);
       powers[1][i] = (double) ii_Base;
    }
 
-   avx_compute_reciprocal(dps, reciprocals);
+   AvxKernel<N>::compute_reciprocal(dps, reciprocals);
 
-   avx_powmod(multinvs, ii_Terms[0], dps, reciprocals);
+   AvxKernel<N>::powmod(multinvs, ii_Terms[0], dps, reciprocals);
 
-   CheckAVXResult(ii_Terms[0], ps, dps);
+   CheckAVXResult<N>(ii_Terms[0], ps, dps);
 
    // Multiply successive terms by a (mod p)
    for (uint32_t idx=2; idx<MAX_POWERS+1; idx++)
@@ -367,21 +381,21 @@ void  CullenWoodallWorker::TestPrimesAVX(uint64_t *ps)
          if (idx & 1)
             continue;
 
-         avx_set_16a(powers[idx-2]);
-         avx_set_16b(powers[2]);
-         avx_mulmod(dps, reciprocals);
-         avx_get_16a(powers[idx]);
+         AvxKernel<N>::set_na(powers[idx-2]);
+         AvxKernel<N>::set_nb(powers[2]);
+         AvxKernel<N>::mulmod(dps, reciprocals);
+         AvxKernel<N>::get_na(powers[idx]);
       }
       else
       {
-         avx_set_16a(powers[idx-1]);
-         avx_set_16b(powers[1]);
-         avx_mulmod(dps, reciprocals);
-         avx_get_16a(powers[idx]);
+         AvxKernel<N>::set_na(powers[idx-1]);
+         AvxKernel<N>::set_nb(powers[1]);
+         AvxKernel<N>::mulmod(dps, reciprocals);
+         AvxKernel<N>::get_na(powers[idx]);
       }
    }
 
-   avx_set_16a(multinvs);
+   AvxKernel<N>::set_na(multinvs);
 
    prevN = ii_Terms[0];
 
@@ -397,52 +411,54 @@ void  CullenWoodallWorker::TestPrimesAVX(uint64_t *ps)
       // chunks.  At worst this might cause an extra mulmod or two every once in a while.
       while (power > MAX_POWERS)
       {
-         avx_set_16b(powers[MAX_POWERS]);
-         avx_mulmod(dps, reciprocals);
+         AvxKernel<N>::set_nb(powers[MAX_POWERS]);
+         AvxKernel<N>::mulmod(dps, reciprocals);
          power -= MAX_POWERS;
       }
 
-      avx_set_16b(powers[power]);
-      avx_mulmod(dps, reciprocals);
+      AvxKernel<N>::set_nb(powers[power]);
+      AvxKernel<N>::mulmod(dps, reciprocals);
 
       // At this point we have computed (1/b)^n (mod p).
       // If (1/b)^n (mod p) == n then we have a Woodall factor.
       // If (1/b)^n (mod p) == thePrime - n then we have a Cullen factor.
-      CheckAVXResult(theN, ps, dps);
+      CheckAVXResult<N>(theN, ps, dps);
 
       prevN = theN;
       termIndex++;
    };
 }
 
+template <uint32_t N>
 void  CullenWoodallWorker::CheckAVXResult(uint32_t theN, uint64_t *ps, double *dps)
 {
    uint32_t idx;
-   double __attribute__((aligned(32))) comparator[1];
-   double __attribute__((aligned(32))) rems[AVX_ARRAY_SIZE];
+   double __attribute__((aligned(64))) comparator[1];
+   double __attribute__((aligned(64))) rems[N];
 
    comparator[0] = (double) theN;
 
-   // Only go further if one or more of the 16 primes yielded a factor for this n
-   if (avx_pos_compare_1v(comparator) > 0)
+   // Only go further if one or more of the N primes yielded a factor for this n
+   if (AvxKernel<N>::pos_compare_1v(comparator) > 0)
    {
-      avx_get_16a(rems);
+      AvxKernel<N>::get_na(rems);
 
-      for (idx=0; idx<AVX_ARRAY_SIZE; idx++)
+      for (idx=0; idx<N; idx++)
          if (rems[idx] == comparator[0])
             ip_CullenWoodallApp->ReportFactor(ps[idx], theN, -1);
    }
 
-   // Only go further if one or more of the 16 primes yielded a factor for this n
-   if (avx_neg_compare_1v(comparator, dps))
+   // Only go further if one or more of the N primes yielded a factor for this n
+   if (AvxKernel<N>::neg_compare_1v(comparator, dps))
    {
-      avx_get_16a(rems);
+      AvxKernel<N>::get_na(rems);
 
-      for (idx=0; idx<AVX_ARRAY_SIZE; idx++)
+      for (idx=0; idx<N; idx++)
          if (rems[idx] == dps[idx] - comparator[0])
             ip_CullenWoodallApp->ReportFactor(ps[idx], theN, +1);
    }
 }
+#endif
 
 // Build a list of powers for a from a^0 thru a^n for all even n up to count.
 void  CullenWoodallWorker::BuildListOfPowers(uint64_t a, uint64_t p, uint32_t count, uint64_t *powers)
@@ -460,7 +476,6 @@ void  CullenWoodallWorker::BuildListOfPowers(uint64_t a, uint64_t p, uint32_t co
 
    fpu_pop();
 }
-#endif
 
 uint64_t CullenWoodallWorker::ComputeMultiplicativeInverse(uint64_t a, uint64_t p)
 {
@@ -29,8 +29,13 @@ private:
    void              TestLargePrimesFPU(uint64_t *ps);
 
 #ifdef USE_X86
+   // N is AVX_ARRAY_SIZE for the ymm routines or AVX512_ARRAY_SIZE for the zmm routines
+   template <uint32_t N>
    void              TestPrimesAVX(uint64_t *ps);
+   template <uint32_t N>
    void              CheckAVXResult(uint32_t theN, uint64_t *ps, double *dps);
+
+   bool              ib_UseAvx512;
 #endif
 
    void              BuildListOfPowers(uint64_t a, uint64_t p, uint32_t count, uint64_t *powers);
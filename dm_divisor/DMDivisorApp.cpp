@@ -16,6 +16,7 @@
 #include "../core/Clock.h"
 #include "DMDivisorApp.h"
 #include "DMDivisorWorker.h"
+#include "../core/MpArith128.h"
 #include "../x86_asm/fpu-asm-x86.h"
 #include "../x86_asm_ext/asm-ext-x86.h"
 
@@ -62,6 +63,8 @@ DMDivisorApp::DMDivisorApp() : FactorApp()
    SetLogFileName("dmdsieve.log");
 
    SetAppMinPrime(3);
+   AllowWidePrimes();
+
    il_MinKOriginal = il_MinK = 0;
    il_MaxKOriginal = il_MaxK = 0;
    ii_N    = 0;
@@ -71,7 +74,7 @@ DMDivisorApp::DMDivisorApp() : FactorApp()
    il_TotalTerms = 0;
    il_TotalTermsEvaluated = 0;
 
-   iv_MMPTerms.clear();
+   iv_MMPTerms.Free();
 }
 
 void DMDivisorApp::Help(void)
@@ -157,8 +160,8 @@ void DMDivisorApp::ValidateOptions(void)
 
       ProcessInputTermsFile(false);
 
-      iv_MMPTerms.resize(il_MaxK - il_MinK + 1);
-      std::fill(iv_MMPTerms.begin(), iv_MMPTerms.end(), false);
+      iv_MMPTerms.Resize(il_MaxK - il_MinK + 1);
+      iv_MMPTerms.Fill(false);
 
       ProcessInputTermsFile(true);
    }
@@ -196,7 +199,7 @@ void DMDivisorApp::ValidateOptions(void)
    if (ii_N < 13)
      FatalError("MM%u is a known prime", ii_N);
 
-   if (ib_TestTerms && il_MaxPrime == il_AppMaxPrime)
+   if (ib_TestTerms && il_MaxPrime == il_AppMaxPrime && il_WideMaxPrime == 0)
       FatalError("must specify -P when testing terms");
 
    FactorApp::ParentValidateOptions();
@@ -207,8 +210,9 @@ void DMDivisorApp::ValidateOptions(void)
 
    // Allow only one worker to do work when processing small primes.  This allows us to avoid
    // locking when factors are reported, which significantly hurts performance as most terms
-   // will be removed due to small primes.
-   SetMaxPrimeForSingleWorker(10000);
+   // will be removed due to small primes.  This is not needed above 2^62.
+   if (il_PrimeBase == 0)
+      SetMaxPrimeForSingleWorker(10000);
 }
 
 void  DMDivisorApp::PreSieveHook(void)
@@ -222,22 +226,22 @@ void  DMDivisorApp::PreSieveHook(void)
    {
       il_TermCount = il_TotalTerms;
 
-      iv_MMPTerms.resize(il_TermCount);
-      std::fill(iv_MMPTerms.begin(), iv_MMPTerms.end(), true);
+      iv_MMPTerms.Resize(il_TermCount);
+      iv_MMPTerms.Fill(true);
 
       return;
    }
 
    if (il_MinKOriginal == 0)
    {
-      iv_MMPTerms.resize(il_KPerChunk);
+      iv_MMPTerms.Resize(il_KPerChunk);
 
       il_MinKOriginal = il_MinK;
       il_MaxKOriginal = il_MaxK;
       il_MinKInChunk = il_MinK;
    }
 
-   std::fill(iv_MMPTerms.begin(), iv_MMPTerms.end(), true);
+   iv_MMPTerms.Fill(true);
 
    // We want il_MinK and il_MaxK to be set to the correct range
    // of k before we start sieving.
@@ -289,8 +293,10 @@ void DMDivisorApp::ProcessInputTermsFile(bool haveBitMap)
 {
    FILE    *fPtr = fopen(is_InputTermsFileName.c_str(), "r");
    char     buffer[1000];
+   char     lastPrimeStr[50];
    uint32_t n, bit;
-   uint64_t k, lastPrime = 0;
+   uint64_t k;
+   __uint128_t lastPrime = 0;
 
    if (!fPtr)
       FatalError("Unable to open input file %s", is_InputTermsFileName.c_str());
@@ -303,14 +309,15 @@ void DMDivisorApp::ProcessInputTermsFile(bool haveBitMap)
 
    if (!memcmp(buffer, "ABCD ", 5))
    {
-      if (sscanf(buffer, "ABCD 2*$a*(2^%u-1)+1 [%" SCNu64"] // Sieved to %" SCNu64"", &n, &k, &lastPrime) != 3)
+      if (sscanf(buffer, "ABCD 2*$a*(2^%u-1)+1 [%" SCNu64"] // Sieved to %49[0-9]", &n, &k, lastPrimeStr) != 3 ||
+          Parser::Parse(lastPrimeStr, 0, PMAX_MAX_WIDE-1, lastPrime) != P_SUCCESS)
          FatalError("Line 1 is not a valid ABCD line in input file %s", is_InputTermsFileName.c_str());
 
       ii_N = n;
 
       if (haveBitMap)
       {
-         iv_MMPTerms[k-il_MinK] = true;
+         iv_MMPTerms.Set(k-il_MinK);
          il_TermCount++;
       }
       else
@@ -318,7 +325,8 @@ void DMDivisorApp::ProcessInputTermsFile(bool haveBitMap)
    }
    else if (!memcmp(buffer, "ABC ", 4))
    {
-      if (sscanf(buffer, "ABC 2*$a*(2^%u-1)+1 // Sieved to %" SCNu64"", &n, &lastPrime) != 2)
+      if (sscanf(buffer, "ABC 2*$a*(2^%u-1)+1 // Sieved to %49[0-9]", &n, lastPrimeStr) != 2 ||
+          Parser::Parse(lastPrimeStr, 0, PMAX_MAX_WIDE-1, lastPrime) != P_SUCCESS)
          FatalError("Line 1 is not a valid ABCD line in input file %s", is_InputTermsFileName.c_str());
 
       ii_N = n;
@@ -326,7 +334,7 @@ void DMDivisorApp::ProcessInputTermsFile(bool haveBitMap)
    else
       FatalError("Input file %s has unknown format", is_InputTermsFileName.c_str());
 
-   SetMinPrime(lastPrime);
+   SetWideMinPrime(lastPrime);
 
    while (fgets(buffer, sizeof(buffer), fPtr) != NULL)
    {
@@ -340,7 +348,7 @@ void DMDivisorApp::ProcessInputTermsFile(bool haveBitMap)
       {
          bit = BIT(k);
 
-         iv_MMPTerms[bit] = true;
+         iv_MMPTerms.Set(bit);
          il_TermCount++;
       }
       else
@@ -374,7 +382,37 @@ bool DMDivisorApp::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (iv_MMPTerms[bit])
    {
-      iv_MMPTerms[bit] = false;
+      iv_MMPTerms.Clear(bit);
+      il_TermCount--;
+
+      return true;
+   }
+
+   return false;
+}
+
+bool DMDivisorApp::ApplyWideFactor(__uint128_t theFactor, const char *term)
+{
+   uint64_t k;
+   uint32_t n;
+
+   if (sscanf(term, "2*%" SCNu64"*(2^%u-1)+1", &k, &n) != 2)
+      FatalError("Could not parse term %s", term);
+
+   if (n != ii_N)
+      FatalError("Expected n %u in factor but found %d", ii_N, n);
+
+   if (k < il_MinK || k > il_MaxK)
+      return false;
+
+   VerifyWideFactor(theFactor, k);
+
+   uint64_t bit = k - il_MinK;
+
+   // No locking is needed because the Workers aren't running yet
+   if (iv_MMPTerms[bit])
+   {
+      iv_MMPTerms.Clear(bit);
       il_TermCount--;
 
       return true;
@@ -385,6 +423,7 @@ bool DMDivisorApp::ApplyFactor(uint64_t theFactor, const char *term)
 
 void DMDivisorApp::WriteOutputTermsFile(uint64_t largestPrime)
 {
+   char     largestPrimeStr[50];
    uint64_t termsCounted = 0;
    uint64_t k;
    uint64_t bit;
@@ -415,7 +454,9 @@ void DMDivisorApp::WriteOutputTermsFile(uint64_t largestPrime)
 
    ip_FactorAppLock->Lock();
 
-   fprintf(termsFile, "ABC 2*$a*(2^%u-1)+1 // Sieved to %" SCNu64"\n", ii_N, largestPrime);
+   ConvertPrimeToString(largestPrime, largestPrimeStr);
+
+   fprintf(termsFile, "ABC 2*$a*(2^%u-1)+1 // Sieved to %s\n", ii_N, largestPrimeStr);
    //fprintf(termsFile, "ABCD 2*$a*(2^%u-1)+1 [%" SCNu64"] // Sieved to %" SCNu64"\n", ii_N, k, largestPrime);
 
    for (k=il_MinK; k<=il_MaxK; k++)
@@ -472,7 +513,7 @@ bool  DMDivisorApp::ReportFactor(uint64_t theFactor, uint64_t k, bool verifyFact
       if (verifyFactor)
          VerifyFactor(theFactor, k);
 
-      iv_MMPTerms[bit] = false;
+      iv_MMPTerms.Clear(bit);
       removedTerm = true;
 
       sprintf(kStr, "%" PRIu64"", k);
@@ -489,6 +530,39 @@ bool  DMDivisorApp::ReportFactor(uint64_t theFactor, uint64_t k, bool verifyFact
    return removedTerm;
 }
 
+// The workers call this when App::GetPrimeBase() is not 0, so theFactor > il_MaxK
+bool  DMDivisorApp::ReportWideFactor(__uint128_t theFactor, uint64_t k)
+{
+   bool     removedTerm = false;
+   char     kStr[50];
+
+   if (k < il_MinK || k > il_MaxK)
+      return false;
+
+   ip_FactorAppLock->Lock();
+
+   uint64_t bit = BIT(k);
+
+   if (iv_MMPTerms[bit])
+   {
+      VerifyWideFactor(theFactor, k);
+
+      iv_MMPTerms.Clear(bit);
+      removedTerm = true;
+
+      sprintf(kStr, "%" PRIu64"", k);
+
+      LogWideFactor(theFactor, "2*%s*(2^%u-1)+1", kStr, ii_N);
+
+      il_FactorCount++;
+      il_TermCount--;
+   }
+
+   ip_FactorAppLock->Release();
+
+   return removedTerm;
+}
+
 void  DMDivisorApp::TestRemainingTerms(void)
 {
    time_t   lastCheckPointTime = time(NULL);
@@ -811,3 +885,23 @@ void  DMDivisorApp::VerifyFactor(uint64_t theFactor, uint64_t k)
 
    FatalError("Invalid factor: 2*%" PRIu64"*(2^%u-1)+1 mod %" PRIu64" = %" PRIu64"", k, ii_N, theFactor, rem);
 }
+
+void  DMDivisorApp::VerifyWideFactor(__uint128_t theFactor, uint64_t k)
+{
+   MpArith128 mp(theFactor);
+
+   // 2*k*(2^n-1)+1
+   MpRes128 res = mp.sub(mp.pow(mp.add(mp.one(), mp.one()), ii_N), mp.one());
+
+   res = mp.mul(res, mp.nToRes(k));
+   res = mp.add(mp.add(res, res), mp.one());
+
+   if (res == mp.zero())
+      return;
+
+   char  factorStr[50];
+
+   ConvertWideNumberToString(theFactor, factorStr);
+
+   FatalError("Invalid factor: 2*%" PRIu64"*(2^%u-1)+1 mod %s != 0", k, ii_N, factorStr);
+}
@@ -29,6 +29,7 @@ public:
    parse_t           ParseOption(int opt, char *arg, const char *source);
    void              ValidateOptions(void);
    bool              ApplyFactor(uint64_t theFactor, const char *term);
+   bool              ApplyWideFactor(__uint128_t theFactor, const char *term);
    void              GetExtraTextForSieveStartedMessage(char *extraText);
 
    uint64_t          GetMinK(void) { return il_MinK; };
@@ -36,6 +37,7 @@ public:
    uint32_t          GetN(void) { return ii_N; };
 
    bool              ReportFactor(uint64_t theFactor, uint64_t k, bool verifyFactor);
+   bool              ReportWideFactor(__uint128_t theFactor, uint64_t k);
 
 protected:
    void              PreSieveHook(void);
@@ -54,8 +56,9 @@ private:
    bool              IsDoubleMersenneDivisor(uint64_t k);
    void              CheckRedc(mp_limb_t *xp, uint32_t xn, uint32_t b, uint64_t k);
    void              VerifyFactor(uint64_t theFactor, uint64_t k);
+   void              VerifyWideFactor(__uint128_t theFactor, uint64_t k);
 
-   std::vector<bool> iv_MMPTerms;
+   TermBitmap        iv_MMPTerms;
 
    std::string       is_InputFileName;
    std::string       is_OutputFileName;
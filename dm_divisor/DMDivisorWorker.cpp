@@ -10,7 +10,7 @@
 #include <stdint.h>
 
 #include "DMDivisorWorker.h"
-#include "../x86_asm/fpu-asm-x86.h"
+#include "../core/MpArith128.h"
 
 DMDivisorWorker::DMDivisorWorker(uint32_t myId, App *theApp) : Worker(myId, theApp)
 {
@@ -19,6 +19,11 @@ DMDivisorWorker::DMDivisorWorker(uint32_t myId, App *theApp) : Worker(myId, theA
    il_MinK = ip_DMDivisorApp->GetMinK();
    il_MaxK = ip_DMDivisorApp->GetMaxK();
    ii_N = ip_DMDivisorApp->GetN();
+   ik_NPlan = MpPowPlan(ii_N);
+
+   // The kernels of PowModBlock() are only for primes below 2^62
+   if (il_PrimeBase == 0)
+      UsePowModKernel();
 
    // The thread can't start until initialization is done
    ib_Initialized = true;
@@ -30,72 +35,90 @@ void  DMDivisorWorker::CleanUp(void)
 
 void  DMDivisorWorker::TestMegaPrimeChunk(void)
 {
-   uint64_t k1, k2, k3, k4;
-   uint64_t bs[4], ps[4];
+   uint64_t k, p;
+   uint64_t bs[PRIME_LIST_MULTIPLE];
    uint64_t maxPrime = ip_App->GetMaxPrime();
 
-   for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx+=4)
+   if (il_PrimeBase != 0)
    {
-      ps[0] = il_PrimeList[pIdx+0];
-      ps[1] = il_PrimeList[pIdx+1];
-      ps[2] = il_PrimeList[pIdx+2];
-      ps[3] = il_PrimeList[pIdx+3];
-
-      bs[0] = bs[1] = bs[2] = bs[3] = 2;
+      TestWidePrimes();
+      return;
+   }
 
-      fpu_powmod_4b_1n_4p(bs, ii_N, ps);
+   for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx+=PRIME_LIST_MULTIPLE)
+   {
+      PowModBlockBase2(pIdx, bs, ik_NPlan, false);
 
-      // Now bs = 2^exp-1 (mod p)
-      bs[0]--;
-      bs[1]--;
-      bs[2]--;
-      bs[3]--;
+      for (uint32_t j=0; j<PRIME_LIST_MULTIPLE; j++)
+      {
+         p = il_PrimeList[pIdx+j];
 
-      // We are looking for p such that 2*k*bs+1 (mod p) = 0
-      k1 = InvMod64(bs[0], ps[0]);
-      k2 = InvMod64(bs[1], ps[1]);
-      k3 = InvMod64(bs[2], ps[2]);
-      k4 = InvMod64(bs[3], ps[3]);
+         // Now bs = 2^exp-1 (mod p)
+         // We are looking for p such that 2*k*bs+1 (mod p) = 0
+         k = InvMod64(bs[j] - 1, p);
 
-      // 2*k*bs+1 = 0 (mod p) --> 2*k = -invbs (mod p)
+         // 2*k*bs+1 = 0 (mod p) --> 2*k = -invbs (mod p)
 
-      // Now ensure that invbs is positive
-      k1 = ps[0] - k1;
-      k2 = ps[1] - k2;
-      k3 = ps[2] - k3;
-      k4 = ps[3] - k4;
+         // Now ensure that invbs is positive
+         k = p - k;
 
-      // We need invbs to be even so that we can divide by 2
-      if (k1 & 1) k1 += ps[0];
-      if (k2 & 1) k2 += ps[1];
-      if (k3 & 1) k3 += ps[2];
-      if (k4 & 1) k4 += ps[3];
+         // We need invbs to be even so that we can divide by 2
+         if (k & 1) k += p;
 
-      k1 >>= 1;
-      k2 >>= 1;
-      k3 >>= 1;
-      k4 >>= 1;
+         k >>= 1;
 
-      // We have now solved for k
+         // We have now solved for k
+         if (k > il_MaxK)
+            continue;
 
-      if (ps[0] <= il_MaxK)
-      {
-         if (k1 <= il_MaxK) RemoveTermsSmallPrime(ps[0], k1);
-         if (k2 <= il_MaxK) RemoveTermsSmallPrime(ps[1], k2);
-         if (k3 <= il_MaxK) RemoveTermsSmallPrime(ps[2], k3);
-         if (k4 <= il_MaxK) RemoveTermsSmallPrime(ps[3], k4);
+         if (p <= il_MaxK)
+            RemoveTermsSmallPrime(p, k);
+         else
+            RemoveTermsBigPrime(p, k);
       }
-      else
+
+      SetLargestPrimeTested(il_PrimeList[pIdx+PRIME_LIST_MULTIPLE-1], PRIME_LIST_MULTIPLE);
+
+      if (il_PrimeList[pIdx+PRIME_LIST_MULTIPLE-1] >= maxPrime)
+         break;
+   }
+}
+
+// The primes are il_PrimeBase + il_PrimeList[i].  Since they are larger than il_MaxK,
+// each prime can remove at most one term.
+void  DMDivisorWorker::TestWidePrimes(void)
+{
+   __uint128_t k, p;
+   uint64_t maxPrime = ip_App->GetMaxPrime();
+
+   for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx+=PRIME_LIST_MULTIPLE)
+   {
+      for (uint32_t j=0; j<PRIME_LIST_MULTIPLE; j++)
       {
-         if (k1 <= il_MaxK) RemoveTermsBigPrime(ps[0], k1);
-         if (k2 <= il_MaxK) RemoveTermsBigPrime(ps[1], k2);
-         if (k3 <= il_MaxK) RemoveTermsBigPrime(ps[2], k3);
-         if (k4 <= il_MaxK) RemoveTermsBigPrime(ps[3], k4);
+         p = il_PrimeBase + il_PrimeList[pIdx+j];
+
+         MpArith128 mp(p);
+
+         // bs = 2^n-1 (mod p)
+         __uint128_t bs = mp.resToN(mp.sub(mp.pow(mp.add(mp.one(), mp.one()), ik_NPlan), mp.one()));
+
+         // 2*k*bs+1 = 0 (mod p) --> k = -1/(2*bs) (mod p)
+         k = mp.invmod(bs << 1);
+
+         if (k == 0)
+            continue;
+
+         k = p - k;
+
+         if (k < il_MinK || k > il_MaxK)
+            continue;
+
+         ip_DMDivisorApp->ReportWideFactor(p, (uint64_t) k);
       }
 
-      SetLargestPrimeTested(ps[3], 4);
+      SetLargestPrimeTested(il_PrimeList[pIdx+PRIME_LIST_MULTIPLE-1], PRIME_LIST_MULTIPLE);
 
-      if (ps[3] >= maxPrime)
+      if (il_PrimeList[pIdx+PRIME_LIST_MULTIPLE-1] >= maxPrime)
          break;
    }
 }
@@ -28,6 +28,7 @@ public:
 protected:
 
 private:
+   void              TestWidePrimes(void);
    void              RemoveTermsSmallPrime(uint64_t prime, uint64_t k);
    void              RemoveTermsBigPrime(uint64_t prime, uint64_t k);
 
@@ -36,6 +37,7 @@ private:
    uint64_t          il_MinK;
    uint64_t          il_MaxK;
    uint32_t          ii_N;
+   MpPowPlan         ik_NPlan;
 };
 
 #endif
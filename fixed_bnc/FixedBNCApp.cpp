@@ -15,7 +15,7 @@
 #include "FixedBNCWorker.h"
 
 #define APP_NAME        "fbncsieve"
-#define APP_VERSION     "1.4"
+#define APP_VERSION     "1.5"
 
 #define BIT(k)          ((k) - il_MinK)
 
@@ -119,8 +119,8 @@ void FixedBNCApp::ValidateOptions(void)
    {
       ProcessInputTermsFile(false);
 
-      iv_Terms.resize(il_MaxK - il_MinK + 1);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), false);
+      iv_Terms.Resize(il_MaxK - il_MinK + 1);
+      iv_Terms.Fill(false);
 
       ProcessInputTermsFile(true);
 
@@ -137,7 +137,7 @@ void FixedBNCApp::ValidateOptions(void)
             if (iv_Terms[BIT(k)])
             {
                il_TermCount--;
-               iv_Terms[BIT(k)] = false;
+               iv_Terms.Clear(BIT(k));
             }
          }
       }
@@ -170,8 +170,8 @@ void FixedBNCApp::ValidateOptions(void)
 
       il_TermCount = il_MaxK - il_MinK + 1;
 
-      iv_Terms.resize(il_MaxK - il_MinK + 1);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), true);
+      iv_Terms.Resize(il_MaxK - il_MinK + 1);
+      iv_Terms.Fill(true);
 
       if (ib_Remove)
       {
@@ -184,7 +184,7 @@ void FixedBNCApp::ValidateOptions(void)
          for ( ; k<=il_MaxK; k+=ii_Base)
          {
             il_TermCount--;
-            iv_Terms[BIT(k)] = false;
+            iv_Terms.Clear(BIT(k));
          }
       }
    }
@@ -252,7 +252,7 @@ void FixedBNCApp::ProcessInputTermsFile(bool haveBitMap)
 
       if (haveBitMap)
       {
-         iv_Terms[k-il_MinK] = true;
+         iv_Terms.Set(k-il_MinK);
          il_TermCount++;
       }
       else
@@ -334,7 +334,7 @@ void FixedBNCApp::ProcessInputTermsFile(bool haveBitMap)
       if (haveBitMap)
       {
          bit = BIT(k);
-         iv_Terms[bit] = true;
+         iv_Terms.Set(bit);
          il_TermCount++;
       }
       else
@@ -373,7 +373,7 @@ bool FixedBNCApp::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (iv_Terms[bit])
    {
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       il_TermCount--;
 
       return true;
@@ -518,7 +518,7 @@ bool  FixedBNCApp::ReportFactor(uint64_t theFactor, uint64_t k)
 
    if (iv_Terms[bit])
    {
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       removedTerm = true;
 
       LogFactor(theFactor, "%" PRIu64"*%u^%u%+d", k, ii_Base, ii_N, ii_C);
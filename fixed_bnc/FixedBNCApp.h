@@ -58,7 +58,7 @@ private:
    uint64_t          WriteNewPGenTermsFile(uint64_t maxPrime, FILE *termsFile);
    void              AdjustMaxPrime(void);
 
-   std::vector<bool> iv_Terms;
+   TermBitmap        iv_Terms;
 
    std::string       is_Sequence;
    std::string       is_InputFileName;
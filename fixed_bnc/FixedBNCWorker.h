@@ -11,6 +11,7 @@
 
 #include "FixedBNCApp.h"
 #include "../core/Worker.h"
+#include "../core/FastDivisor.h"
 
 using namespace std;
 
@@ -39,14 +40,16 @@ private:
    FixedBNCApp      *ip_FixedBNCApp;
 
    uint32_t         *ii_BaseInverses;
-   uint64_t         *il_PrimeList;
    uint32_t         *ii_InverseList;
+   uint32_t          ii_InverseListSize;
 
    uint64_t          il_BpowN;
    uint64_t          il_MinK;
    uint64_t          il_MaxK;
    uint32_t          ii_Base;
+   FastDivisor       ik_BaseDivisor;
    uint32_t          ii_N;
+   MpPowPlan         ik_NPlan;
    int32_t           ii_C;
 };
 
@@ -88,8 +88,8 @@ void FixedKBNApp::ValidateOptions(void)
    {
       ProcessInputTermsFile(false);
 
-      iv_Terms.resize(il_MaxC - il_MinC + 1);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), false);
+      iv_Terms.Resize(il_MaxC - il_MinC + 1);
+      iv_Terms.Fill(false);
 
       ProcessInputTermsFile(true);
    }
@@ -118,8 +118,8 @@ void FixedKBNApp::ValidateOptions(void)
 
       il_TermCount = il_MaxC - il_MinC + 1;
 
-      iv_Terms.resize(il_MaxC - il_MinC + 1);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), true);
+      iv_Terms.Resize(il_MaxC - il_MinC + 1);
+      iv_Terms.Fill(true);
    }
 
    char  fileName[30];
@@ -179,7 +179,7 @@ void FixedKBNApp::ProcessInputTermsFile(bool haveBitMap)
 
       if (haveBitMap)
       {
-         iv_Terms[c-il_MinC] = true;
+         iv_Terms.Set(c-il_MinC);
          il_TermCount++;
       }
       else
@@ -201,7 +201,7 @@ void FixedKBNApp::ProcessInputTermsFile(bool haveBitMap)
       if (haveBitMap)
       {
          bit = BIT(c);
-         iv_Terms[bit] = true;
+         iv_Terms.Set(bit);
          il_TermCount++;
       }
       else
@@ -242,7 +242,7 @@ bool FixedKBNApp::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (iv_Terms[bit])
    {
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       il_TermCount--;
 
       return true;
@@ -330,7 +330,7 @@ bool  FixedKBNApp::ReportFactor(uint64_t theFactor, int64_t c, bool verifyFactor
 
    if (iv_Terms[bit])
    {
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       removedTerm = true;
 
       LogFactor(theFactor, "%" PRIu64"*%u^%u%+" PRId64"", il_K, ii_Base, ii_N, c);
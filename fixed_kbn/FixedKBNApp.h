@@ -56,7 +56,7 @@ protected:
    void              VerifyFactor(uint64_t prime, int64_t c);
 
 private:
-   std::vector<bool> iv_Terms;
+   TermBitmap        iv_Terms;
 
    std::string       is_Sequence;
    std::string       is_InputFileName;
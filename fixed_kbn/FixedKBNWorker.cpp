@@ -19,9 +19,12 @@ FixedKBNWorker::FixedKBNWorker(uint32_t myId, App *theApp) : Worker(myId, theApp
    il_K = ip_FixedKBNApp->GetK();
    ii_Base = ip_FixedKBNApp->GetBase();
    ii_N = ip_FixedKBNApp->GetN();
+   ik_NPlan = MpPowPlan(ii_N);
    il_MinC = ip_FixedKBNApp->GetMinC();
    il_MaxC = ip_FixedKBNApp->GetMaxC();
 
+   UsePowModKernel();
+
    // The thread can't start until initialization is done
    ib_Initialized = true;
 }
@@ -32,29 +35,27 @@ void  FixedKBNWorker::CleanUp(void)
 
 void  FixedKBNWorker::TestMegaPrimeChunk(void)
 {
-   uint64_t ps[4];
-   uint64_t bs[4];
+   uint64_t bs[PRIME_LIST_MULTIPLE];
    uint64_t maxPrime = ip_App->GetMaxPrime();
 
-   for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx+=4)
+   for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx+=PRIME_LIST_MULTIPLE)
    {
-      ps[0] = il_PrimeList[pIdx+0];
-      ps[1] = il_PrimeList[pIdx+1];
-      ps[2] = il_PrimeList[pIdx+2];
-      ps[3] = il_PrimeList[pIdx+3];
-
-      bs[0] = bs[1] = bs[2] = bs[3] = ii_Base;
-
-      fpu_powmod_4b_1n_4p(bs, ii_N, ps);
+      if (ii_Base == 2)
+         PowModBlockBase2(pIdx, bs, ik_NPlan, false);
+      else
+      {
+         for (uint32_t k=0; k<PRIME_LIST_MULTIPLE; k++)
+            bs[k] = ii_Base;
+
+         PowModBlock(pIdx, bs, ik_NPlan);
+      }
 
-      RemoveTerms(ps[0], bs[0]);
-      RemoveTerms(ps[1], bs[1]);
-      RemoveTerms(ps[2], bs[2]);
-      RemoveTerms(ps[3], bs[3]);
+      for (uint32_t k=0; k<PRIME_LIST_MULTIPLE; k++)
+         RemoveTerms(il_PrimeList[pIdx+k], bs[k]);
 
-      SetLargestPrimeTested(ps[3], 4);
+      SetLargestPrimeTested(il_PrimeList[pIdx+PRIME_LIST_MULTIPLE-1], PRIME_LIST_MULTIPLE);
 
-      if (ps[3] > maxPrime)
+      if (il_PrimeList[pIdx+PRIME_LIST_MULTIPLE-1] > maxPrime)
          break;
 
       // If no terms left, then we are done
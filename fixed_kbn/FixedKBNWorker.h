@@ -35,6 +35,7 @@ private:
    uint64_t          il_K;
    uint32_t          ii_Base;
    uint32_t          ii_N;
+   MpPowPlan         ik_NPlan;
 
    int64_t           il_MinC;
    int64_t           il_MaxC;
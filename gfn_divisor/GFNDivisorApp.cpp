@@ -240,8 +240,8 @@ void GFNDivisorApp::ValidateOptions(void)
 
          for (uint32_t n=ii_MinN; n<=ii_MaxN; n++)
          {
-            iv_Terms[n-ii_MinN].resize(kCount);
-            std::fill(iv_Terms[n-ii_MinN].begin(), iv_Terms[n-ii_MinN].end(), false);
+            iv_Terms[n-ii_MinN].Resize(kCount);
+            iv_Terms[n-ii_MinN].Fill(false);
          }
 
          ProcessInputTermsFile(true);
@@ -352,8 +352,8 @@ void  GFNDivisorApp::PreSieveHook(void)
 
       for (uint32_t n=ii_MinN; n<=ii_MaxN; n++)
       {
-         iv_Terms[n-ii_MinN].resize(kCount);
-         std::fill(iv_Terms[n-ii_MinN].begin(), iv_Terms[n-ii_MinN].end(), true);
+         iv_Terms[n-ii_MinN].Resize(kCount);
+         iv_Terms[n-ii_MinN].Fill(true);
       }
 
       return;
@@ -372,7 +372,7 @@ void  GFNDivisorApp::PreSieveHook(void)
       iv_Terms.resize(ii_NPerChunk);
 
       for (uint32_t n=0; n<ii_NPerChunk; n++)
-         iv_Terms[n].resize(il_KPerChunk);
+         iv_Terms[n].Resize(il_KPerChunk);
 
       il_MinKOriginal = il_MinK;
       il_MaxKOriginal = il_MaxK;
@@ -385,7 +385,7 @@ void  GFNDivisorApp::PreSieveHook(void)
    }
 
    for (uint32_t n=0; n<ii_NPerChunk; n++)
-      std::fill(iv_Terms[0].begin(), iv_Terms[0].end(), true);
+      iv_Terms[0].Fill(true);
 
    // We want il_MinK and il_MaxK to be set to the correct range
    // of k before we start sieving.
@@ -533,7 +533,7 @@ void GFNDivisorApp::ProcessInputTermsFile(bool haveBitMap, FILE *fPtr, char *fil
 
       if (haveBitMap)
       {
-         iv_Terms[n-ii_MinN][BIT(k)] = true;
+         iv_Terms[n-ii_MinN].Set(BIT(k));
          il_TermCount++;
       }
       else
@@ -564,7 +564,7 @@ void GFNDivisorApp::ProcessInputTermsFile(bool haveBitMap, FILE *fPtr, char *fil
 
          if (haveBitMap)
          {
-            iv_Terms[n-ii_MinN][BIT(k)] = true;
+            iv_Terms[n-ii_MinN].Set(BIT(k));
             il_TermCount++;
          }
          else
@@ -585,7 +585,7 @@ void GFNDivisorApp::ProcessInputTermsFile(bool haveBitMap, FILE *fPtr, char *fil
 
       if (haveBitMap)
       {
-         iv_Terms[n-ii_MinN][BIT(k)] = true;
+         iv_Terms[n-ii_MinN].Set(BIT(k));
          il_TermCount++;
       }
       else
@@ -627,7 +627,7 @@ bool  GFNDivisorApp::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (iv_Terms[n-ii_MinN][bit])
    {
-      iv_Terms[n-ii_MinN][bit] = false;
+      iv_Terms[n-ii_MinN].Clear(bit);
       il_TermCount--;
 
       return true;
@@ -783,7 +783,7 @@ bool  GFNDivisorApp::ReportFactor(uint64_t theFactor, uint64_t k, uint32_t n, bo
 
    if (iv_Terms[n-ii_MinN][bit])
    {
-      iv_Terms[n-ii_MinN][bit] = false;
+      iv_Terms[n-ii_MinN].Clear(bit);
 
       il_FactorCount++;
       il_TermCount--;
@@ -33,7 +33,7 @@ public:
    uint32_t          GetMaxN(void) { return ii_MaxN; };
    uint32_t          GetNCount(void) { return (ii_MaxN - ii_MinN + 1); };
 
-   std::vector<std::vector<bool>> GetTerms(void) { return iv_Terms; };
+   std::vector<TermBitmap> GetTerms(void) { return iv_Terms; };
 
    bool              ReportFactor(uint64_t theFactor, uint64_t k, uint32_t n, bool verifyFactor);
 
@@ -60,7 +60,7 @@ private:
    uint32_t          GetSmallPrimeFactor(uint64_t k, uint32_t n);
    void              VerifyFactor(uint64_t theFactor, uint64_t k, uint32_t n);
 
-   std::vector<std::vector<bool>>  iv_Terms;
+   std::vector<TermBitmap>  iv_Terms;
    std::string            is_OutputTermsFilePrefix;
 
    bool              ib_UseTermsBitmap;
@@ -11,6 +11,7 @@
 
 #include <gmp.h>
 #include "../core/App.h"
+#include "../core/TermBitmap.h"
 
 class GFNDivisorTester
 {
@@ -31,7 +32,7 @@ private:
 
    App              *ip_App;
 
-   std::vector<std::vector<bool>>  iv_Terms;
+   std::vector<TermBitmap>  iv_Terms;
    uint64_t          il_MinK;
    uint64_t          il_MaxK;
    uint32_t          ii_MinN;
@@ -112,8 +112,8 @@ void K1B2App::ValidateOptions(void)
 
       for (uint32_t n=ii_MinN; n<=ii_MaxN; n++)
       {
-         iv_Terms[n-ii_MinN].resize(cCount);
-         std::fill(iv_Terms[n-ii_MinN].begin(), iv_Terms[n-ii_MinN].end(), false);
+         iv_Terms[n-ii_MinN].Resize(cCount);
+         iv_Terms[n-ii_MinN].Fill(false);
       }
 
       ProcessInputTermsFile(true);
@@ -152,12 +152,12 @@ void K1B2App::ValidateOptions(void)
 
       for (uint32_t n=ii_MinN; n<=ii_MaxN; n++)
       {
-         iv_Terms[n-ii_MinN].resize(cCount);
-         std::fill(iv_Terms[n-ii_MinN].begin(), iv_Terms[n-ii_MinN].end(), false);
+         iv_Terms[n-ii_MinN].Resize(cCount);
+         iv_Terms[n-ii_MinN].Fill(false);
 
          for (int64_t c=il_MinC; c<=il_MaxC; c+=2)
          {
-            iv_Terms[n-ii_MinN][c-il_MinC] = true;
+            iv_Terms[n-ii_MinN].Set(c-il_MinC);
             il_TermCount++;
          }
       }
@@ -225,7 +225,7 @@ void K1B2App::ProcessInputTermsFile(bool haveBitMap)
 
       if (haveBitMap)
       {
-         iv_Terms[n-ii_MinN][c-il_MinC] = true;
+         iv_Terms[n-ii_MinN].Set(c-il_MinC);
          il_TermCount++;
       }
       else
@@ -265,7 +265,7 @@ bool  K1B2App::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (iv_Terms[n-ii_MinN][c-il_MinC])
    {
-      iv_Terms[n-ii_MinN][c-il_MinC] = false;
+      iv_Terms[n-ii_MinN].Clear(c-il_MinC);
       il_TermCount--;
 
       return true;
@@ -327,7 +327,7 @@ bool  K1B2App::ReportFactor(uint64_t theFactor, uint32_t n, int64_t c)
 
    if (iv_Terms[n-ii_MinN][c-il_MinC])
    {
-      iv_Terms[n-ii_MinN][c-il_MinC] = false;
+      iv_Terms[n-ii_MinN].Clear(c-il_MinC);
 
       il_FactorCount++;
       il_TermCount--;
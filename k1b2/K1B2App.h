@@ -49,7 +49,7 @@ protected:
    uint64_t          WriteABCDTermsFile(char *fileName, uint32_t minN, uint64_t maxPrime);
 
 private:
-   std::vector<std::vector<bool>>  iv_Terms;
+   std::vector<TermBitmap>  iv_Terms;
 
    uint32_t          ii_MinN;
    uint32_t          ii_MaxN;
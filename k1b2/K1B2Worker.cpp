@@ -16,11 +16,14 @@ K1B2Worker::K1B2Worker(uint32_t myId, App *theApp) : Worker(myId, theApp)
    ip_K1B2App = (K1B2App *) theApp;
 
    ii_MinN = ip_K1B2App->GetMinN();
+   ik_MinNPlan = MpPowPlan(ii_MinN);
    ii_MaxN = ip_K1B2App->GetMaxN();
 
    il_MinC = ip_K1B2App->GetMinC();
    il_MaxC = ip_K1B2App->GetMaxC();
 
+   UsePowModKernel();
+
    // The thread can't start until initialization is done
    ib_Initialized = true;
 }
@@ -31,66 +34,43 @@ void  K1B2Worker::CleanUp(void)
 
 void  K1B2Worker::TestMegaPrimeChunk(void)
 {
-   uint64_t ps[4];
-   uint64_t twoExpN[4];
+   uint64_t p;
+   uint64_t twoExpN[PRIME_LIST_MULTIPLE];
    uint64_t maxPrime = ip_App->GetMaxPrime();
    uint32_t n;
    bool     useSmallPLogic = true;
 
-   for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx+=4)
+   for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx+=PRIME_LIST_MULTIPLE)
    {
-      ps[0] = il_PrimeList[pIdx+0];
-      ps[1] = il_PrimeList[pIdx+1];
-      ps[2] = il_PrimeList[pIdx+2];
-      ps[3] = il_PrimeList[pIdx+3];
-
       if (useSmallPLogic)
       {
-         if ((int64_t) ps[0] > (il_MaxC - il_MinC + 1))
+         if ((int64_t) il_PrimeList[pIdx] > (il_MaxC - il_MinC + 1))
             useSmallPLogic = false;
       }
 
-      twoExpN[0] = twoExpN[1] = twoExpN[2] = twoExpN[3] = 2;
-
-      fpu_powmod_4b_1n_4p(twoExpN, ii_MinN, ps);
+      PowModBlockBase2(pIdx, twoExpN, ik_MinNPlan, false);
 
-      n = ii_MinN;
-
-      while (n <= ii_MaxN)
+      for (uint32_t k=0; k<PRIME_LIST_MULTIPLE; k++)
       {
-         if (useSmallPLogic)
-         {
-            RemoveTermsSmallP(ps[0], n, twoExpN[0]);
-            RemoveTermsSmallP(ps[1], n, twoExpN[1]);
-            RemoveTermsSmallP(ps[2], n, twoExpN[2]);
-            RemoveTermsSmallP(ps[3], n, twoExpN[3]);
-         }
-         else
-         {
-            RemoveTermsLargeP(ps[0], n, twoExpN[0]);
-            RemoveTermsLargeP(ps[1], n, twoExpN[1]);
-            RemoveTermsLargeP(ps[2], n, twoExpN[2]);
-            RemoveTermsLargeP(ps[3], n, twoExpN[3]);
-         }
+         p = il_PrimeList[pIdx+k];
 
-         // Multiple each term by 2.
-         twoExpN[0] <<= 1;
-         twoExpN[1] <<= 1;
-         twoExpN[2] <<= 1;
-         twoExpN[3] <<= 1;
+         for (n=ii_MinN; n<=ii_MaxN; n++)
+         {
+            if (useSmallPLogic)
+               RemoveTermsSmallP(p, n, twoExpN[k]);
+            else
+               RemoveTermsLargeP(p, n, twoExpN[k]);
 
-         // If we have exceeded p, then subtract p.
-         if (twoExpN[0] >= ps[0]) twoExpN[0] -= ps[0];
-         if (twoExpN[1] >= ps[1]) twoExpN[1] -= ps[1];
-         if (twoExpN[2] >= ps[2]) twoExpN[2] -= ps[2];
-         if (twoExpN[3] >= ps[3]) twoExpN[3] -= ps[3];
+            // Multiple the term by 2.  If we have exceeded p, then subtract p.
+            twoExpN[k] <<= 1;
 
-         n++;
+            if (twoExpN[k] >= p) twoExpN[k] -= p;
+         }
       }
 
-      SetLargestPrimeTested(ps[3], 4);
+      SetLargestPrimeTested(il_PrimeList[pIdx+PRIME_LIST_MULTIPLE-1], PRIME_LIST_MULTIPLE);
 
-      if (ps[3] > maxPrime)
+      if (il_PrimeList[pIdx+PRIME_LIST_MULTIPLE-1] > maxPrime)
          break;
    }
 }
@@ -35,6 +35,7 @@ private:
    K1B2App          *ip_K1B2App;
 
    uint32_t          ii_MinN;
+   MpPowPlan         ik_MinNPlan;
    uint32_t          ii_MaxN;
    int64_t           il_MinC;
    int64_t           il_MaxC;
@@ -91,11 +91,11 @@ void KBBApp::ValidateOptions(void)
    {
       ProcessInputTermsFile(false);
 
-      iv_MinusTerms.resize(ii_MaxB - ii_MinB + 1);
-      iv_PlusTerms.resize(ii_MaxB - ii_MinB + 1);
+      iv_MinusTerms.Resize(ii_MaxB - ii_MinB + 1);
+      iv_PlusTerms.Resize(ii_MaxB - ii_MinB + 1);
 
-      std::fill(iv_MinusTerms.begin(), iv_MinusTerms.end(), false);
-      std::fill(iv_PlusTerms.begin(), iv_PlusTerms.end(), false);
+      iv_MinusTerms.Fill(false);
+      iv_PlusTerms.Fill(false);
 
       ProcessInputTermsFile(true);
    }
@@ -115,11 +115,11 @@ void KBBApp::ValidateOptions(void)
 
       il_TermCount = 2 * (ii_MaxB - ii_MinB + 1);
 
-      iv_MinusTerms.resize(ii_MaxB - ii_MinB + 1);
-      iv_PlusTerms.resize(ii_MaxB - ii_MinB + 1);
+      iv_MinusTerms.Resize(ii_MaxB - ii_MinB + 1);
+      iv_PlusTerms.Resize(ii_MaxB - ii_MinB + 1);
 
-      std::fill(iv_MinusTerms.begin(), iv_MinusTerms.end(), true);
-      std::fill(iv_PlusTerms.begin(), iv_PlusTerms.end(), true);
+      iv_MinusTerms.Fill(true);
+      iv_PlusTerms.Fill(true);
 
       if (il_K % 2 == 1)
       {
@@ -132,8 +132,8 @@ void KBBApp::ValidateOptions(void)
 
             uint32_t bit = BIT(b);
 
-            iv_MinusTerms[bit] = false;
-            iv_PlusTerms[bit] = false;
+            iv_MinusTerms.Clear(bit);
+            iv_PlusTerms.Clear(bit);
 
             termsRemoved += 2;
             il_TermCount -= 2;
@@ -184,14 +184,14 @@ void KBBApp::EliminateGfnAndMersenneTerms(void)
       if (iv_PlusTerms[bit] && IsGfnOrMersenneForm(il_K, b, +1))
       {
          il_TermCount--;
-         iv_PlusTerms[bit] = false;
+         iv_PlusTerms.Clear(bit);
          removedCount++;
       }
 
       if (iv_MinusTerms[bit] && IsGfnOrMersenneForm(il_K, b, -1))
       {
          il_TermCount--;
-         iv_MinusTerms[bit] = false;
+         iv_MinusTerms.Clear(bit);
          removedCount++;
       }
    }
@@ -252,8 +252,8 @@ void KBBApp::ProcessInputTermsFile(bool haveBitMap)
       if (haveBitMap)
       {
          il_TermCount++;
-         if (c == +1) iv_PlusTerms[BIT(b)] = true;
-         if (c == -1) iv_MinusTerms[BIT(b)] = true;
+         if (c == +1) iv_PlusTerms.Set(BIT(b));
+         if (c == -1) iv_MinusTerms.Set(BIT(b));
       }
       else
       {
@@ -297,14 +297,14 @@ bool KBBApp::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (sign == '+' && iv_PlusTerms[bit])
    {
-      iv_PlusTerms[bit] = false;
+      iv_PlusTerms.Clear(bit);
       il_TermCount--;
       return true;
    }
 
    if (sign == '-' && iv_MinusTerms[bit])
    {
-      iv_MinusTerms[bit] = false;
+      iv_MinusTerms.Clear(bit);
       il_TermCount--;
       return true;
    }
@@ -390,7 +390,7 @@ bool  KBBApp::ReportFactor(uint64_t theFactor, uint32_t b, int32_t c)
 
    if (c == +1 && iv_PlusTerms[bit])
    {
-      iv_PlusTerms[bit] = false;
+      iv_PlusTerms.Clear(bit);
       removedTerm = true;
 
       LogFactor(theFactor, "%" PRIu64"*%u^%u+1", il_K, b, b);
@@ -401,7 +401,7 @@ bool  KBBApp::ReportFactor(uint64_t theFactor, uint32_t b, int32_t c)
 
    if (c == -1 && iv_MinusTerms[bit])
    {
-      iv_MinusTerms[bit] = false;
+      iv_MinusTerms.Clear(bit);
       removedTerm = true;
 
       LogFactor(theFactor, "%" PRIu64"*%u^%u-1", il_K, b, b);
@@ -507,7 +507,7 @@ bool  KBBApp::CheckAlgebraicFactor(uint32_t b, int32_t c, const char *fmt, ...)
 
    if (c == +1 && iv_PlusTerms[bit])
    {
-      iv_PlusTerms[bit] = false;
+      iv_PlusTerms.Clear(bit);
       removedTerm = true;
 
       LogFactor(factor, "%" PRIu64"*%u^%u+1", il_K, b, b);
@@ -518,7 +518,7 @@ bool  KBBApp::CheckAlgebraicFactor(uint32_t b, int32_t c, const char *fmt, ...)
 
    if (c == -1 && iv_MinusTerms[bit])
    {
-      iv_MinusTerms[bit] = false;
+      iv_MinusTerms.Clear(bit);
       removedTerm = true;
 
       LogFactor(factor, "%" PRIu64"*%u^%u-1", il_K, b, b);
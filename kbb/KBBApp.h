@@ -63,8 +63,8 @@ private:
 
    void              VerifyFactor(uint64_t theFactor, uint64_t b, int32_t c);
 
-   std::vector<bool> iv_PlusTerms;
-   std::vector<bool> iv_MinusTerms;
+   TermBitmap        iv_PlusTerms;
+   TermBitmap        iv_MinusTerms;
 
    std::string       is_InputFileName;
    std::string       is_OutputFileName;
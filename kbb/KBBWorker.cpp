@@ -26,6 +26,8 @@ KBBWorker::KBBWorker(uint32_t myId, App *theApp) : Worker(myId, theApp)
    il_NextBaseBuild = 0;
 
    // The thread can't start until initialization is done
+   UseMontgomeryContext();
+
    ib_Initialized = true;
 }
 
@@ -57,7 +59,7 @@ void  KBBWorker::TestMegaPrimeChunk(void)
          il_NextBaseBuild = (ps[3] << 1);
       }
 
-      MpArithVec mp(ps);
+      MpArithVec mp(ik_MpContext, pIdx);
 
       const MpResVec resK = mp.nToRes(il_K);
 
@@ -129,11 +129,11 @@ void MultiFactorialApp::ValidateOptions(void)
    {
       ProcessInputTermsFile(false);
 
-      iv_MinusTerms.resize(ii_MaxN - ii_MinN + 1);
-      std::fill(iv_MinusTerms.begin(), iv_MinusTerms.end(), false);
+      iv_MinusTerms.Resize(ii_MaxN - ii_MinN + 1);
+      iv_MinusTerms.Fill(false);
 
-      iv_PlusTerms.resize(ii_MaxN - ii_MinN + 1);
-      std::fill(iv_PlusTerms.begin(), iv_PlusTerms.end(), false);
+      iv_PlusTerms.Resize(ii_MaxN - ii_MinN + 1);
+      iv_PlusTerms.Fill(false);
 
       il_TermCount = 0;
       ProcessInputTermsFile(true);
@@ -146,11 +146,11 @@ void MultiFactorialApp::ValidateOptions(void)
       if (ii_MaxN <= ii_MinN)
          FatalError("The value for -N must be greater than the value for -n");
 
-      iv_MinusTerms.resize(ii_MaxN - ii_MinN + 1);
-      std::fill(iv_MinusTerms.begin(), iv_MinusTerms.end(), true);
+      iv_MinusTerms.Resize(ii_MaxN - ii_MinN + 1);
+      iv_MinusTerms.Fill(true);
 
-      iv_PlusTerms.resize(ii_MaxN - ii_MinN + 1);
-      std::fill(iv_PlusTerms.begin(), iv_PlusTerms.end(), true);
+      iv_PlusTerms.Resize(ii_MaxN - ii_MinN + 1);
+      iv_PlusTerms.Fill(true);
 
       il_TermCount = 2 * (ii_MaxN - ii_MinN + 1);
 
@@ -163,8 +163,8 @@ void MultiFactorialApp::ValidateOptions(void)
 
          while (n <= ii_MaxN)
          {
-            iv_PlusTerms[BIT(n)] = false;
-            iv_MinusTerms[BIT(n)] = false;
+            iv_PlusTerms.Clear(BIT(n));
+            iv_MinusTerms.Clear(BIT(n));
             il_TermCount -= 2;
 
             n += 2;
@@ -293,13 +293,13 @@ void MultiFactorialApp::ProcessInputTermsFile(bool haveBitMap)
       {
          if (c == -1)
          {
-            iv_MinusTerms[n - ii_MinN] = true;
+            iv_MinusTerms.Set(n - ii_MinN);
             il_TermCount++;
          }
 
          if (c == +1)
          {
-            iv_PlusTerms[n - ii_MinN] = true;
+            iv_PlusTerms.Set(n - ii_MinN);
             il_TermCount++;
          }
       }
@@ -334,14 +334,14 @@ bool MultiFactorialApp::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (c == -1 && iv_MinusTerms[bit])
    {
-      iv_MinusTerms[bit] = false;
+      iv_MinusTerms.Clear(bit);
       il_TermCount--;
       return true;
    }
 
    if (c == +1 && iv_PlusTerms[bit])
    {
-      iv_PlusTerms[bit] = false;
+      iv_PlusTerms.Clear(bit);
       il_TermCount--;
       return true;
    }
@@ -409,7 +409,7 @@ bool MultiFactorialApp::ReportFactor(uint64_t theFactor, uint32_t n, int32_t c)
    if (c == -1 && iv_MinusTerms[bit])
    {
       newFactor = true;
-      iv_MinusTerms[bit] = false;
+      iv_MinusTerms.Clear(bit);
       il_TermCount--;
       il_FactorCount++;
 
@@ -419,7 +419,7 @@ bool MultiFactorialApp::ReportFactor(uint64_t theFactor, uint32_t n, int32_t c)
    if (c == +1 && iv_PlusTerms[bit])
    {
       newFactor = true;
-      iv_PlusTerms[bit] = false;
+      iv_PlusTerms.Clear(bit);
       il_TermCount--;
       il_FactorCount++;
 
@@ -66,8 +66,8 @@ protected:
 private:
    void              VerifyFactor(uint64_t theFactor, uint32_t n, int32_t c);
 
-   std::vector<bool> iv_PlusTerms;
-   std::vector<bool> iv_MinusTerms;
+   TermBitmap        iv_PlusTerms;
+   TermBitmap        iv_MinusTerms;
 
    uint32_t          ii_MultiFactorial;
    uint32_t          ii_MinN;
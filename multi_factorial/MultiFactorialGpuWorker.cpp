@@ -102,7 +102,7 @@ void  MultiFactorialGpuWorker::TestMegaPrimeChunk(void)
          iteration++;
          ii_FactorCount[0] = 0;
 
-         ip_Kernel->Execute(ii_PrimesInList);
+         ip_Kernel->Execute(ii_PaddedPrimesInList);
 
          for (ii=0; ii<ii_FactorCount[0]; ii++)
          {
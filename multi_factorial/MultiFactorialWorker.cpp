@@ -9,6 +9,7 @@
 #include <math.h>
 #include "MultiFactorialWorker.h"
 #include "../core/MpArithVector.h"
+#include "../core/MpArithVectorIfma.h"
 
 extern "C" int mfsieve(uint32_t start, uint32_t mf, uint32_t minmax, uint64_t *P);
 extern "C" int multifactorial(uint32_t start, uint32_t mf, uint32_t minmax, uint64_t *P);
@@ -21,6 +22,18 @@ MultiFactorialWorker::MultiFactorialWorker(uint32_t myId, App *theApp) : Worker(
    ii_MaxN = ip_MultiFactorialApp->GetMaxN();
    ii_MultiFactorial = ip_MultiFactorialApp->GetMultiFactorial();
 
+#ifdef USE_X86
+   ib_UseIfma = CpuSupportsAvx512Ifma();
+#endif
+
+   UseMontgomeryContext();
+
+   // Calibrating the lanes would only time the IFMA code for most ranges
+#ifdef USE_X86
+   if (!ib_UseIfma || ii_MultiFactorial > 1)
+#endif
+      UseLanes();
+
    ib_Initialized = true;
 }
 
@@ -30,39 +43,62 @@ void  MultiFactorialWorker::CleanUp(void)
 
 void  MultiFactorialWorker::TestMegaPrimeChunk(void)
 {
+#ifdef USE_X86
+   if (ii_MultiFactorial == 1 && ib_UseIfma && il_PrimeList[ii_PrimesInList-1] < PMAX_MAX_52BIT)
+   {
+      TestFactorialIfma();
+      return;
+   }
+#endif
+
+   uint32_t lanes = GetLanes();
+
    if (ii_MultiFactorial == 1)
-      TestFactorial();
+   {
+      if (lanes == 16)
+         TestFactorial<16>();
+      else if (lanes == 8)
+         TestFactorial<8>();
+      else
+         TestFactorial<4>();
+   }
    else
-      TestMultiFactorial();
+   {
+      if (lanes == 16)
+         TestMultiFactorial<16>();
+      else if (lanes == 8)
+         TestMultiFactorial<8>();
+      else
+         TestMultiFactorial<4>();
+   }
 }
 
+template <size_t N>
 void  MultiFactorialWorker::TestFactorial(void)
 {
-   uint64_t  ps[4], maxPrime = ip_App->GetMaxPrime();
+   uint64_t  ps[N], maxPrime = ip_App->GetMaxPrime();
    uint32_t  n;
 
    // if i <= n_pair then (i - 1) * i < p. Compute n! = (2 * 3) * (4 * 5) * ... * ((n - 1) * n)
    uint32_t  n_pair = std::max(2u, std::min(ii_MinN, uint32_t(sqrt(double(il_PrimeList[0])))) & ~1u);
 
-   for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx+=4)
+   for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx+=N)
    {
-      ps[0] = il_PrimeList[pIdx+0];
-      ps[1] = il_PrimeList[pIdx+1];
-      ps[2] = il_PrimeList[pIdx+2];
-      ps[3] = il_PrimeList[pIdx+3];
+      for (size_t k = 0; k < N; ++k)
+         ps[k] = il_PrimeList[pIdx+k];
 
-      MpArithVec mp(ps);
+      MpArithVector<N> mp(ik_MpContext, pIdx);
 
-      const MpResVec pOne = mp.one();
-      const MpResVec mOne = mp.sub(mp.zero(), pOne);
-      const MpResVec two = mp.add(pOne, pOne);
-      const MpResVec four = mp.add(two, two);
-      const MpResVec eight = mp.add(four, four);
+      const MpResVector<N> pOne = mp.one();
+      const MpResVector<N> mOne = mp.sub(mp.zero(), pOne);
+      const MpResVector<N> two = mp.add(pOne, pOne);
+      const MpResVector<N> four = mp.add(two, two);
+      const MpResVector<N> eight = mp.add(four, four);
 
       // ri = residue of i, rf = residue of i!
-      MpResVec ri = pOne, rf = pOne;
+      MpResVector<N> ri = pOne, rf = pOne;
       // residue of i * (i + 1), the step is (i + 2) * (i + 3) - i * (i + 1) = 4 * i + 6
-      MpResVec r_ixip1 = mp.zero(), r_step = mp.add(four, two);
+      MpResVector<N> r_ixip1 = mp.zero(), r_step = mp.add(four, two);
 
       // Factorial with pairs of numbers: i! = ((i - 1) * i) * (i - 2)!
       for (n = 2; n < n_pair; n += 2)
@@ -86,9 +122,74 @@ void  MultiFactorialWorker::TestFactorial(void)
          ri = mp.add(ri, pOne);
          rf = mp.mul(rf, ri);
 
-         if (MpArithVec::at_least_one_is_equal(rf, pOne) || MpArithVec::at_least_one_is_equal(rf, mOne))
+         if (MpArithVector<N>::at_least_one_is_equal(rf, pOne) || MpArithVector<N>::at_least_one_is_equal(rf, mOne))
+         {
+            for (size_t k = 0; k < N; ++k)
+            {
+               if (rf[k] == pOne[k])
+                  ip_MultiFactorialApp->ReportFactor(ps[k], n, -1);
+
+               if (rf[k] == mOne[k])
+                  ip_MultiFactorialApp->ReportFactor(ps[k], n, +1);
+            }
+         }
+      }
+
+      SetLargestPrimeTested(ps[N-1], N);
+
+      if (ps[N-1] >= maxPrime)
+         break;
+   }
+}
+
+#ifdef USE_X86
+// This is the same as TestFactorial(), but for 8 primes at a time with AVX-512 IFMA
+IFMA_TARGET void  MultiFactorialWorker::TestFactorialIfma(void)
+{
+   uint64_t  ps[IFMA_VECTOR_SIZE], maxPrime = ip_App->GetMaxPrime();
+   uint32_t  n;
+
+   // if i <= n_pair then (i - 1) * i < p. Compute n! = (2 * 3) * (4 * 5) * ... * ((n - 1) * n)
+   uint32_t  n_pair = std::max(2u, std::min(ii_MinN, uint32_t(sqrt(double(il_PrimeList[0])))) & ~1u);
+
+   for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx+=IFMA_VECTOR_SIZE)
+   {
+      for (size_t k = 0; k < IFMA_VECTOR_SIZE; ++k)
+         ps[k] = il_PrimeList[pIdx+k];
+
+      MpArithVectorIfma mp(ps);
+
+      const MpResVectorIfma pOne = mp.one();
+      const MpResVectorIfma mOne = mp.sub(mp.zero(), pOne);
+      const MpResVectorIfma two = mp.add(pOne, pOne);
+      const MpResVectorIfma four = mp.add(two, two);
+      const MpResVectorIfma eight = mp.add(four, four);
+
+      MpResVectorIfma ri = pOne, rf = pOne;
+      MpResVectorIfma r_ixip1 = mp.zero(), r_step = mp.add(four, two);
+
+      for (n = 2; n < n_pair; n += 2)
+      {
+         r_ixip1 = mp.add(r_ixip1, r_step);
+         r_step = mp.add(r_step, eight);
+         rf = mp.mul(rf, r_ixip1);
+      }
+
+      ri = mp.nToRes(n_pair - 1);
+      for (n = n_pair; n < ii_MinN; ++n)
+      {
+         ri = mp.add(ri, pOne);
+         rf = mp.mul(rf, ri);
+      }
+
+      for (; n <= ii_MaxN; ++n)
+      {
+         ri = mp.add(ri, pOne);
+         rf = mp.mul(rf, ri);
+
+         if (MpArithVectorIfma::at_least_one_is_equal(rf, pOne) || MpArithVectorIfma::at_least_one_is_equal(rf, mOne))
          {
-            for (size_t k = 0; k < VECTOR_SIZE; ++k)
+            for (size_t k = 0; k < IFMA_VECTOR_SIZE; ++k)
             {
                if (rf[k] == pOne[k])
                   ip_MultiFactorialApp->ReportFactor(ps[k], n, -1);
@@ -99,16 +200,18 @@ void  MultiFactorialWorker::TestFactorial(void)
          }
       }
 
-      SetLargestPrimeTested(ps[3], 4);
+      SetLargestPrimeTested(ps[IFMA_VECTOR_SIZE-1], IFMA_VECTOR_SIZE);
 
-      if (ps[3] >= maxPrime)
+      if (ps[IFMA_VECTOR_SIZE-1] >= maxPrime)
          break;
    }
 }
+#endif
 
+template <size_t N>
 void  MultiFactorialWorker::TestMultiFactorial(void)
 {
-   uint64_t  ps[4], maxPrime = ip_App->GetMaxPrime();
+   uint64_t  ps[N], maxPrime = ip_App->GetMaxPrime();
    uint32_t  maxNFirstLoop = ii_MinN - ii_MultiFactorial;
    uint32_t  n, startN;
 
@@ -116,18 +219,16 @@ void  MultiFactorialWorker::TestMultiFactorial(void)
 
    while (pIdx < ii_PrimesInList)
    {
-      ps[0] = il_PrimeList[pIdx+0];
-      ps[1] = il_PrimeList[pIdx+1];
-      ps[2] = il_PrimeList[pIdx+2];
-      ps[3] = il_PrimeList[pIdx+3];
+      for (size_t k = 0; k < N; ++k)
+         ps[k] = il_PrimeList[pIdx+k];
 
-      pIdx += 4;
+      MpArithVector<N> mp(ik_MpContext, pIdx);
 
-      MpArithVec mp(ps);
+      pIdx += N;
 
-      const MpResVec pOne = mp.one();
-      const MpResVec mOne = mp.sub(mp.zero(), pOne);
-      const MpResVec resMf = mp.nToRes(ii_MultiFactorial);
+      const MpResVector<N> pOne = mp.one();
+      const MpResVector<N> mOne = mp.sub(mp.zero(), pOne);
+      const MpResVector<N> resMf = mp.nToRes(ii_MultiFactorial);
 
       for (startN=1; startN<=ii_MultiFactorial; startN++)
       {
@@ -136,8 +237,8 @@ void  MultiFactorialWorker::TestMultiFactorial(void)
          if (!(ii_MultiFactorial & 1) && (startN & 1))
             continue;
 
-         MpResVec ri = mp.nToRes(startN);
-         MpResVec rf = ri;
+         MpResVector<N> ri = mp.nToRes(startN);
+         MpResVector<N> rf = ri;
 
          // At this time we have:
          //    ri = residual of startN (mod p)
@@ -159,9 +260,9 @@ void  MultiFactorialWorker::TestMultiFactorial(void)
             ri = mp.add(ri, resMf);
             rf = mp.mul(rf, ri);
 
-            if (MpArithVec::at_least_one_is_equal(rf, pOne) || MpArithVec::at_least_one_is_equal(rf, mOne))
+            if (MpArithVector<N>::at_least_one_is_equal(rf, pOne) || MpArithVector<N>::at_least_one_is_equal(rf, mOne))
             {
-               for (size_t k = 0; k < VECTOR_SIZE; ++k)
+               for (size_t k = 0; k < N; ++k)
                {
                   if (rf[k] == pOne[k])
                      ip_MultiFactorialApp->ReportFactor(ps[k], n, -1);
@@ -173,12 +274,13 @@ void  MultiFactorialWorker::TestMultiFactorial(void)
          }
       }
 
-      SetLargestPrimeTested(ps[3], 4);
+      SetLargestPrimeTested(ps[N-1], N);
 
-      if (ps[3] >= maxPrime)
+      if (ps[N-1] >= maxPrime)
          break;
    }
 }
+
 void  MultiFactorialWorker::TestMiniPrimeChunk(uint64_t *miniPrimeChunk)
 {
    FatalError("MultiFactorialWorker::TestMiniPrimeChunk not implemented");
@@ -33,8 +33,17 @@ protected:
    uint32_t          ii_MultiFactorial;
 
 private:
+   template <size_t N>
    void              TestFactorial(void);
+
+   template <size_t N>
    void              TestMultiFactorial(void);
+
+#ifdef USE_X86
+   void              TestFactorialIfma(void);
+
+   bool              ib_UseIfma;
+#endif
 };
 
 #endif
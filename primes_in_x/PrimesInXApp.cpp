@@ -158,8 +158,8 @@ void PrimesInXApp::ValidateOptions(void)
 
       il_TermCount = ii_MaxLength - ii_MinLength + 1;
 
-      iv_Terms.resize(il_TermCount);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), false);
+      iv_Terms.Resize(il_TermCount);
+      iv_Terms.Fill(false);
 
       ProcessInputTermsFile(true);
    }
@@ -178,8 +178,8 @@ void PrimesInXApp::ValidateOptions(void)
 
       il_TermCount = ii_MaxLength - ii_MinLength + 1;
 
-      iv_Terms.resize(il_TermCount);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), true);
+      iv_Terms.Resize(il_TermCount);
+      iv_Terms.Fill(true);
    }
 
    FactorApp::ParentValidateOptions();
@@ -272,7 +272,7 @@ void PrimesInXApp::ProcessInputTermsFile(bool haveBitMap)
 
       if (haveBitMap)
       {
-         iv_Terms[BIT(c)] = true;
+         iv_Terms.Set(BIT(c));
          il_TermCount++;
       }
    }
@@ -299,7 +299,7 @@ bool  PrimesInXApp::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (iv_Terms[bit])
    {
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       il_TermCount--;
 
       return true;
@@ -466,7 +466,7 @@ bool PrimesInXApp::ReportFactor(uint64_t theFactor, uint32_t n)
    if (iv_Terms[bit])
    {
       newFactor = true;
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       il_FactorCount++;
       il_TermCount--;
 
@@ -491,7 +491,7 @@ void PrimesInXApp::ReportPrime(uint64_t thePrime, uint32_t n)
 
    if (iv_Terms[bit])
    {
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       il_FactorCount++;
       il_TermCount--;
 
@@ -62,7 +62,7 @@ private:
    void              BuildTerms(char *inputTerm);
    void              VerifyFactor(uint64_t theFactor, uint32_t termLength);
 
-   std::vector<bool> iv_Terms;
+   TermBitmap        iv_Terms;
 
    std::string       is_SearchString;
    std::string       is_FullTerm;
@@ -100,7 +100,7 @@ void  PrimesInXGpuWorker::TestMegaPrimeChunk(void)
       // The second entry is a multiplier for each term in the list.
       memcpy(ii_DigitList, &digitList[dlIdx], ii_GroupSize*sizeof(uint32_t));
 
-      ip_Kernel->Execute(ii_PrimesInList);
+      ip_Kernel->Execute(ii_PaddedPrimesInList);
 
       for (uint32_t ii=0; ii<ii_FactorCount[0]; ii++)
       {
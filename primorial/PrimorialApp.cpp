@@ -175,11 +175,11 @@ void PrimorialApp::ValidateOptions(void)
    ip_PrimorialPrimes[ii_NumberOfPrimorialPrimes] = 0;
    ip_PrimorialPrimeGaps[ii_NumberOfPrimorialPrimes] = 0;
 
-   iv_MinusTerms.resize(ii_MaxPrimorial - ii_MinPrimorial + 1);
-   std::fill(iv_MinusTerms.begin(), iv_MinusTerms.end(), false);
+   iv_MinusTerms.Resize(ii_MaxPrimorial - ii_MinPrimorial + 1);
+   iv_MinusTerms.Fill(false);
 
-   iv_PlusTerms.resize(ii_MaxPrimorial - ii_MinPrimorial + 1);
-   std::fill(iv_PlusTerms.begin(), iv_PlusTerms.end(), false);
+   iv_PlusTerms.Resize(ii_MaxPrimorial - ii_MinPrimorial + 1);
+   iv_PlusTerms.Fill(false);
 
    if (is_InputTermsFileName.length() > 0)
    {
@@ -197,8 +197,8 @@ void PrimorialApp::ValidateOptions(void)
 
          if (thisPrime >= ii_MinPrimorial && thisPrime <= ii_MaxPrimorial)
          {
-            iv_PlusTerms[BIT(thisPrime)] = true;
-            iv_MinusTerms[BIT(thisPrime)] = true;
+            iv_PlusTerms.Set(BIT(thisPrime));
+            iv_MinusTerms.Set(BIT(thisPrime));
             il_TermCount += 2;
          }
       }
@@ -261,13 +261,13 @@ void PrimorialApp::ProcessInputTermsFile(bool haveBitMap)
       {
          if (c == -1)
          {
-            iv_MinusTerms[primorial - ii_MinPrimorial] = true;
+            iv_MinusTerms.Set(primorial - ii_MinPrimorial);
             il_TermCount++;
          }
 
          if (c == +1)
          {
-            iv_PlusTerms[primorial - ii_MinPrimorial] = true;
+            iv_PlusTerms.Set(primorial - ii_MinPrimorial);
             il_TermCount++;
          }
       }
@@ -299,14 +299,14 @@ bool PrimorialApp::ApplyFactor(uint64_t thePrime, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (c == -1 && iv_MinusTerms[bit])
    {
-      iv_MinusTerms[bit] = false;
+      iv_MinusTerms.Clear(bit);
       il_TermCount--;
       return true;
    }
 
    if (c == +1 && iv_PlusTerms[bit])
    {
-      iv_PlusTerms[bit] = false;
+      iv_PlusTerms.Clear(bit);
       il_TermCount--;
       return true;
    }
@@ -371,7 +371,7 @@ bool PrimorialApp::ReportFactor(uint64_t theFactor, uint32_t primorial, int32_t
    if (c == -1 && iv_MinusTerms[bit])
    {
       newFactor = true;
-      iv_MinusTerms[bit] = false;
+      iv_MinusTerms.Clear(bit);
       il_TermCount--;
       il_FactorCount++;
 
@@ -381,7 +381,7 @@ bool PrimorialApp::ReportFactor(uint64_t theFactor, uint32_t primorial, int32_t
    if (c == +1 && iv_PlusTerms[bit])
    {
       newFactor = true;
-      iv_PlusTerms[bit] = false;
+      iv_PlusTerms.Clear(bit);
       il_TermCount--;
       il_FactorCount++;
 
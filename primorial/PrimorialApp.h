@@ -61,8 +61,8 @@ protected:
    void              VerifyFactor(uint64_t theFactor, uint32_t primorial, int32_t c);
 
 private:
-   std::vector<bool> iv_PlusTerms;
-   std::vector<bool> iv_MinusTerms;
+   TermBitmap        iv_PlusTerms;
+   TermBitmap        iv_MinusTerms;
 
    uint32_t         *ip_PrimorialPrimes;
    uint32_t          ii_NumberOfPrimorialPrimes;
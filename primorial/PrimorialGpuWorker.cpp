@@ -89,7 +89,7 @@ void  PrimorialGpuWorker::TestMegaPrimeChunk(void)
 
       ii_FactorCount[0] = 0;
 
-      ip_Kernel->Execute(ii_PrimesInList);
+      ip_Kernel->Execute(ii_PaddedPrimesInList);
 
       for (ii=0; ii<ii_FactorCount[0]; ii++)
       {
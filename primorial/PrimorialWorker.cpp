@@ -7,7 +7,7 @@
 */
 
 #include "PrimorialWorker.h"
-#include "../x86_asm/avx-asm-x86.h"
+#include "../x86_asm/avx512-asm-x86.h"
 
 PrimorialWorker::PrimorialWorker(uint32_t myId, App *theApp) : Worker(myId, theApp)
 {
@@ -20,8 +20,10 @@ PrimorialWorker::PrimorialWorker(uint32_t myId, App *theApp) : Worker(myId, theA
    ii_MaxPrimorial = ip_PrimorialApp->GetMaxPrimorial();
 
    if (ii_BiggestGap > MAX_GAPS)
-      FatalError("ip_ResGaps not large enough.  Update MAX_GAPS and rebuild");
+      FatalError("MAX_GAPS is not large enough.  Update MAX_GAPS and rebuild");
 
+   // The AVX code does one mulmod per call, so it is much slower than MpArithVector
+   // even with 32 primes in the zmm registers.  It is left disabled.
 #ifndef USE_X86
    if (CpuSupportsAvx())
    {
@@ -37,6 +39,19 @@ PrimorialWorker::PrimorialWorker(uint32_t myId, App *theApp) : Worker(myId, theA
    }
 #endif
 
+#ifdef USE_X86
+   ib_UseIfma = CpuSupportsAvx512Ifma();
+   ib_UseAvx512 = CpuSupportsAvx512();
+#endif
+
+   UseMontgomeryContext();
+
+   // Calibrating the lanes would only time the IFMA code for most ranges
+#ifdef USE_X86
+   if (!ib_UseIfma)
+#endif
+      UseLanes();
+
    ib_Initialized = true;
 }
 
@@ -51,41 +66,57 @@ void  PrimorialWorker::CleanUp(void)
 
 void  PrimorialWorker::TestMegaPrimeChunk(void)
 {
-   uint64_t  ps[4], maxPrime = ip_App->GetMaxPrime();
+#ifdef USE_X86
+   if (ib_UseIfma && il_PrimeList[ii_PrimesInList-1] < PMAX_MAX_52BIT)
+   {
+      TestMegaPrimeChunkIfma();
+      return;
+   }
+#endif
+
+   uint32_t lanes = GetLanes();
+
+   if (lanes == 16)
+      TestPrimeGroups<16>();
+   else if (lanes == 8)
+      TestPrimeGroups<8>();
+   else
+      TestPrimeGroups<4>();
+}
+
+// Test N primes at a time
+template <size_t N>
+void  PrimorialWorker::TestPrimeGroups(void)
+{
+   uint64_t  ps[N], maxPrime = ip_App->GetMaxPrime();
+   MpResVector<N> resGaps[MAX_GAPS];
 
-   for (uint32_t plIdx=0; plIdx<ii_PrimesInList; plIdx+=4)
+   for (uint32_t plIdx=0; plIdx<ii_PrimesInList; plIdx+=N)
    {
-      ps[0] = il_PrimeList[plIdx+0];
-      ps[1] = il_PrimeList[plIdx+1];
-      ps[2] = il_PrimeList[plIdx+2];
-      ps[3] = il_PrimeList[plIdx+3];
+      for (size_t k = 0; k < N; ++k)
+         ps[k] = il_PrimeList[plIdx+k];
 
-      MpArithVec mp(ps);
+      MpArithVector<N> mp(ik_MpContext, plIdx);
 
-      const MpResVec pOne = mp.one();
-      const MpResVec mOne = mp.sub(mp.zero(), pOne);
+      const MpResVector<N> pOne = mp.one();
+      const MpResVector<N> mOne = mp.sub(mp.zero(), pOne);
       uint32_t pIdx, primeGap;
 
-      ip_ResGaps[2] = mp.nToRes(2);
+      resGaps[2] = mp.nToRes(2);
       for (uint32_t i=4; i<=ii_BiggestGap; i+=2)
-         ip_ResGaps[i] = mp.add(ip_ResGaps[i-2], ip_ResGaps[2]);
+         resGaps[i] = mp.add(resGaps[i-2], resGaps[2]);
 
       // ri = residue of primorial
       // rf = residue of primorial#
-      MpResVec ri = mp.nToRes(FIRST_PRIMORIAL_PRIME);
-      MpResVec rf = mp.nToRes(FIRST_PRIMORIAL);
+      MpResVector<N> ri = mp.nToRes(FIRST_PRIMORIAL_PRIME);
+      MpResVector<N> rf = mp.nToRes(FIRST_PRIMORIAL);
 
       for (pIdx=0; ip_PrimorialPrimes[pIdx]<ii_MinPrimorial; pIdx++)
       {
          primeGap = ip_PrimorialPrimeGaps[pIdx];
 
-         ri = mp.add(ri, ip_ResGaps[primeGap]);
+         ri = mp.add(ri, resGaps[primeGap]);
          rf = mp.mul(rf, ri);
-
-if (ps[0] == 1000121) printf("%llu %llu\n", ri[0], rf[0]);
-if (ps[1] == 1000121) printf("%llu %llu\n", ri[1], rf[1]);
-if (ps[2] == 1000121) printf("%llu %llu\n", ri[2], rf[2]);
-if (ps[3] == 1000121) printf("%llu %llu\n", ri[3], rf[3]);
       }
 
       // Primorial and check if primorial# (mod p) = +/-1
@@ -93,12 +124,12 @@ if (ps[3] == 1000121) printf("%llu %llu\n", ri[3], rf[3]);
       {
          primeGap = ip_PrimorialPrimeGaps[pIdx];
 
-         ri = mp.add(ri, ip_ResGaps[primeGap]);
+         ri = mp.add(ri, resGaps[primeGap]);
          rf = mp.mul(rf, ri);
 
-         if (MpArithVec::at_least_one_is_equal(rf, pOne) || MpArithVec::at_least_one_is_equal(rf, mOne))
+         if (MpArithVector<N>::at_least_one_is_equal(rf, pOne) || MpArithVector<N>::at_least_one_is_equal(rf, mOne))
          {
-            for (size_t k = 0; k < VECTOR_SIZE; ++k)
+            for (size_t k = 0; k < N; ++k)
             {
                if (rf[k] == pOne[k])
                   ip_PrimorialApp->ReportFactor(ps[k], ip_PrimorialPrimes[pIdx], -1);
@@ -108,20 +139,78 @@ if (ps[3] == 1000121) printf("%llu %llu\n", ri[3], rf[3]);
             }
          }
 
-if (ps[0] == 1000121) printf("%llu %llu\n", ri[0], rf[0]);
-if (ps[1] == 1000121) printf("%llu %llu\n", ri[1], rf[1]);
-if (ps[2] == 1000121) printf("%llu %llu\n", ri[2], rf[2]);
-if (ps[3] == 1000121) printf("%llu %llu\n", ri[3], rf[3]);
+         pIdx++;
+      }
+
+      SetLargestPrimeTested(ps[N-1], N);
+
+      if (ps[N-1] >= maxPrime)
+         break;
+   }
+}
+
+#ifdef USE_X86
+// This is the same as TestMegaPrimeChunk(), but for 8 primes at a time with AVX-512 IFMA
+IFMA_TARGET void  PrimorialWorker::TestMegaPrimeChunkIfma(void)
+{
+   uint64_t  ps[IFMA_VECTOR_SIZE], maxPrime = ip_App->GetMaxPrime();
+   MpResVectorIfma resGaps[MAX_GAPS];
+
+   for (uint32_t plIdx=0; plIdx<ii_PrimesInList; plIdx+=IFMA_VECTOR_SIZE)
+   {
+      for (size_t k = 0; k < IFMA_VECTOR_SIZE; ++k)
+         ps[k] = il_PrimeList[plIdx+k];
+
+      MpArithVectorIfma mp(ps);
+
+      const MpResVectorIfma pOne = mp.one();
+      const MpResVectorIfma mOne = mp.sub(mp.zero(), pOne);
+      uint32_t pIdx, primeGap;
+
+      resGaps[2] = mp.nToRes(2);
+      for (uint32_t i=4; i<=ii_BiggestGap; i+=2)
+         resGaps[i] = mp.add(resGaps[i-2], resGaps[2]);
+
+      MpResVectorIfma ri = mp.nToRes(FIRST_PRIMORIAL_PRIME);
+      MpResVectorIfma rf = mp.nToRes(FIRST_PRIMORIAL);
+
+      for (pIdx=0; ip_PrimorialPrimes[pIdx]<ii_MinPrimorial; pIdx++)
+      {
+         primeGap = ip_PrimorialPrimeGaps[pIdx];
+
+         ri = mp.add(ri, resGaps[primeGap]);
+         rf = mp.mul(rf, ri);
+      }
+
+      while (ip_PrimorialPrimes[pIdx] > 0)
+      {
+         primeGap = ip_PrimorialPrimeGaps[pIdx];
+
+         ri = mp.add(ri, resGaps[primeGap]);
+         rf = mp.mul(rf, ri);
+
+         if (MpArithVectorIfma::at_least_one_is_equal(rf, pOne) || MpArithVectorIfma::at_least_one_is_equal(rf, mOne))
+         {
+            for (size_t k = 0; k < IFMA_VECTOR_SIZE; ++k)
+            {
+               if (rf[k] == pOne[k])
+                  ip_PrimorialApp->ReportFactor(ps[k], ip_PrimorialPrimes[pIdx], -1);
+
+               if (rf[k] == mOne[k])
+                  ip_PrimorialApp->ReportFactor(ps[k], ip_PrimorialPrimes[pIdx], +1);
+            }
+         }
 
          pIdx++;
       }
 
-      SetLargestPrimeTested(ps[3], 4);
+      SetLargestPrimeTested(ps[IFMA_VECTOR_SIZE-1], IFMA_VECTOR_SIZE);
 
-      if (ps[3] >= maxPrime)
+      if (ps[IFMA_VECTOR_SIZE-1] >= maxPrime)
          break;
    }
 }
+#endif
 
 void  PrimorialWorker::ExtractFactors(uint64_t p)
 {
@@ -164,56 +253,67 @@ void  PrimorialWorker::ExtractFactors(uint64_t p)
 #ifdef USE_X86
 void  PrimorialWorker::TestMiniPrimeChunk(uint64_t *miniPrimeChunk)
 {
-   double __attribute__((aligned(32))) dps[AVX_ARRAY_SIZE];
-   double __attribute__((aligned(32))) reciprocals[AVX_ARRAY_SIZE];
-   double __attribute__((aligned(32))) nextPrime[1];
+   if (ib_UseAvx512)
+      TestPrimesAVX<AVX512_ARRAY_SIZE>(miniPrimeChunk);
+   else
+      TestPrimesAVX<AVX_ARRAY_SIZE>(miniPrimeChunk);
+}
+
+// Test N primes at a time
+template <uint32_t N>
+void  PrimorialWorker::TestPrimesAVX(uint64_t *miniPrimeChunk)
+{
+   double __attribute__((aligned(64))) dps[N];
+   double __attribute__((aligned(64))) reciprocals[N];
+   double __attribute__((aligned(64))) nextPrime[1];
    uint32_t idx;
 
    // compute the inverse of b (mod p)
-   for (int i=0; i<AVX_ARRAY_SIZE; i++)
+   for (uint32_t i=0; i<N; i++)
       dps[i] = (double) miniPrimeChunk[i];
 
-   avx_compute_reciprocal(dps, reciprocals);
+   AvxKernel<N>::compute_reciprocal(dps, reciprocals);
 
    nextPrime[0] = (double) FIRST_PRIMORIAL;
 
-   avx_set_1a(nextPrime);
+   AvxKernel<N>::set_1a(nextPrime);
 
    for (idx=0; idx<ii_NumberOfPrimorialPrimes; idx++)
    {
       nextPrime[0] = id_PrimorialPrimes[idx];
 
-      avx_set_1b(nextPrime);
-      avx_mulmod(dps, reciprocals);
+      AvxKernel<N>::set_1b(nextPrime);
+      AvxKernel<N>::mulmod(dps, reciprocals);
 
-      CheckAVXResult(miniPrimeChunk, dps, ip_PrimorialPrimes[idx]);
+      CheckAVXResult<N>(miniPrimeChunk, dps, ip_PrimorialPrimes[idx]);
    }
 }
 
+template <uint32_t N>
 void  PrimorialWorker::CheckAVXResult(uint64_t *ps, double *dps, uint32_t primorial)
 {
    uint32_t idx;
-   double __attribute__((aligned(32))) comparator[1];
-   double __attribute__((aligned(32))) rems[AVX_ARRAY_SIZE];
+   double __attribute__((aligned(64))) comparator[1];
+   double __attribute__((aligned(64))) rems[N];
 
    comparator[0] = 1.0;
 
-   // Only go further if one or more of the 16 primes yielded a factor for this n
-   if (avx_pos_compare_1v(comparator) > 0)
+   // Only go further if one or more of the N primes yielded a factor for this n
+   if (AvxKernel<N>::pos_compare_1v(comparator) > 0)
    {
-      avx_get_16a(rems);
+      AvxKernel<N>::get_na(rems);
 
-      for (idx=0; idx<AVX_ARRAY_SIZE; idx++)
+      for (idx=0; idx<N; idx++)
          if (rems[idx] == comparator[0])
             ip_PrimorialApp->ReportFactor(ps[idx], primorial, -1);
    }
 
-   // Only go further if one or more of the 16 primes yielded a factor for this n
-   if (avx_neg_compare_1v(comparator, dps))
+   // Only go further if one or more of the N primes yielded a factor for this n
+   if (AvxKernel<N>::neg_compare_1v(comparator, dps))
    {
-      avx_get_16a(rems);
+      AvxKernel<N>::get_na(rems);
 
-      for (idx=0; idx<AVX_ARRAY_SIZE; idx++)
+      for (idx=0; idx<N; idx++)
          if (rems[idx] == dps[idx] - comparator[0])
             ip_PrimorialApp->ReportFactor(ps[idx], primorial, +1);
    }
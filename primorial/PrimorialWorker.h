@@ -12,6 +12,7 @@
 #include "PrimorialApp.h"
 #include "../core/Worker.h"
 #include "../core/MpArithVector.h"
+#include "../core/MpArithVectorIfma.h"
 
 // The first prime gap over 300 is at 2e9.  Unlikely anyone will ever search that far
 // in the foreseeable future.
@@ -32,11 +33,23 @@ protected:
    PrimorialApp     *ip_PrimorialApp;
 
 private:
+   template <size_t N>
+   void              TestPrimeGroups(void);
+
    void              ExtractFactors(uint64_t p);
 
 #ifdef USE_X86
+   // N is AVX_ARRAY_SIZE for the ymm routines or AVX512_ARRAY_SIZE for the zmm routines
+   template <uint32_t N>
+   void              TestPrimesAVX(uint64_t *ps);
+   template <uint32_t N>
    void              CheckAVXResult(uint64_t *ps, double *dps, uint32_t theN);
    void              VerifyAVXFactor(uint64_t p, uint32_t theN, int32_t theC);
+
+   void              TestMegaPrimeChunkIfma(void);
+
+   bool              ib_UseIfma;
+   bool              ib_UseAvx512;
 #endif
 
    uint32_t          ii_MinPrimorial;
@@ -48,8 +61,6 @@ private:
 
    uint16_t         *ip_PrimorialPrimeGaps;
    uint16_t          ii_BiggestGap;
-
-   MpResVec          ip_ResGaps[MAX_GAPS];
 };
 
 #endif
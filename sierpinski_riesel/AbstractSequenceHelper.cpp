@@ -40,7 +40,18 @@ AbstractSequenceHelper::AbstractSequenceHelper(App *theApp, uint64_t largestPrim
 
 void     AbstractSequenceHelper::CleanUp(void)
 {
-   xfree(ip_Subsequences);
+   FreeSubsequences();
+}
+
+void     AbstractSequenceHelper::FreeSubsequences(void)
+{
+   if (ip_Subsequences == 0)
+      return;
+
+   delete [] ip_Subsequences;
+
+   ip_Subsequences = 0;
+   ii_SubsequenceCount = 0;
 }
 
 uint64_t    AbstractSequenceHelper::MakeSubsequencesForNewSieve(void)
@@ -63,7 +74,7 @@ uint64_t    AbstractSequenceHelper::MakeSubsequencesForNewSieve(void)
       {
          if (seqPtr->nTerms[NBIT(n)])
          {
-            ssPtr->mTerms[NBIT(n)] = true;
+            ssPtr->mTerms.Set(NBIT(n));
             termCount++;
          }
       }
@@ -87,11 +98,8 @@ void        AbstractSequenceHelper::MakeSubsequencesForOldSieve(uint64_t expecte
    uint32_t  ssIdx;
    seq_t    *seqPtr;
 
-   if (ip_Subsequences)
-      xfree(ip_Subsequences);
+   FreeSubsequences();
 
-   ip_Subsequences = 0;
-   ii_SubsequenceCount = 0;
    ii_SubsequenceCapacity = 0;
 
    ii_BestQ = FindBestQ(expectedSubsequences);
@@ -145,7 +153,7 @@ void        AbstractSequenceHelper::MakeSubsequencesForOldSieve(uint64_t expecte
          {
             r = n % ii_BestQ;
             ssIdx = rss[r];
-            ip_Subsequences[ssIdx].mTerms[n/ii_BestQ - ii_MinM] = true;
+            ip_Subsequences[ssIdx].mTerms.Set(n/ii_BestQ - ii_MinM);
             countedTerms++;
          }
 
@@ -169,7 +177,8 @@ void        AbstractSequenceHelper::MakeSubsequencesForOldSieve(uint64_t expecte
 
 void      AbstractSequenceHelper::CreateEmptySubsequences(uint32_t subsequenceCount)
 {
-   ip_Subsequences = (subseq_t *) xmalloc(subsequenceCount * sizeof(subseq_t));
+   // Use new so that mTerms is constructed.  The () zero-initializes the other fields.
+   ip_Subsequences = new subseq_t[subsequenceCount]();
 
    ii_SubsequenceCount = 0;
    ii_SubsequenceCapacity = subsequenceCount;
@@ -209,7 +218,7 @@ uint32_t  AbstractSequenceHelper::AddSubsequence(seq_t *seqPtr, uint32_t q, uint
    ssPtr->k = seqPtr->k;
    ssPtr->c = seqPtr->c;
    ssPtr->q = q;
-   ssPtr->mTerms.resize(mTermCount, false);
+   ssPtr->mTerms.Resize(mTermCount, false);
 
    if (seqPtr->ssCount > ii_MaxSubsequenceCount)
       ii_MaxSubsequenceCount = seqPtr->ssCount;
@@ -259,17 +268,17 @@ void  AbstractSequenceHelper::ChooseSteps(uint32_t Q, uint32_t s, uint32_t &baby
 
    fesetround(roundingMode);
 
-   if (m > HASH_MAX_ELTS)
+   // Only the chained hash table and the GPU kernels have a limit that matters here.
+   // When there is one, restrict m to it (suboptimal baby/giant-step ratio).
+   uint32_t maxM = ((SierpinskiRieselApp *) ip_App)->GetMaxHashTableElements();
+
+   if (m > maxM)
    {
-     // There are three ways to handle this undesirable case:
-     //   1. Allow m > HASH_MAX_ELTS (undersize hash table).
-     //   2. Restrict m <= HASH_MAX_ELTS (suboptimal baby/giant-step ratio).
-     //   3. Recompile with SHORT_HASHTABLE=0
-     M = ceil((double)r/HASH_MAX_ELTS);
+     M = ceil((double)r/maxM);
      m = ceil((double)r/M);
    }
 
-   assert(m <= HASH_MAX_ELTS);
+   assert(m <= maxM);
 
    babySteps = m;
    giantSteps = M;
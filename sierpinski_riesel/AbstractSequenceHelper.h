@@ -11,6 +11,7 @@
 
 #include "../core/Worker.h"
 #include "../core/MpArithVector.h"
+#include "../core/TermBitmap.h"
 
 #define SP_COUNT   3
 typedef enum { SP_NO_PARITY = 999, SP_MIXED = 0, SP_EVEN = 1, SP_ODD = 2} sp_t;
@@ -33,7 +34,7 @@ typedef struct
    uint32_t     ssIdxFirst;   // index of first subsequence for the sequence
    uint32_t     ssIdxLast;    // index of first subsequence for the sequence
 
-   std::vector<bool> nTerms;  // remaining n for this sequences
+   TermBitmap   nTerms;       // remaining n for this sequences
 
    void        *next;         // points to the next sequence
 } seq_t;
@@ -46,7 +47,7 @@ typedef struct
    uint64_t     k;            // k in k*b^n+c
    int64_t      c;            // c in k*b^n+c
    uint16_t     q;
-   std::vector<bool> mTerms;  // remaining m for this sub-sequence
+   TermBitmap   mTerms;       // remaining m for this sub-sequence
 
    uint32_t     babySteps;    // baby steps for CIsOne logic
    uint32_t     giantSteps;   // giant steps for CIsOne logic
@@ -84,6 +85,7 @@ public:
 protected:
    void              CreateEmptySubsequences(uint32_t subsequenceCount);
    uint32_t          AddSubsequence(seq_t *seqPtr, uint32_t q, uint32_t mTermCount);
+   void              FreeSubsequences(void);
 
    virtual uint32_t  FindBestQ(uint32_t &expectedSubsequences) = 0;
 
@@ -12,6 +12,12 @@
 #include "AbstractWorker.h"
 #include "../x86_asm/sse-asm-x86.h"
 
+uint32_t AbstractWorker::ii_SetupTimer = Counters::Register("discrete log setup", CT_TIMER);
+uint32_t AbstractWorker::ii_BabyStepTimer = Counters::Register("baby step time", CT_TIMER);
+uint32_t AbstractWorker::ii_GiantStepTimer = Counters::Register("giant step time", CT_TIMER);
+uint32_t AbstractWorker::ii_BabyStepCounter = Counters::Register("baby steps", CT_COUNT);
+uint32_t AbstractWorker::ii_GiantStepCounter = Counters::Register("giant steps", CT_COUNT);
+
 AbstractWorker::AbstractWorker(uint32_t myId, App *theApp, AbstractSequenceHelper *appHelper) : Worker(myId, theApp)
 {
    ip_SierpinskiRieselApp = (SierpinskiRieselApp *) theApp;
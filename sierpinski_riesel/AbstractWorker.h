@@ -42,6 +42,13 @@ protected:
 
    uint32_t             ii_BestQ;
 
+   // These show where the discrete log spends its time, see Counters.h
+   static uint32_t      ii_SetupTimer;
+   static uint32_t      ii_BabyStepTimer;
+   static uint32_t      ii_GiantStepTimer;
+   static uint32_t      ii_BabyStepCounter;
+   static uint32_t      ii_GiantStepCounter;
+
    // 1/a (mod p)  if a > 0, 0 othewise. Assumes a < p and gcd(a,p)=1.
    // Thanks to the folks at mersenneforum.org.
    // See http://www.mersenneforum.org/showthread.php?p=58252.
@@ -735,7 +735,7 @@ uint32_t   AlgebraicFactorHelper::CheckAndLogAlgebraicFactor(seq_t *seqPtr, uint
    if (!seqPtr->nTerms[n-ii_MinN])
       return 0;
 
-   seqPtr->nTerms[n-ii_MinN] = false;
+   seqPtr->nTerms.Clear(n-ii_MinN);
 
    if (!ip_AlgebraicFactorFile)
    {
@@ -15,6 +15,9 @@
 
 #define N_TERM(q, i, j)      ((ii_SieveLow + (j) + (i)*babySteps)*ii_BestQ + q)
 
+// The number of subsequences whose hash table slots are prefetched before looking them up
+#define LOOKUP_BLOCK_SIZE    64
+
 CisOneWithMultipleSequencesWorker::CisOneWithMultipleSequencesWorker(uint32_t myId, App *theApp, AbstractSequenceHelper *appHelper) : AbstractWorker(myId, theApp, appHelper)
 {
    ip_FirstSequence = appHelper->GetFirstSequenceAndSequenceCount(ii_SequenceCount);
@@ -22,6 +25,8 @@ CisOneWithMultipleSequencesWorker::CisOneWithMultipleSequencesWorker(uint32_t my
 
    ip_CisOneHelper = (CisOneWithMultipleSequencesHelper *) appHelper;
 
+   UseMontgomeryContext();
+
    ii_BaseMultiple = ip_CisOneHelper->GetBaseMultiple();
    ii_LimitBase = ip_CisOneHelper->GetLimitBase();
    ii_PowerResidueLcm = ip_CisOneHelper->GetPowerResidueLcm();
@@ -32,13 +37,17 @@ CisOneWithMultipleSequencesWorker::CisOneWithMultipleSequencesWorker(uint32_t my
 
 void  CisOneWithMultipleSequencesWorker::CleanUp(void)
 {
-   delete ip_HashTable;
+   for (uint32_t pIdx=0; pIdx<4; pIdx++)
+      delete ip_HashTable[pIdx];
 
-   xfree(ip_UsableSubsequences);
+   delete [] ip_LegendreDivisors;
 
-   xfree(resBD);
-   xfree(resBJ);
-   xfree(resX);
+   xfree(ip_UsableSeqPtrs);
+   xfree(ip_UsableQs);
+   xfree(ip_UsableResBDCK);
+
+   xfree(mBD);
+   xfree(mX);
 }
 
 void  CisOneWithMultipleSequencesWorker::Prepare(uint64_t largestPrimeTested, uint32_t bestQ)
@@ -46,11 +55,21 @@ void  CisOneWithMultipleSequencesWorker::Prepare(uint64_t largestPrimeTested, ui
    ii_BestQ = bestQ;
    ii_SieveLow = ii_MinN / ii_BestQ;
 
-   resX = (MpRes *) xmalloc((ii_PowerResidueLcm+5) * sizeof(MpRes));
-   resBD = (MpRes *) xmalloc((ii_SubsequenceCount+4)*sizeof(MpRes));
-   resBJ = (MpRes *) xmalloc((ii_SubsequenceCount+4)*sizeof(MpRes));
+   mX = (MpResVec *) xmalloc((ii_PowerResidueLcm+5) * sizeof(MpResVec));
+   mBD = (MpResVec *) xmalloc((ii_BestQ+ii_SubsequenceCount+4)*sizeof(MpResVec));
+
+   ip_UsableSeqPtrs = (seq_t **) xmalloc(8*ii_SubsequenceCount*sizeof(seq_t *));
+   ip_UsableQs = (uint32_t *) xmalloc(8*ii_SubsequenceCount*sizeof(uint32_t));
+   ip_UsableResBDCK = (MpRes *) xmalloc(8*ii_SubsequenceCount*sizeof(MpRes));
 
-   ip_UsableSubsequences = (useable_subseq_t *) xmalloc(ii_SubsequenceCount*sizeof(useable_subseq_t));
+   for (uint32_t slot=0; slot<8; slot++)
+   {
+      ip_PendingPrimes[slot].seqPtrs = &ip_UsableSeqPtrs[slot*ii_SubsequenceCount];
+      ip_PendingPrimes[slot].qs = &ip_UsableQs[slot*ii_SubsequenceCount];
+      ip_PendingPrimes[slot].resBDCK = &ip_UsableResBDCK[slot*ii_SubsequenceCount];
+   }
+
+   ii_PendingCount = 0;
 
    ip_DivisorShifts = ip_CisOneHelper->GetDivisorShifts();
    ip_PowerResidueIndices = ip_CisOneHelper->GetPowerResidueIndices();
@@ -67,14 +86,19 @@ void  CisOneWithMultipleSequencesWorker::Prepare(uint64_t largestPrimeTested, ui
    ip_Legendre = ip_CisOneHelper->GetLegendre();
    ip_LegendreTable = ip_CisOneHelper->GetLegendreTable();
 
-   ip_HashTable = new HashTable(ii_MaxBabySteps);
+   for (uint32_t pIdx=0; pIdx<4; pIdx++)
+      ip_HashTable[pIdx] = new HashTable(ii_MaxBabySteps, ip_SierpinskiRieselApp->GetHashTableType());
+
+   ip_LegendreDivisors = new FastDivisor[ii_SequenceCount];
 
    ib_AllSequencesHaveLegendreTables = true;
    for (uint32_t seqIdx=0; seqIdx<ii_SequenceCount; seqIdx++)
    {
       legendre_t *legendrePtr = &ip_Legendre[seqIdx];
 
-      if (!legendrePtr->haveMap)
+      if (legendrePtr->haveMap)
+         ip_LegendreDivisors[seqIdx].SetDivisor(legendrePtr->mod);
+      else
          ib_AllSequencesHaveLegendreTables = false;
    }
 }
@@ -82,7 +106,9 @@ void  CisOneWithMultipleSequencesWorker::Prepare(uint64_t largestPrimeTested, ui
 void  CisOneWithMultipleSequencesWorker::TestMegaPrimeChunk(void)
 {
    uint64_t maxPrime = ip_App->GetMaxPrime();
-   uint64_t p;
+   uint64_t ps[4], largestPrime = 0;
+   bool     isDuplicate[4];
+   uint32_t idx, pIdx, primesTested = 0;
 
 #if defined(USE_OPENCL) || defined(USE_METAL)
    bool     switchToGPUWorkers = false;
@@ -99,65 +125,132 @@ void  CisOneWithMultipleSequencesWorker::TestMegaPrimeChunk(void)
    }
 #endif
 
-   for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx++)
+   // The list is padded to a multiple of 4 with copies of the last prime
+   for (idx=0; idx<ii_PrimesInList; idx+=4)
    {
-      p = il_PrimeList[pIdx];
+      for (pIdx=0; pIdx<4; pIdx++)
+      {
+         ps[pIdx] = il_PrimeList[idx+pIdx];
 
-      TestSinglePrime(p);
+         isDuplicate[pIdx] = (pIdx > 0 && ps[pIdx] == ps[pIdx-1]);
 
-      SetLargestPrimeTested(p, 1);
+         if (!isDuplicate[pIdx])
+            primesTested++;
+      }
 
-      if (p >= maxPrime)
-      {
-#if defined(USE_OPENCL) || defined(USE_METAL)
-         // This can only be true if we can switch to only running GPU workers.  Since this
-         // is a CPU worker.  Its life effectively ends upon return from this method.
-         if (switchToGPUWorkers)
-         {
-            ip_SierpinskiRieselApp->UseGpuWorkersUponRebuild();
-            ip_SierpinskiRieselApp->SetRebuildNeeded();
-         }
-#endif
+      MpArithVec mp(ik_MpContext, idx);
 
-         return;
-      }
+      largestPrime = ps[3];
+
+      SetupPrimes(ps, isDuplicate, mp, idx);
+
+      if (largestPrime >= maxPrime)
+         break;
+   }
+
+   // No prime is tested until all primes before it have been tested
+   if (ii_PendingCount > 0)
+      TestPendingPrimes(ii_PendingCount);
+
+   SetLargestPrimeTested(largestPrime, primesTested);
+
+#if defined(USE_OPENCL) || defined(USE_METAL)
+   // This can only be true if we can switch to only running GPU workers.  Since this
+   // is a CPU worker.  Its life effectively ends upon return from this method.
+   if (largestPrime >= maxPrime && switchToGPUWorkers)
+   {
+      ip_SierpinskiRieselApp->UseGpuWorkersUponRebuild();
+      ip_SierpinskiRieselApp->SetRebuildNeeded();
    }
+#endif
 }
+
 void  CisOneWithMultipleSequencesWorker::TestMiniPrimeChunk(uint64_t *miniPrimeChunk)
 {
    FatalError("CisOneWithMultipleSequencesWorker::TestMiniPrimeChunk not implemented");
 }
 
-void  CisOneWithMultipleSequencesWorker::TestSinglePrime(uint64_t p)
+void  CisOneWithMultipleSequencesWorker::SetupPrimes(uint64_t *p, bool *isDuplicate, MpArithVec mp, uint32_t primeIdx)
 {
-   uint64_t invBase;
-   uint32_t k, orderOfB, ssCount;
-   uint32_t babySteps, giantSteps;
-   uint32_t i, j;
+   uint64_t startNS = Counters::StartTimer();
 
-   MpArith mp(p);
-
-   // compute 1/base (mod p)
-   invBase = invmod64(ii_Base, p);
-
-   MpRes resBase = mp.nToRes(ii_Base);
-   MpRes resInvBase = mp.nToRes(invBase);
+   MpResVec resBase = mp.nToRes((uint64_t) ii_Base);
+   MpResVec resInvBase = mp.inv(resBase);
 
    // -ckb^d is an r-th power residue for at least one term (k*b^d)*(b^Q)^(n/Q)+c of this subsequence
    ClimbLadder(mp, resBase);
 
-   ssCount = SetupDiscreteLog(mp, resBase, resInvBase);
+   // This adds the primes with at least one usable subsequence to ip_PendingPrimes
+   SetupDiscreteLog(mp, resInvBase, isDuplicate, primeIdx);
 
-   // If no subsequences for this p, then no factors, so return
-   if (ssCount == 0)
-      return;
+   Counters::StopTimer(ii_SetupTimer, startNS);
+
+   if (ii_PendingCount >= 4)
+      TestPendingPrimes(4);
+}
+
+// Test the first primeCount pending primes, then move the others to the front
+void  CisOneWithMultipleSequencesWorker::TestPendingPrimes(uint32_t primeCount)
+{
+   uint64_t   p[4];
+   uint32_t   orderOfB[4];
+   uint32_t   babySteps, pIdx;
+   MpResVec   resInvBase;
+   multi_pending_prime_t *pending;
+
+   // Lanes beyond primeCount are copies of the last prime
+   for (pIdx=0; pIdx<4; pIdx++)
+   {
+      pending = &ip_PendingPrimes[pIdx < primeCount ? pIdx : primeCount - 1];
+
+      p[pIdx] = pending->p;
+      resInvBase[pIdx] = pending->resInvBase;
+   }
+
+   MpArithVec mp(p);
+
+   uint64_t startNS = Counters::StartTimer();
+
+   BabySteps(mp, resInvBase, primeCount, ii_MaxBabySteps, orderOfB);
+
+   Counters::StopTimer(ii_BabyStepTimer, startNS);
 
-   ip_HashTable->Clear();
+   for (pIdx=0; pIdx<primeCount; pIdx++)
+   {
+      babySteps = ip_Subsequences[ip_PendingPrimes[pIdx].ssCount-1].babySteps;
+
+      Counters::Add(ii_BabyStepCounter, (orderOfB[pIdx] > 0 ? orderOfB[pIdx] : babySteps));
+      ip_HashTable[pIdx]->CountProbes();
+   }
+
+   startNS = Counters::StartTimer();
+
+   for (pIdx=0; pIdx<primeCount; pIdx++)
+      GiantSteps(&ip_PendingPrimes[pIdx], ip_HashTable[pIdx], orderOfB[pIdx]);
+
+   Counters::StopTimer(ii_GiantStepTimer, startNS);
+
+   for (pIdx=primeCount; pIdx<ii_PendingCount; pIdx++)
+   {
+      multi_pending_prime_t waiting = ip_PendingPrimes[pIdx - primeCount];
 
-   babySteps = ip_Subsequences[ssCount-1].babySteps;
-   giantSteps = ip_Subsequences[ssCount-1].giantSteps;
+      ip_PendingPrimes[pIdx - primeCount] = ip_PendingPrimes[pIdx];
+      ip_PendingPrimes[pIdx] = waiting;
+   }
 
-   orderOfB = BabySteps(mp, resBase, resInvBase, ii_MaxBabySteps);
+   ii_PendingCount -= primeCount;
+}
+
+void  CisOneWithMultipleSequencesWorker::GiantSteps(multi_pending_prime_t *pending, HashTable *hashTable, uint32_t orderOfB)
+{
+   uint64_t   p = pending->p;
+   uint32_t   ssCount = pending->ssCount;
+   uint32_t   babySteps = ip_Subsequences[ssCount-1].babySteps;
+   uint32_t   giantSteps = ip_Subsequences[ssCount-1].giantSteps;
+   uint32_t   i, j, k, kFirst, kLast;
+   seq_t    **seqPtrs = pending->seqPtrs;
+   uint32_t  *qs = pending->qs;
+   MpRes     *resBDCK = pending->resBDCK;
 
    if (orderOfB > 0)
    {
@@ -165,126 +258,209 @@ void  CisOneWithMultipleSequencesWorker::TestSinglePrime(uint64_t p)
       // determine every solution for this p, so no giant steps are neede
       for (k=0; k<ssCount; k++)
       {
-          j = ip_HashTable->Lookup(ip_UsableSubsequences[k].resBDCK);
+          j = hashTable->Lookup(resBDCK[k]);
 
           while (j < babySteps * giantSteps)
           {
-             ip_SierpinskiRieselApp->ReportFactor(p, ip_UsableSubsequences[k].seqPtr, N_TERM(ip_UsableSubsequences[k].q, 0, j), true);
+             ip_SierpinskiRieselApp->ReportFactor(p, seqPtrs[k], N_TERM(qs[k], 0, j), true);
 
              j += orderOfB;
           }
       }
+
+      return;
    }
-   else
+
+   // First giant step
+   for (kFirst=0; kFirst<ssCount; kFirst=kLast)
    {
-      // First giant step
-      for (k=0; k<ssCount; k++)
+      kLast = (kFirst + LOOKUP_BLOCK_SIZE < ssCount ? kFirst + LOOKUP_BLOCK_SIZE : ssCount);
+
+      for (k=kFirst; k<kLast; k++)
+         hashTable->Prefetch(resBDCK[k]);
+
+      for (k=kFirst; k<kLast; k++)
       {
-         j = ip_HashTable->Lookup(ip_UsableSubsequences[k].resBDCK);
+         j = hashTable->Lookup(resBDCK[k]);
 
          if (j != HASH_NOT_FOUND)
-            ip_SierpinskiRieselApp->ReportFactor(p, ip_UsableSubsequences[k].seqPtr, N_TERM(ip_UsableSubsequences[k].q, 0, j), true);
+            ip_SierpinskiRieselApp->ReportFactor(p, seqPtrs[k], N_TERM(qs[k], 0, j), true);
       }
+   }
 
-      // Remaining giant steps
-      if (giantSteps > 1)
-      {
-         MpRes resBQM = mp.pow(resBexpQ, babySteps);
+   // Remaining giant steps
+   if (giantSteps > 1)
+   {
+      MpArith mp(ik_MpContext, pending->primeIdx);
+
+      MpRes resBQM = mp.pow(pending->resBexpQ, babySteps);
 
-         for (i=1; i<giantSteps; i++)
+      for (i=1; i<giantSteps; i++)
+      {
+         // Each lookup is a dependent load from the table, so for each block of
+         // subsequences take the step and prefetch first, then do the lookups
+         for (kFirst=0; kFirst<ssCount; kFirst=kLast)
          {
-            for (k=0; k<ssCount; k++)
+            kLast = (kFirst + LOOKUP_BLOCK_SIZE < ssCount ? kFirst + LOOKUP_BLOCK_SIZE : ssCount);
+
+            for (k=kFirst; k<kLast; k++)
             {
-               ip_UsableSubsequences[k].resBDCK = mp.mul(ip_UsableSubsequences[k].resBDCK, resBQM);
+               resBDCK[k] = mp.mul(resBDCK[k], resBQM);
 
-               j = ip_HashTable->Lookup(ip_UsableSubsequences[k].resBDCK);
+               hashTable->Prefetch(resBDCK[k]);
+            }
+
+            for (k=kFirst; k<kLast; k++)
+            {
+               j = hashTable->Lookup(resBDCK[k]);
 
                if (j != HASH_NOT_FOUND)
-                  ip_SierpinskiRieselApp->ReportFactor(p, ip_UsableSubsequences[k].seqPtr, N_TERM(ip_UsableSubsequences[k].q, i, j), true);
+                  ip_SierpinskiRieselApp->ReportFactor(p, seqPtrs[k], N_TERM(qs[k], i, j), true);
             }
          }
       }
    }
+
+   Counters::Add(ii_GiantStepCounter, giantSteps);
 }
 
-// Assign BJ64[i] = b^i (mod p) for each i in the ladder.
-// Return b^Q (mod p).
-uint32_t  CisOneWithMultipleSequencesWorker::ClimbLadder(MpArith mp, MpRes resBase)
+// Assign mBD[i] = b^i (mod p) for each i in the ladder.  All primes use the same ladder.
+void  CisOneWithMultipleSequencesWorker::ClimbLadder(MpArithVec mp, MpResVec resBase)
 {
    uint32_t  i, j, idx, lLen;
 
    lLen = *ip_AllLadders;
 
    // Precompute b^d (mod p) for 0 <= d <= Q, as necessary
-   resBD[0] = mp.one();
-   resBD[1] = resBase;
-   resBD[2] = mp.mul(resBD[1], resBD[1]);
+   mBD[0] = mp.one();
+   mBD[1] = resBase;
+   mBD[2] = mp.mul(mBD[1], mBD[1]);
 
    i = 2;
    for (j=0; j<lLen; j++)
    {
       idx = ip_AllLadders[j+1];
 
-      resBD[i+idx] = mp.mul(resBD[i], resBD[idx]);
+      mBD[i+idx] = mp.mul(mBD[i], mBD[idx]);
 
       i += idx;
    }
-
-   resBexpQ = resBD[ii_BestQ];
-
-   return resBD[ii_BestQ];
 }
 
-// This function builds the list ii_CSSList[] of subsequences (k*b^d)*(b^Q)^m+c for
-// which p may be a factor (-ckb^d is a quadratic/cubic/quartic/quintic
-// residue with respect to p) and initialises the table D64[] with the
-// values -c/(k*b^d) (mod p). As a side effect, bQ is set to the value b^Q
-// (mod p) for use later in bsgs64(). Returns the number of subsequences listed in ii_CSS[].
-uint32_t  CisOneWithMultipleSequencesWorker::SetupDiscreteLog(MpArith mp, MpRes resBase, MpRes resInvBase)
+// For each lane this builds the list of subsequences (k*b^d)*(b^Q)^m+c for which p may
+// be a factor (-ckb^d is a quadratic/cubic/quartic/quintic residue with respect to p)
+// along with the values -c/(k*b^d) (mod p).  If there is at least one, then p is added
+// to ip_PendingPrimes.
+void  CisOneWithMultipleSequencesWorker::SetupDiscreteLog(MpArithVec mp, MpResVec resInvBase, bool *isDuplicate, uint32_t primeIdx)
 {
-   uint64_t   bm, pShift, p = mp.p();
-   uint32_t   idx, r;
+   uint64_t   p, bm[4], pShift[4];
+   uint32_t   idx, pIdx, ssCount;
+   uint32_t   r[4], shifts[4];
    int32_t    shift;
+   bool       needPowers = false, haveAllOrders;
+   multi_pending_prime_t *pending;
+
+   for (pIdx=0; pIdx<4; pIdx++)
+   {
+      pShift[pIdx] = 0;
 
-   bm = p / 2;
+      if (isDuplicate[pIdx])
+         continue;
 
-   idx = bm % (ii_PowerResidueLcm/2);
-   shift = ip_DivisorShifts[idx];
+      p = mp.p(pIdx);
+      bm[pIdx] = p / 2;
 
-   if (shift == 0)
-      return GetShift0Subsequences(mp, bm);
+      idx = bm[pIdx] % (ii_PowerResidueLcm/2);
+      shift = ip_DivisorShifts[idx];
 
-   if (shift > 0)
-   {
-      // p = 1 (mod s), where s is not a power of 2. Check for r-th power
-      // residues for each prime power divisor r of s.
-      pShift = p / shift;
+      if (shift == 0)
+         continue;
+
+      if (shift > 0)
+      {
+         // p = 1 (mod s), where s is not a power of 2. Check for r-th power
+         // residues for each prime power divisor r of s.
+         pShift[pIdx] = p / shift;
+         shifts[pIdx] = shift;
+      }
+      else
+      {
+         // p = 1 (mod 2^s), where s > 1. Check for r-th power residues for each divisor
+         // r of s. We handle this case seperately to avoid computing p/s using plain division.
+         pShift[pIdx] = p >> (-shift);
+         shifts[pIdx] = 1 << (-shift);
+      }
+
+      needPowers = true;
    }
-   else
+
+   if (needPowers)
    {
-      // p = 1 (mod 2^s), where s > 1. Check for r-th power residues for each divisor
-      // r of s. We handle this case seperately to avoid computing p/s using plain division.
-      pShift = p >> (-shift);
-      shift = 1 << (-shift);
+      // For 0 <= r < s, mX[r] <- 1/(b^r)^((p-1)/s).  A lane with pShift = 0 has
+      // mX[1] = 1 so it gets r = 1 and is then ignored.
+      mX[0] = mp.one();
+      mX[1] = mp.pow(resInvBase, pShift);
+
+      for (pIdx=0; pIdx<4; pIdx++)
+         r[pIdx] = 0;
+
+      // For each lane find the smallest r > 0 such that mX[r] = 1
+      for (idx=1; ; idx++)
+      {
+         haveAllOrders = true;
+
+         for (pIdx=0; pIdx<4; pIdx++)
+         {
+            if (r[pIdx] == 0 && mX[idx][pIdx] == mX[0][pIdx])
+               r[pIdx] = idx;
+
+            if (r[pIdx] == 0)
+               haveAllOrders = false;
+         }
+
+         if (haveAllOrders)
+            break;
+
+         mX[idx+1] = mp.mul(mX[idx], mX[1]);
+      }
    }
 
-   /* For 0 <= r < s, resX[r] <- 1/(b^r)^((p-1)/s) */
-   resX[0] = mp.one();
-   resX[1] = mp.pow(resInvBase, pShift);
+   for (pIdx=0; pIdx<4; pIdx++)
+   {
+      if (isDuplicate[pIdx])
+         continue;
+
+      MpArith laneMp(ik_MpContext, primeIdx + pIdx);
+
+      pending = &ip_PendingPrimes[ii_PendingCount];
+
+      if (pShift[pIdx] == 0)
+         ssCount = GetShift0Subsequences(laneMp, bm[pIdx], pIdx, pending);
+      else
+      {
+         if (shifts[pIdx] % r[pIdx] != 0)
+            FatalError("SetupDiscreteLog issue, shift %% xIdx != 0 (%u %% %u = %u)", shifts[pIdx], r[pIdx], shifts[pIdx] % r[pIdx]);
 
-   for (r=1; resX[r] != resX[0]; r++)
-      resX[r+1] = mp.mul(resX[r], resX[1]);
+         // 1/(b^r)^((p-1)/s)=1 (mod p) therefore (1/(b^r)^((p-1)/s))^y=1 (mod p)
+         // for 0 <= y < s/r. (Could we do more with this?)
+         ssCount = GetShiftXSubsequences(laneMp, pShift[pIdx], bm[pIdx], r[pIdx], pIdx, pending);
+      }
 
-   if (shift % r != 0)
-      FatalError("SetupDiscreteLog issue, shift %% xIdx != 0 (%u %% %u = %u)", shift, r, shift % r);
+      // If no subsequences for this p, then no factors
+      if (ssCount == 0)
+         continue;
 
-   // 1/(b^r)^((p-1)/s)=1 (mod p) therefore (1/(b^r)^((p-1)/s))^y=1 (mod p)
-   // for 0 <= y < s/r. (Could we do more with this?)
+      pending->p = mp.p(pIdx);
+      pending->primeIdx = primeIdx + pIdx;
+      pending->ssCount = ssCount;
+      pending->resInvBase = resInvBase[pIdx];
+      pending->resBexpQ = mBD[ii_BestQ][pIdx];
 
-   return GetShiftXSubsequences(mp, pShift, bm, r);
+      ii_PendingCount++;
+   }
 }
 
-uint32_t  CisOneWithMultipleSequencesWorker::GetShift0Subsequences(MpArith mp, uint64_t bm)
+uint32_t  CisOneWithMultipleSequencesWorker::GetShift0Subsequences(MpArith mp, uint64_t bm, uint32_t pIdx, multi_pending_prime_t *pending)
 {
    uint64_t   p = mp.p();
    int32_t    kcLegendre;
@@ -305,7 +481,7 @@ uint32_t  CisOneWithMultipleSequencesWorker::GetShift0Subsequences(MpArith mp, u
 
       if (legendrePtr->haveMap)
       {
-         qr_mod = bm % legendrePtr->mod;
+         qr_mod = ip_LegendreDivisors[seqPtr->seqIdx].Mod(bm);
          usable = (legendrePtr->oneParityMap[L_BYTE(qr_mod)] & L_BIT(qr_mod));
       }
       else
@@ -338,9 +514,9 @@ uint32_t  CisOneWithMultipleSequencesWorker::GetShift0Subsequences(MpArith mp, u
 
          for (ssIdx=seqPtr->ssIdxFirst; ssIdx<=seqPtr->ssIdxLast; ssIdx++)
          {
-            ip_UsableSubsequences[j].seqPtr = seqPtr;
-            ip_UsableSubsequences[j].q = ip_Subsequences[ssIdx].q;
-            ip_UsableSubsequences[j].resBDCK = mp.mul(resBD[ip_Subsequences[ssIdx].q], resNegCK);
+            pending->seqPtrs[j] = seqPtr;
+            pending->qs[j] = ip_Subsequences[ssIdx].q;
+            pending->resBDCK[j] = mp.mul(mBD[ip_Subsequences[ssIdx].q][pIdx], resNegCK);
 
             j++;
          }
@@ -352,7 +528,7 @@ uint32_t  CisOneWithMultipleSequencesWorker::GetShift0Subsequences(MpArith mp, u
    return j;
 }
 
-uint32_t  CisOneWithMultipleSequencesWorker::GetShiftXSubsequences(MpArith mp, uint64_t pShift, uint64_t bm, uint32_t r)
+uint32_t  CisOneWithMultipleSequencesWorker::GetShiftXSubsequences(MpArith mp, uint64_t pShift, uint64_t bm, uint32_t r, uint32_t pIdx, multi_pending_prime_t *pending)
 {
    uint64_t   p = mp.p();
    int32_t    kcLegendre;
@@ -375,7 +551,7 @@ uint32_t  CisOneWithMultipleSequencesWorker::GetShiftXSubsequences(MpArith mp, u
 
       if (legendrePtr->haveMap)
       {
-         qr_mod = bm % legendrePtr->mod;
+         qr_mod = ip_LegendreDivisors[seqPtr->seqIdx].Mod(bm);
          usable = (legendrePtr->oneParityMap[L_BYTE(qr_mod)] & L_BIT(qr_mod));
       }
       else
@@ -407,10 +583,10 @@ uint32_t  CisOneWithMultipleSequencesWorker::GetShiftXSubsequences(MpArith mp, u
          MpRes resNegCK = mp.nToRes(negCK);
          MpRes resPowNegCK = mp.pow(resNegCK, pShift);
 
-         resX[r] = resPowNegCK;
+         mX[r][pIdx] = resPowNegCK;
 
-         // Find h such that resX[h] = resX[r], i.e. (-ckb^h)^((p-1)/r)=1 (mod p), or h=r if not found
-         for (h=0; resX[r] != resX[h]; h++)
+         // Find h such that mX[h] = mX[r], i.e. (-ckb^h)^((p-1)/r)=1 (mod p), or h=r if not found
+         for (h=0; mX[r][pIdx] != mX[h][pIdx]; h++)
             ;
 
          if (h < r)
@@ -432,9 +608,9 @@ uint32_t  CisOneWithMultipleSequencesWorker::GetShiftXSubsequences(MpArith mp, u
                {
                   ssIdx = subseqs[idx];
 
-                  ip_UsableSubsequences[j].seqPtr = seqPtr;
-                  ip_UsableSubsequences[j].q = ip_Subsequences[ssIdx].q;
-                  ip_UsableSubsequences[j].resBDCK = mp.mul(resBD[ip_Subsequences[ssIdx].q], resNegCK);
+                  pending->seqPtrs[j] = seqPtr;
+                  pending->qs[j] = ip_Subsequences[ssIdx].q;
+                  pending->resBDCK[j] = mp.mul(mBD[ip_Subsequences[ssIdx].q][pIdx], resNegCK);
 
                   j++;
                }
@@ -448,27 +624,47 @@ uint32_t  CisOneWithMultipleSequencesWorker::GetShiftXSubsequences(MpArith mp, u
    return j;
 }
 
-uint32_t  CisOneWithMultipleSequencesWorker::BabySteps(MpArith mp, MpRes resBase, MpRes resInvBase, uint32_t babySteps)
+// This sets orderOfB for each lane to the order of b^Q if it is less than babySteps,
+// otherwise 0.  Only the first primeCount lanes are put into the hash tables.
+void  CisOneWithMultipleSequencesWorker::BabySteps(MpArithVec mp, MpResVec resInvBase, uint32_t primeCount, uint32_t babySteps, uint32_t *orderOfB)
 {
-   MpRes    resInvBaseExpQ;
-   MpRes    resBJ;
-   MpRes    firstResBJ;
-   uint32_t j;
+   uint32_t j, pIdx, lanesLeft = primeCount;
 
    // b <- inv_b^Q (mod p)
-   resInvBaseExpQ = mp.pow(resInvBase, ii_BestQ);
+   MpResVec resInvBaseExpQ = mp.pow(resInvBase, ii_BestQ);
 
-   firstResBJ = resBJ = mp.pow(resInvBaseExpQ, ii_SieveLow);
+   MpResVec firstResBJ = mp.pow(resInvBaseExpQ, ii_SieveLow);
+   MpResVec resBJ = firstResBJ;
+
+   for (pIdx=0; pIdx<4; pIdx++)
+   {
+      orderOfB[pIdx] = 0;
+
+      if (pIdx < primeCount)
+         ip_HashTable[pIdx]->Clear();
+   }
 
    for (j=0; j<babySteps; j++)
    {
-      ip_HashTable->Insert(resBJ, j);
+      for (pIdx=0; pIdx<primeCount; pIdx++)
+         if (orderOfB[pIdx] == 0)
+            ip_HashTable[pIdx]->Insert(resBJ[pIdx], j);
 
       resBJ = mp.mul(resBJ, resInvBaseExpQ);
 
-      if (resBJ == firstResBJ)
-         return j + 1;
-   }
+      if (!MpArithVec::at_least_one_is_equal(resBJ, firstResBJ))
+         continue;
 
-   return 0;
+      for (pIdx=0; pIdx<primeCount; pIdx++)
+      {
+         if (orderOfB[pIdx] == 0 && resBJ[pIdx] == firstResBJ[pIdx])
+         {
+            orderOfB[pIdx] = j + 1;
+            lanesLeft--;
+         }
+      }
+
+      if (lanesLeft == 0)
+         return;
+   }
 }
@@ -14,15 +14,23 @@
 #include "AbstractWorker.h"
 #include "../core/HashTable.h"
 #include "../core/MpArith.h"
+#include "../core/MpArithVector.h"
+#include "../core/FastDivisor.h"
 
 using namespace std;
 
+// The usable subsequences of a prime are kept as a structure of arrays so that the giant
+// steps can multiply all of the resBDCK values in one pass, then look them up in another.
 typedef struct {
-   seq_t            *seqPtr;
-   subseq_t         *ssPtr;
-   uint32_t          q;
-   MpRes             resBDCK;
-} useable_subseq_t;
+   uint64_t          p;
+   uint32_t          primeIdx;      // index of p in il_PrimeList
+   uint32_t          ssCount;
+   MpRes             resInvBase;
+   MpRes             resBexpQ;
+   seq_t           **seqPtrs;       // one per usable subsequence
+   uint32_t         *qs;
+   MpRes            *resBDCK;
+} multi_pending_prime_t;
 
 class CisOneWithMultipleSequencesWorker : public AbstractWorker
 {
@@ -40,29 +48,37 @@ public:
 private:
    sp_t              GetParity(uint64_t p);
 
-   void              TestSinglePrime(uint64_t p);
-
-   uint32_t          SetupDiscreteLog(MpArith mp, MpRes resBase, MpRes resInvBase, MpRes resNegCK);
+   // The primes are set up 4 at a time.  A prime that has at least one usable subsequence
+   // waits until there is one for each lane of the MpArithVec since they all use the same
+   // number of baby steps.  The remaining primes are tested at the end of the chunk.
+   void              SetupPrimes(uint64_t *p, bool *isDuplicate, MpArithVec mp, uint32_t primeIdx);
+   void              TestPendingPrimes(uint32_t primeCount);
 
-   uint32_t          ClimbLadder(MpArith mp, MpRes resBase);
-   uint32_t          SetupDiscreteLog(MpArith mp, MpRes resBase, MpRes resInvBase);
+   void              ClimbLadder(MpArithVec mp, MpResVec resBase);
+   void              SetupDiscreteLog(MpArithVec mp, MpResVec resInvBase, bool *isDuplicate, uint32_t primeIdx);
 
-   uint32_t          GetShift0Subsequences(MpArith mp, uint64_t bm);
-   uint32_t          GetShiftXSubsequences(MpArith mp, uint64_t pShift, uint64_t bm, uint32_t r);
+   uint32_t          GetShift0Subsequences(MpArith mp, uint64_t bm, uint32_t pIdx, multi_pending_prime_t *pending);
+   uint32_t          GetShiftXSubsequences(MpArith mp, uint64_t pShift, uint64_t bm, uint32_t r, uint32_t pIdx, multi_pending_prime_t *pending);
 
-   uint32_t          BabySteps(MpArith mp, MpRes resBase, MpRes resInvBase, uint32_t babySteps);
+   void              BabySteps(MpArithVec mp, MpResVec resInvBase, uint32_t primeCount, uint32_t babySteps, uint32_t *orderOfB);
+   void              GiantSteps(multi_pending_prime_t *pending, HashTable *hashTable, uint32_t orderOfB);
 
    CisOneWithMultipleSequencesHelper *ip_CisOneHelper;
 
    uint32_t          ii_SieveLow;
 
-   HashTable        *ip_HashTable;
+   HashTable        *ip_HashTable[4];   // one per lane
 
-   MpRes            *resBJ;         // there is one per Q
-   MpRes            *resBD;         // there is one per Q
-   MpRes            *resX;
+   MpResVec         *mBD;           // b^d for 0 <= d <= Q
+   MpResVec         *mX;
 
-   MpRes             resBexpQ;
+   multi_pending_prime_t ip_PendingPrimes[8];   // the 4 lanes and the primes waiting for them
+   uint32_t          ii_PendingCount;
+
+   // ii_SubsequenceCount for each pending prime
+   seq_t           **ip_UsableSeqPtrs;
+   uint32_t         *ip_UsableQs;
+   MpRes            *ip_UsableResBDCK;
 
    // See SierpinskiRieselApp.h to see how these are defined.
    uint32_t          ii_BaseMultiple;
@@ -77,11 +93,10 @@ private:
 
    legendre_t       *ip_Legendre;
    uint8_t          *ip_LegendreTable;
+   FastDivisor      *ip_LegendreDivisors;  // one per sequence for bm % mod
 
    bool              ib_AllSequencesHaveLegendreTables;
 
-   useable_subseq_t *ip_UsableSubsequences;
-
    uint32_t         *ip_CongruentSubseqIndices;
 
    uint32_t         *ip_AllSubseqs;
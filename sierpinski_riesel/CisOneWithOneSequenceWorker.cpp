@@ -22,6 +22,8 @@ CisOneWithOneSequenceWorker::CisOneWithOneSequenceWorker(uint32_t myId, App *the
 
    ip_CisOneHelper = (CisOneWithOneSequenceHelper *) appHelper;
 
+   UseMontgomeryContext();
+
    // Everything we need is done in the constuctor of the parent class
    ib_Initialized = true;
 
@@ -32,11 +34,13 @@ CisOneWithOneSequenceWorker::CisOneWithOneSequenceWorker(uint32_t myId, App *the
 
 void  CisOneWithOneSequenceWorker::CleanUp(void)
 {
-   delete ip_HashTable;
+   for (uint32_t pIdx=0; pIdx<4; pIdx++)
+      delete ip_HashTable[pIdx];
 
-   xfree(resBD);
-   xfree(resBJ);
-   xfree(resX);
+   xfree(ip_PendingPrimes);
+   xfree(ip_PendingCount);
+   xfree(mBD);
+   xfree(mX);
 }
 
 void  CisOneWithOneSequenceWorker::Prepare(uint64_t largestPrimeTested, uint32_t bestQ)
@@ -44,9 +48,14 @@ void  CisOneWithOneSequenceWorker::Prepare(uint64_t largestPrimeTested, uint32_t
    ii_BestQ = bestQ;
    ii_SieveLow = ii_MinN / ii_BestQ;
 
-   resX = (MpRes *) xmalloc((ii_PowerResidueLcm+5) * sizeof(MpRes));
-   resBD = (MpRes *) xmalloc((ii_SubsequenceCount+4)*sizeof(MpRes));
-   resBJ = (MpRes *) xmalloc((ii_SubsequenceCount+4)*sizeof(MpRes));
+   mX = (MpResVec *) xmalloc((ii_PowerResidueLcm+5) * sizeof(MpResVec));
+   mBD = (MpResVec *) xmalloc((ii_SubsequenceCount+4)*sizeof(MpResVec));
+
+   ip_PendingPrimes = (pending_prime_t *) xmalloc(4*(ii_SubsequenceCount+1)*sizeof(pending_prime_t));
+   ip_PendingCount = (uint32_t *) xmalloc((ii_SubsequenceCount+1)*sizeof(uint32_t));
+
+   for (uint32_t ssCount=0; ssCount<=ii_SubsequenceCount; ssCount++)
+      ip_PendingCount[ssCount] = 0;
 
    ip_DivisorShifts = ip_CisOneHelper->GetDivisorShifts();
    ip_PowerResidueIndices = ip_CisOneHelper->GetPowerResidueIndices();
@@ -64,14 +73,19 @@ void  CisOneWithOneSequenceWorker::Prepare(uint64_t largestPrimeTested, uint32_t
    ip_Legendre = ip_CisOneHelper->GetLegendre();
    ip_LegendreTable = ip_CisOneHelper->GetLegendreTable();
 
-   ip_HashTable = new HashTable(ip_CisOneHelper->GetMaxBabySteps());
+   if (ip_Legendre->haveMap)
+      ik_LegendreDivisor.SetDivisor(ip_Legendre->mod);
+
+   for (uint32_t pIdx=0; pIdx<4; pIdx++)
+      ip_HashTable[pIdx] = new HashTable(ip_CisOneHelper->GetMaxBabySteps(), ip_SierpinskiRieselApp->GetHashTableType());
 }
 
 void  CisOneWithOneSequenceWorker::TestMegaPrimeChunk(void)
 {
    uint64_t maxPrime = ip_App->GetMaxPrime();
-   uint64_t p;
-   sp_t     parity;
+   uint64_t ps[4], largestPrime = 0;
+   sp_t     parity[4];
+   uint32_t idx, pIdx, primesTested = 0;
 
 #if defined(USE_OPENCL) || defined(USE_METAL)
    bool     switchToGPUWorkers = false;
@@ -88,33 +102,51 @@ void  CisOneWithOneSequenceWorker::TestMegaPrimeChunk(void)
    }
 #endif
 
-   for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx++)
+   // The list is padded to a multiple of 4 with copies of the last prime
+   for (idx=0; idx<ii_PrimesInList; idx+=4)
    {
-      p = il_PrimeList[pIdx];
-
-      parity = GetParity(p);
-
-      if (parity != SP_NO_PARITY)
-         TestSinglePrime(p, parity);
-
-      SetLargestPrimeTested(p, 1);
-
-      if (p >= maxPrime)
+      for (pIdx=0; pIdx<4; pIdx++)
       {
-#if defined(USE_OPENCL) || defined(USE_METAL)
-         // This can only be true if we can switch to only running GPU workers.  Since this
-         // is a CPU worker.  Its life effectively ends upon return from this method.
-         if (switchToGPUWorkers)
+         ps[pIdx] = il_PrimeList[idx+pIdx];
+
+         if (pIdx > 0 && ps[pIdx] == ps[pIdx-1])
          {
-            ip_SierpinskiRieselApp->UseGpuWorkersUponRebuild();
-            ip_SierpinskiRieselApp->SetRebuildNeeded();
+            parity[pIdx] = SP_NO_PARITY;
+            continue;
          }
-#endif
 
-         return;
+         parity[pIdx] = GetParity(ps[pIdx]);
+         primesTested++;
       }
+
+      MpArithVec mp(ik_MpContext, idx);
+
+      largestPrime = ps[3];
+
+      SetupPrimes(ps, parity, mp);
+
+      if (largestPrime >= maxPrime)
+         break;
    }
+
+   // No prime is tested until all primes before it have been tested
+   for (uint32_t ssCount=1; ssCount<=ii_SubsequenceCount; ssCount++)
+      if (ip_PendingCount[ssCount] > 0)
+         TestPendingPrimes(ssCount);
+
+   SetLargestPrimeTested(largestPrime, primesTested);
+
+#if defined(USE_OPENCL) || defined(USE_METAL)
+   // This can only be true if we can switch to only running GPU workers.  Since this
+   // is a CPU worker.  Its life effectively ends upon return from this method.
+   if (largestPrime >= maxPrime && switchToGPUWorkers)
+   {
+      ip_SierpinskiRieselApp->UseGpuWorkersUponRebuild();
+      ip_SierpinskiRieselApp->SetRebuildNeeded();
+   }
+#endif
 }
+
 void  CisOneWithOneSequenceWorker::TestMiniPrimeChunk(uint64_t *miniPrimeChunk)
 {
    FatalError("CisOneWithOneSequenceWorker::TestMiniPrimeChunk not implemented");
@@ -131,7 +163,7 @@ sp_t   CisOneWithOneSequenceWorker::GetParity(uint64_t p)
 
       if (legendrePtr->haveMap)
       {
-         uint32_t qr_mod = (p/2) % legendrePtr->mod;
+         uint32_t qr_mod = ik_LegendreDivisor.Mod(p/2);
 
          qr_m1 = (legendrePtr->dualParityMapM1[L_BYTE(qr_mod)] & L_BIT(qr_mod));
          qr_p1 = (legendrePtr->dualParityMapP1[L_BYTE(qr_mod)] & L_BIT(qr_mod));
@@ -155,7 +187,7 @@ sp_t   CisOneWithOneSequenceWorker::GetParity(uint64_t p)
 
    if (legendrePtr->haveMap)
    {
-      uint32_t qr_mod = (p/2) % legendrePtr->mod;
+      uint32_t qr_mod = ik_LegendreDivisor.Mod(p/2);
 
       qr = (legendrePtr->oneParityMap[L_BYTE(qr_mod)] & L_BIT(qr_mod));
    }
@@ -175,221 +207,384 @@ sp_t   CisOneWithOneSequenceWorker::GetParity(uint64_t p)
    return SP_NO_PARITY;
 }
 
-void  CisOneWithOneSequenceWorker::TestSinglePrime(uint64_t p, sp_t parity)
+void  CisOneWithOneSequenceWorker::SetupPrimes(uint64_t *p, sp_t *parity, MpArithVec mp)
 {
-   uint64_t   invBase, negCK;
-   uint32_t   k, orderOfB, ssCount;
-   uint32_t   babySteps, giantSteps;
-   uint32_t   i, j;
-   uint32_t   cqIdx, qIdx;
-   uint16_t  *seqQs;
+   uint64_t   negCK[4];
+   uint32_t   cqIdx[4], qIdx, ssCount;
+   uint32_t   pIdx;
+   pending_prime_t *pending;
+   uint64_t   startNS = Counters::StartTimer();
 
-   MpArith mp(p);
+   for (pIdx=0; pIdx<4; pIdx++)
+      negCK[pIdx] = getNegCK(ip_FirstSequence, p[pIdx]);
 
-   // compute 1/base (mod p)
-   invBase = invmod64(ii_Base, p);
+   MpResVec resBase = mp.nToRes((uint64_t) ii_Base);
+   MpResVec resInvBase = mp.inv(resBase);
+   MpResVec resNegCK = mp.nToRes(negCK);
 
-   negCK = getNegCK(ip_FirstSequence, p);
+   SetupDiscreteLog(mp, resInvBase, resNegCK, parity, cqIdx);
 
-   MpRes resBase = mp.nToRes(ii_Base);
-   MpRes resInvBase = mp.nToRes(invBase);
-   MpRes resNegCK = mp.nToRes(negCK);
+   Counters::StopTimer(ii_SetupTimer, startNS);
 
-   cqIdx = SetupDiscreteLog(mp, resBase, resInvBase, resNegCK, parity);
+   for (pIdx=0; pIdx<4; pIdx++)
+   {
+      if (parity[pIdx] == SP_NO_PARITY)
+         continue;
 
-   qIdx = ip_CongruentQIndices[cqIdx];
+      qIdx = ip_CongruentQIndices[cqIdx[pIdx]];
 
-   // If no qs for this p, then no factors, so return
-   if (qIdx == 0)
-      return;
+      // If no qs for this p, then no factors
+      if (qIdx == 0)
+         continue;
 
-   seqQs = &ip_AllQs[qIdx];
+      // The number of subsequences (qs) for this sequence.  If there are none, then there are no factors.
+      ssCount = ip_AllQs[qIdx];
 
-   // The number of subsequences (qs) for this sequence
-   ssCount = seqQs[0];
+      if (ssCount == 0)
+         continue;
 
-   // If no subsequences for this p, then no factors, so return
-   if (ssCount == 0)
-      return;
+      pending = &ip_PendingPrimes[4*ssCount + ip_PendingCount[ssCount]];
 
-   // Skip the count since we have already copied it
-   seqQs++;
+      pending->p = p[pIdx];
+      pending->cqIdx = cqIdx[pIdx];
+      pending->resBase = resBase[pIdx];
+      pending->resInvBase = resInvBase[pIdx];
+      pending->resNegCK = resNegCK[pIdx];
 
-   // -ckb^d is an r-th power residue for at least one term (k*b^d)*(b^Q)^(n/Q)+c of this subsequence
-   BuildLookupsAndClimbLadder(mp, resBase, resNegCK, cqIdx, ssCount, seqQs);
+      ip_PendingCount[ssCount]++;
 
-   ip_HashTable->Clear();
+      if (ip_PendingCount[ssCount] == 4)
+         TestPendingPrimes(ssCount);
+   }
+}
+
+void  CisOneWithOneSequenceWorker::TestPendingPrimes(uint32_t ssCount)
+{
+   DiscreteLog(&ip_PendingPrimes[4*ssCount], ip_PendingCount[ssCount], ssCount);
+
+   ip_PendingCount[ssCount] = 0;
+}
+
+// Only the first primeCount lanes are used.  The others are copies of the last of those.
+void  CisOneWithOneSequenceWorker::DiscreteLog(pending_prime_t *primes, uint32_t primeCount, uint32_t ssCount)
+{
+   uint64_t   p[4];
+   uint32_t   cqIdx[4], orderOfB[4];
+   uint32_t   babySteps, giantSteps;
+   uint32_t   pIdx, i, j, k;
+   uint16_t  *seqQs[4];
+   MpResVec   resBase, resInvBase, resNegCK;
+   uint64_t   startNS = Counters::StartTimer();
+
+   for (pIdx=0; pIdx<4; pIdx++)
+   {
+      pending_prime_t *pending = &primes[pIdx < primeCount ? pIdx : primeCount - 1];
+
+      p[pIdx] = pending->p;
+      cqIdx[pIdx] = pending->cqIdx;
+      resBase[pIdx] = pending->resBase;
+      resInvBase[pIdx] = pending->resInvBase;
+      resNegCK[pIdx] = pending->resNegCK;
+
+      // Skip the count since we already know it
+      seqQs[pIdx] = &ip_AllQs[ip_CongruentQIndices[cqIdx[pIdx]] + 1];
+   }
+
+   MpArithVec mp(p);
 
    babySteps = ip_Subsequences[ssCount-1].babySteps;
    giantSteps = ip_Subsequences[ssCount-1].giantSteps;
 
-   orderOfB = BabySteps(mp, resBase, resInvBase, babySteps);
+   // -ckb^d is an r-th power residue for at least one term (k*b^d)*(b^Q)^(n/Q)+c of this subsequence
+   BuildLookupsAndClimbLadder(mp, resBase, resNegCK, cqIdx, ssCount, seqQs);
+
+   Counters::StopTimer(ii_SetupTimer, startNS);
+   startNS = Counters::StartTimer();
+
+   BabySteps(mp, resInvBase, primeCount, babySteps, orderOfB);
 
-   if (orderOfB > 0)
+   Counters::StopTimer(ii_BabyStepTimer, startNS);
+
+   for (pIdx=0; pIdx<primeCount; pIdx++)
    {
-      // If orderOfB > 0, then this is all the information we need to
-      // determine every solution for this p, so no giant steps are neede
-      for (k=0; k<ssCount; k++)
+      Counters::Add(ii_BabyStepCounter, (orderOfB[pIdx] > 0 ? orderOfB[pIdx] : babySteps));
+      ip_HashTable[pIdx]->CountProbes();
+   }
+
+   startNS = Counters::StartTimer();
+
+   bool needGiantSteps = false;
+
+   for (pIdx=0; pIdx<primeCount; pIdx++)
+   {
+      if (orderOfB[pIdx] > 0)
       {
-          j = ip_HashTable->Lookup(resBD[k]);
+         // If orderOfB > 0, then this is all the information we need to
+         // determine every solution for this p, so no giant steps are needed
+         for (k=0; k<ssCount; k++)
+         {
+            j = ip_HashTable[pIdx]->Lookup(mBD[k][pIdx]);
 
-          while (j < babySteps * giantSteps)
-          {
-             ip_SierpinskiRieselApp->ReportFactor(p, ip_FirstSequence, N_TERM(seqQs[k], 0, j), true);
+            while (j < babySteps * giantSteps)
+            {
+               ip_SierpinskiRieselApp->ReportFactor(p[pIdx], ip_FirstSequence, N_TERM(seqQs[pIdx][k], 0, j), true);
+
+               j += orderOfB[pIdx];
+            }
+         }
 
-             j += orderOfB;
-          }
+         continue;
       }
-   }
-   else
-   {
+
       // First giant step
       for (k=0; k<ssCount; k++)
       {
-         j = ip_HashTable->Lookup(resBD[k]);
+         j = ip_HashTable[pIdx]->Lookup(mBD[k][pIdx]);
 
          if (j != HASH_NOT_FOUND)
-            ip_SierpinskiRieselApp->ReportFactor(p, ip_FirstSequence, N_TERM(seqQs[k], 0, j), true);
+            ip_SierpinskiRieselApp->ReportFactor(p[pIdx], ip_FirstSequence, N_TERM(seqQs[pIdx][k], 0, j), true);
       }
 
-      // Remaining giant steps
-      if (giantSteps > 1)
-      {
-         MpRes resBQM = mp.pow(resBexpQ, babySteps);
+      Counters::Add(ii_GiantStepCounter, giantSteps);
+
+      needGiantSteps = true;
+   }
+
+   // Remaining giant steps for the lanes that did not find the order of b
+   if (needGiantSteps && giantSteps > 1)
+   {
+      MpResVec resBQM = mp.pow(mBexpQ, babySteps);
 
-         for (i=1; i<giantSteps; i++)
+      for (i=1; i<giantSteps; i++)
+      {
+         for (k=0; k<ssCount; k++)
          {
-            for (k=0; k<ssCount; k++)
+            mBD[k] = mp.mul(mBD[k], resBQM);
+
+            for (pIdx=0; pIdx<primeCount; pIdx++)
             {
-               resBD[k] = mp.mul(resBD[k], resBQM);
+               if (orderOfB[pIdx] > 0)
+                  continue;
 
-               j = ip_HashTable->Lookup(resBD[k]);
+               j = ip_HashTable[pIdx]->Lookup(mBD[k][pIdx]);
 
                if (j != HASH_NOT_FOUND)
-                  ip_SierpinskiRieselApp->ReportFactor(p, ip_FirstSequence, N_TERM(seqQs[k], i, j), true);
+                  ip_SierpinskiRieselApp->ReportFactor(p[pIdx], ip_FirstSequence, N_TERM(seqQs[pIdx][k], i, j), true);
             }
          }
       }
    }
+
+   Counters::StopTimer(ii_GiantStepTimer, startNS);
 }
 
-// This function builds the list ii_CSSList[] of subsequences (k*b^d)*(b^Q)^m+c for
-// which p may be a factor (-ckb^d is a quadratic/cubic/quartic/quintic
-// residue with respect to p) and initialises the table D64[] with the
-// values -c/(k*b^d) (mod p). As a side effect, bQ is set to the value b^Q
-// (mod p) for use later in bsgs64(). Returns the number of subsequences listed in ii_CSS[].
-uint32_t  CisOneWithOneSequenceWorker::SetupDiscreteLog(MpArith mp, MpRes resBase, MpRes resInvBase, MpRes resNegCK, sp_t parity)
+// This sets cqIdx for each lane.  It is an index into ip_CongruentQIndices[] for the
+// subsequences (k*b^d)*(b^Q)^m+c for which p may be a factor (-ckb^d is a
+// quadratic/cubic/quartic/quintic residue with respect to p) or 0 if there are none.
+void  CisOneWithOneSequenceWorker::SetupDiscreteLog(MpArithVec mp, MpResVec resInvBase, MpResVec resNegCK, sp_t *parity, uint32_t *cqIdx)
 {
-   uint64_t   pShift, p = mp.p();
-   uint32_t   idx;
-   uint32_t   h, r;
-   uint32_t   rIdx;
+   uint64_t   p, pShift[4];
+   uint32_t   idx, pIdx;
+   uint32_t   h, r[4], shifts[4];
    int16_t    shift;
+   bool       needPowers = false, haveAllOrders;
 
-   idx = (p/2) % (ii_PowerResidueLcm/2);
-   shift = ip_DivisorShifts[idx];
-
-   if (shift == 0)
+   for (pIdx=0; pIdx<4; pIdx++)
    {
-      rIdx = ip_PowerResidueIndices[1];
+      cqIdx[pIdx] = 0;
+      pShift[pIdx] = 0;
 
-      return CQ_INDEX(parity, rIdx, 0);
-   }
+      if (parity[pIdx] == SP_NO_PARITY)
+         continue;
 
-   if (shift > 0)
-   {
-      // p = 1 (mod s), where s is not a power of 2. Check for r-th power
-      // residues for each prime power divisor r of s.
-      pShift = p / shift;
+      p = mp.p(pIdx);
+
+      idx = (p/2) % (ii_PowerResidueLcm/2);
+      shift = ip_DivisorShifts[idx];
+
+      if (shift == 0)
+      {
+         cqIdx[pIdx] = CQ_INDEX(parity[pIdx], ip_PowerResidueIndices[1], 0);
+         continue;
+      }
+
+      if (shift > 0)
+      {
+         // p = 1 (mod s), where s is not a power of 2. Check for r-th power
+         // residues for each prime power divisor r of s.
+         pShift[pIdx] = p / shift;
+         shifts[pIdx] = shift;
+      }
+      else
+      {
+         // p = 1 (mod 2^s), where s > 1. Check for r-th power residues for each divisor
+         // r of s. We handle this case seperately to avoid computing p/s using plain division.
+         pShift[pIdx] = p >> (-shift);
+         shifts[pIdx] = 1 << (-shift);
+      }
+
+      needPowers = true;
    }
-   else
+
+   if (!needPowers)
+      return;
+
+   // A lane with pShift = 0 has mX[1] = 1 so it gets r = 1 and is then ignored
+   mX[0] = mp.one();
+   mX[1] = mp.pow(resInvBase, pShift);
+
+   for (pIdx=0; pIdx<4; pIdx++)
+      r[pIdx] = 0;
+
+   // For each lane find the smallest r > 0 such that mX[r] = 1
+   for (idx=1; ; idx++)
    {
-      // p = 1 (mod 2^s), where s > 1. Check for r-th power residues for each divisor
-      // r of s. We handle this case seperately to avoid computing p/s using plain division.
-      pShift = p >> (-shift);
-      shift = 1 << (-shift);
-   }
+      haveAllOrders = true;
+
+      for (pIdx=0; pIdx<4; pIdx++)
+      {
+         if (r[pIdx] == 0 && mX[idx][pIdx] == mX[0][pIdx])
+            r[pIdx] = idx;
+
+         if (r[pIdx] == 0)
+            haveAllOrders = false;
+      }
 
-   resX[0] = mp.one();
-   resX[1] = mp.pow(resInvBase, pShift);
+      if (haveAllOrders)
+         break;
 
-   for (r=1; resX[r] != resX[0]; r++)
-      resX[r+1] = mp.mul(resX[r], resX[1]);
+      mX[idx+1] = mp.mul(mX[idx], mX[1]);
+   }
 
-   if (shift % r != 0)
-      FatalError("SetupDiscreteLog issue, shift %% xIdx != 0 (%u %% %u = %u)", shift, r, shift % r);
+   // mXR = (-ck)^((p-1)/shift)
+   MpResVec mXR = mp.pow(resNegCK, pShift);
 
-   // resX[r] <- (-ck)^((p-1)/shift)
-   resX[r] = mp.pow(resNegCK, pShift);
+   for (pIdx=0; pIdx<4; pIdx++)
+   {
+      if (pShift[pIdx] == 0)
+         continue;
 
-   // Find h such that resX[h] = resX[r], i.e. (-ckb^h)^((p-1)/r)=1 (mod p), or h=r if not found
-   for (h=0; resX[r] != resX[h]; h++)
-      ;
+      if (shifts[pIdx] % r[pIdx] != 0)
+         FatalError("SetupDiscreteLog issue, shift %% xIdx != 0 (%u %% %u = %u)", shifts[pIdx], r[pIdx], shifts[pIdx] % r[pIdx]);
 
-   // If no h was found, then there is nothing further to do.
-   if (h == r)
-      return 0;
+      mX[r[pIdx]][pIdx] = mXR[pIdx];
 
-   rIdx = ip_PowerResidueIndices[r];
+      // Find h such that mX[h] = mX[r], i.e. (-ckb^h)^((p-1)/r)=1 (mod p), or h=r if not found
+      for (h=0; mX[r[pIdx]][pIdx] != mX[h][pIdx]; h++)
+         ;
 
-   return CQ_INDEX(parity, rIdx, h);
+      // If no h was found, then there is nothing further to do.
+      if (h < r[pIdx])
+         cqIdx[pIdx] = CQ_INDEX(parity[pIdx], ip_PowerResidueIndices[r[pIdx]], h);
+   }
 }
 
-// Assign BJ64[i] = b^i (mod p) for each i in the ladder.
-// Return b^Q (mod p).
-void  CisOneWithOneSequenceWorker::BuildLookupsAndClimbLadder(MpArith mp, MpRes resBase, MpRes resNegCK, uint16_t cqIdx, uint16_t ssCount, uint16_t *seqQs)
+// Assign mX[i] = b^i (mod p) for each i in the ladder of each lane, then set mBD[k] to
+// -ck*b^q (mod p) for the k-th q of each lane and mBexpQ to b^Q (mod p).  The ladders
+// are climbed together, so each step is one vector mulmod.
+void  CisOneWithOneSequenceWorker::BuildLookupsAndClimbLadder(MpArithVec mp, MpResVec resBase, MpResVec resNegCK, uint32_t *cqIdx, uint32_t ssCount, uint16_t **seqQs)
 {
-   uint32_t  i, j, idx, lLen, ladderIdx;
-   uint16_t *ladders;
+   uint32_t  i[4], lLen[4], maxLen = 0;
+   uint32_t  j, k, pIdx;
+   uint16_t *ladders[4];
+   MpResVec  mA, mB, mC;
 
-   ladderIdx = ip_LadderIndices[cqIdx];
-   ladders = &ip_AllLadders[ladderIdx];
+   for (pIdx=0; pIdx<4; pIdx++)
+   {
+      i[pIdx] = 2;
+
+      ladders[pIdx] = &ip_AllLadders[ip_LadderIndices[cqIdx[pIdx]]];
 
-   lLen = ladders[0];
-   ladders++;
+      lLen[pIdx] = ladders[pIdx][0];
+      ladders[pIdx]++;
+
+      if (lLen[pIdx] > maxLen)
+         maxLen = lLen[pIdx];
+   }
 
    // Precompute b^d (mod p) for 0 <= d <= Q, as necessary
-   resX[0] = mp.one();
-   resX[1] = resBase;
-   resX[2] = mp.mul(resX[1], resX[1]);
+   mX[0] = mp.one();
+   mX[1] = resBase;
+   mX[2] = mp.mul(mX[1], mX[1]);
 
-   i = 2;
-   for (j=0; j<lLen; j++)
+   for (j=0; j<maxLen; j++)
    {
-      idx = ladders[j];
+      for (pIdx=0; pIdx<4; pIdx++)
+      {
+         if (j < lLen[pIdx])
+         {
+            mA[pIdx] = mX[i[pIdx]][pIdx];
+            mB[pIdx] = mX[ladders[pIdx][j]][pIdx];
+         }
+         else
+            mA[pIdx] = mB[pIdx] = mX[0][pIdx];
+      }
 
-      resX[i+idx] = mp.mul(resX[i], resX[idx]);
+      mC = mp.mul(mA, mB);
 
-      i += idx;
+      for (pIdx=0; pIdx<4; pIdx++)
+      {
+         if (j < lLen[pIdx])
+         {
+            mX[i[pIdx] + ladders[pIdx][j]][pIdx] = mC[pIdx];
+
+            i[pIdx] += ladders[pIdx][j];
+         }
+      }
    }
 
-   resBexpQ = resX[ii_BestQ];
+   mBexpQ = mX[ii_BestQ];
+
+   for (k=0; k<ssCount; k++)
+   {
+      for (pIdx=0; pIdx<4; pIdx++)
+         mA[pIdx] = mX[seqQs[pIdx][k]][pIdx];
 
-   for (j=0; j<ssCount; j++)
-      resBD[j] = mp.mul(resX[seqQs[j]], resNegCK);
+      mBD[k] = mp.mul(mA, resNegCK);
+   }
 }
 
-uint32_t  CisOneWithOneSequenceWorker::BabySteps(MpArith mp, MpRes resBase, MpRes resInvBase, uint32_t babySteps)
+// This sets orderOfB for each lane to the order of b^Q if it is less than babySteps,
+// otherwise 0.  Only the first primeCount lanes are put into the hash tables.
+void  CisOneWithOneSequenceWorker::BabySteps(MpArithVec mp, MpResVec resInvBase, uint32_t primeCount, uint32_t babySteps, uint32_t *orderOfB)
 {
-   MpRes    resInvBaseExpQ;
-   MpRes    resBJ;
-   MpRes    firstResBJ;
-   uint32_t j;
+   uint32_t j, pIdx, lanesLeft = primeCount;
 
    // b <- inv_b^Q (mod p)
-   resInvBaseExpQ = mp.pow(resInvBase, ii_BestQ);
+   MpResVec resInvBaseExpQ = mp.pow(resInvBase, ii_BestQ);
 
-   firstResBJ = resBJ = mp.pow(resInvBaseExpQ, ii_SieveLow);
+   MpResVec firstResBJ = mp.pow(resInvBaseExpQ, ii_SieveLow);
+   MpResVec resBJ = firstResBJ;
+
+   for (pIdx=0; pIdx<4; pIdx++)
+   {
+      orderOfB[pIdx] = 0;
+
+      if (pIdx < primeCount)
+         ip_HashTable[pIdx]->Clear();
+   }
 
    for (j=0; j<babySteps; j++)
    {
-      ip_HashTable->Insert(resBJ, j);
+      for (pIdx=0; pIdx<primeCount; pIdx++)
+         if (orderOfB[pIdx] == 0)
+            ip_HashTable[pIdx]->Insert(resBJ[pIdx], j);
 
       resBJ = mp.mul(resBJ, resInvBaseExpQ);
 
-      if (resBJ == firstResBJ)
-         return j + 1;
-   }
+      if (!MpArithVec::at_least_one_is_equal(resBJ, firstResBJ))
+         continue;
+
+      for (pIdx=0; pIdx<primeCount; pIdx++)
+      {
+         if (orderOfB[pIdx] == 0 && resBJ[pIdx] == firstResBJ[pIdx])
+         {
+            orderOfB[pIdx] = j + 1;
+            lanesLeft--;
+         }
+      }
 
-   return 0;
+      if (lanesLeft == 0)
+         return;
+   }
 }
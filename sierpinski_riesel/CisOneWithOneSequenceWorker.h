@@ -14,9 +14,19 @@
 #include "AbstractWorker.h"
 #include "../core/HashTable.h"
 #include "../core/MpArith.h"
+#include "../core/MpArithVector.h"
+#include "../core/FastDivisor.h"
 
 using namespace std;
 
+typedef struct {
+   uint64_t          p;
+   uint32_t          cqIdx;
+   MpRes             resBase;
+   MpRes             resInvBase;
+   MpRes             resNegCK;
+} pending_prime_t;
+
 class CisOneWithOneSequenceWorker : public AbstractWorker
 {
 public:
@@ -33,13 +43,20 @@ public:
 private:
    sp_t              GetParity(uint64_t p);
 
-   void              TestSinglePrime(uint64_t p, sp_t parity);
+   // A prime is not tested when it is set up.  It waits with other primes that have the
+   // same number of subsequences, and thus the same number of baby steps and giant steps,
+   // until there is one for each lane of the MpArithVec.  The remaining primes are tested
+   // at the end of the chunk.
+   void              SetupPrimes(uint64_t *p, sp_t *parity, MpArithVec mp);
+   void              TestPendingPrimes(uint32_t ssCount);
+
+   void              DiscreteLog(pending_prime_t *primes, uint32_t primeCount, uint32_t ssCount);
 
-   uint32_t          SetupDiscreteLog(MpArith mp, MpRes resBase, MpRes resInvBase, MpRes resNegCK, sp_t parity);
+   void              SetupDiscreteLog(MpArithVec mp, MpResVec resInvBase, MpResVec resNegCK, sp_t *parity, uint32_t *cqIdx);
 
-   void              BuildLookupsAndClimbLadder(MpArith mp, MpRes resBase, MpRes resNegCK, uint16_t cqIdx, uint16_t ssCount, uint16_t *seqQs);
+   void              BuildLookupsAndClimbLadder(MpArithVec mp, MpResVec resBase, MpResVec resNegCK, uint32_t *cqIdx, uint32_t ssCount, uint16_t **seqQs);
 
-   uint32_t          BabySteps(MpArith mp, MpRes resBase, MpRes resInvBase, uint32_t babySteps);
+   void              BabySteps(MpArithVec mp, MpResVec resInvBase, uint32_t primeCount, uint32_t babySteps, uint32_t *orderOfB);
 
    CisOneWithOneSequenceHelper *ip_CisOneHelper;
 
@@ -50,13 +67,15 @@ private:
 
    uint32_t          ii_SieveLow;
 
-   HashTable        *ip_HashTable;
+   HashTable        *ip_HashTable[4];   // one per lane
+
+   MpResVec         *mBD;           // there is one per q
+   MpResVec         *mX;
 
-   MpRes            *resBJ;         // there is one per Q
-   MpRes            *resBD;         // there is one per Q
-   MpRes            *resX;
+   MpResVec          mBexpQ;
 
-   MpRes             resBexpQ;
+   pending_prime_t  *ip_PendingPrimes;    // 4 for each possible number of subsequences
+   uint32_t         *ip_PendingCount;
 
    int16_t          *ip_DivisorShifts;
    uint16_t         *ip_PowerResidueIndices;
@@ -69,6 +88,7 @@ private:
 
    legendre_t       *ip_Legendre;
    uint8_t          *ip_LegendreTable;
+   FastDivisor       ik_LegendreDivisor;   // for (p/2) % ip_Legendre->mod
 
    uint32_t          ii_Dim1;
    uint32_t          ii_Dim2;
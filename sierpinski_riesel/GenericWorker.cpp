@@ -24,12 +24,16 @@ GenericWorker::GenericWorker(uint32_t myId, App *theApp, AbstractSequenceHelper
    ib_CanUseCIsOneLogic = srApp->CanUseCIsOneLogic();
    il_MaxK = srApp->GetMaxK();
 
+   UseMontgomeryContext();
+
    // Everything we need is done in the constuctor of the parent class
    ib_Initialized = true;
 
    ssHash = NULL;
    mBD = NULL;
    mBDCK = NULL;
+   mKB = NULL;
+   mKBInv = NULL;
 }
 
 void  GenericWorker::CleanUp(void)
@@ -42,6 +46,8 @@ void  GenericWorker::CleanUp(void)
    xfree(ssHash);
    xfree(mBD);
    xfree(mBDCK);
+   xfree(mKB);
+   xfree(mKBInv);
 }
 
 void  GenericWorker::Prepare(uint64_t largestPrimeTested, uint32_t bestQ)
@@ -74,6 +80,7 @@ void  GenericWorker::InitializeWorker(void)
    uint32_t idx;
    uint32_t r = ii_MaxN/ii_BestQ - ii_MinN/ii_BestQ + 1;
    double babyStepFactor = ip_SierpinskiRieselApp->GetBabyStepFactor();
+   uint32_t maxBabySteps = ip_SierpinskiRieselApp->GetMaxHashTableElements();
 
    // In the worst case we will do do one table insertion and one mulmod for ii_BabySteps
    // baby steps, then s table lookups and s mulmods for ii_GiantSteps giant steps. The
@@ -85,9 +92,9 @@ void  GenericWorker::InitializeWorker(void)
    ii_GiantSteps = MAX(1, sqrt((double) r/ii_SubsequenceCount/babyStepFactor));
    ii_BabySteps = MIN(r, ceil((double) r/ii_GiantSteps));
 
-   if (ii_BabySteps > HASH_MAX_ELTS)
+   if (ii_BabySteps > maxBabySteps)
    {
-      ii_GiantSteps = ceil((double)r/HASH_MAX_ELTS);
+      ii_GiantSteps = ceil((double)r/maxBabySteps);
       ii_BabySteps = ceil((double)r/ii_GiantSteps);
    }
 
@@ -104,9 +111,11 @@ void  GenericWorker::InitializeWorker(void)
 
    mBDCK = (MpResVec *) xmalloc(ii_SubsequenceCount*sizeof(MpResVec));
    mBD = (MpResVec *) xmalloc(ii_BestQ*sizeof(MpResVec));
+   mKB = (MpResVec *) xmalloc((ii_SequenceCount+1)*sizeof(MpResVec));
+   mKBInv = (MpResVec *) xmalloc((ii_SequenceCount+1)*sizeof(MpResVec));
 
    for (idx=0; idx<4; idx++)
-      ip_HashTable[idx] = new HashTable(ii_BabySteps);
+      ip_HashTable[idx] = new HashTable(ii_BabySteps, ip_SierpinskiRieselApp->GetHashTableType());
 }
 
 void  GenericWorker::TestMegaPrimeChunk(void)
@@ -157,7 +166,9 @@ void  GenericWorker::TestMegaPrimeChunk(void)
       ps[2] = il_PrimeList[pIdx+2];
       ps[3] = il_PrimeList[pIdx+3];
 
-      DiscreteLogLargePrimes(bs, ps);
+      MpArithVec mp(ik_MpContext, pIdx);
+
+      DiscreteLogLargePrimes(bs, ps, mp);
 
       SetLargestPrimeTested(ps[3], 4);
 
@@ -386,19 +397,25 @@ void  GenericWorker::DiscreteLogSmallPrimes(uint32_t *b, uint64_t *p)
    }
 }
 
-void  GenericWorker::DiscreteLogLargePrimes(uint32_t *b, uint64_t *p)
+void  GenericWorker::DiscreteLogLargePrimes(uint32_t *b, uint64_t *p, MpArithVec mp)
 {
    uint32_t i, j, ssIdx;
    uint32_t pIdx;
    uint32_t orderOfB[4];
+   uint64_t startNS = Counters::StartTimer();
 
-   MpArithVec mp(p);
    MpResVec mb = mp.nToRes(b);
 
    SetupDiscreteLog(b, p, mp, mb);
 
+   Counters::StopTimer(ii_SetupTimer, startNS);
+   startNS = Counters::StartTimer();
+
    BabySteps(mp, mb, orderOfB);
 
+   Counters::StopTimer(ii_BabyStepTimer, startNS);
+   startNS = Counters::StartTimer();
+
    for (pIdx=0; pIdx<4; pIdx++)
    {
       if (orderOfB[pIdx] > 0)
@@ -426,10 +443,15 @@ void  GenericWorker::DiscreteLogLargePrimes(uint32_t *b, uint64_t *p)
          if (j != HASH_NOT_FOUND)
             ip_SierpinskiRieselApp->ReportFactor(p[pIdx], SEQ_PTR(ssIdx), N_TERM(ssIdx, j), true);
       }
+
+      Counters::Add(ii_GiantStepCounter, 1);
    }
 
    if (ii_GiantSteps < 2)
+   {
+      Counters::StopTimer(ii_GiantStepTimer, startNS);
       return;
+   }
 
    // b <- 1/b^m (mod p)
    mBM = mp.pow(mBM, ii_BabySteps);
@@ -461,6 +483,9 @@ void  GenericWorker::DiscreteLogLargePrimes(uint32_t *b, uint64_t *p)
             ip_SierpinskiRieselApp->ReportFactor(p[3], SEQ_PTR(ssIdx), N_TERM(ssIdx, j + i*ii_BabySteps), true);
       }
    }
+
+   Counters::Add(ii_GiantStepCounter, 4 * (ii_GiantSteps - 1));
+   Counters::StopTimer(ii_GiantStepTimer, startNS);
 }
 
 void  GenericWorker::TestMiniPrimeChunk(uint64_t *miniPrimeChunk)
@@ -471,17 +496,28 @@ void  GenericWorker::TestMiniPrimeChunk(uint64_t *miniPrimeChunk)
 // Compute a number of values that we need for the discrete log
 void  GenericWorker::SetupDiscreteLog(uint32_t *b, uint64_t *p, MpArithVec mp, MpResVec mb)
 {
-   uint32_t   qIdx, ssIdx;
-   uint64_t   imod[4], umod[4], temp[4];
+   uint32_t   qIdx, ssIdx, seqIdx;
+   uint64_t   temp[4];
    seq_t     *seqPtr;
 
-   imod[0] = invmod64(b[0], p[0]);
-   imod[1] = invmod64(b[1], p[1]);
-   imod[2] = invmod64(b[2], p[2]);
-   imod[3] = invmod64(b[3], p[3]);
+   // Invert b and every k together so that there is only one inversion per prime.
+   // A k that is divisible by p has no inverse, so it is left as 0 like invmod64 does.
+   mKB[0] = mb;
+
+   seqIdx = 1;
+   seqPtr = ip_FirstSequence;
+   do
+   {
+      mKB[seqIdx] = mp.nToRes(seqPtr->k);
+
+      seqIdx++;
+      seqPtr = (seq_t *) seqPtr->next;
+   } while (seqPtr != NULL);
+
+   mp.inv(mKB, mKBInv, ii_SequenceCount + 1);
 
    MpResVec mCK;
-   MpResVec mI = mp.nToRes(imod);
+   MpResVec mI = mKBInv[0];
    mBM = mI;
    mBD[0] = mp.one();
 
@@ -492,6 +528,7 @@ void  GenericWorker::SetupDiscreteLog(uint32_t *b, uint64_t *p, MpArithVec mp, M
       mBM = mp.mul(mBM, mI);
    }
 
+   seqIdx = 1;
    seqPtr = ip_FirstSequence;
    do
    {
@@ -500,20 +537,9 @@ void  GenericWorker::SetupDiscreteLog(uint32_t *b, uint64_t *p, MpArithVec mp, M
       temp[2] = lmod64(-seqPtr->c, p[2]);
       temp[3] = lmod64(-seqPtr->c, p[3]);
 
-      umod[0] = umod64(seqPtr->k, p[0]);
-      umod[1] = umod64(seqPtr->k, p[1]);
-      umod[2] = umod64(seqPtr->k, p[2]);
-      umod[3] = umod64(seqPtr->k, p[3]);
-
-      imod[0] = invmod64(umod[0], p[0]);
-      imod[1] = invmod64(umod[1], p[1]);
-      imod[2] = invmod64(umod[2], p[2]);
-      imod[3] = invmod64(umod[3], p[3]);
-
       MpResVec mTemp = mp.nToRes(temp);
-      mI = mp.nToRes(imod);
 
-      mCK = mp.mul(mTemp, mI);
+      mCK = mp.mul(mTemp, mKBInv[seqIdx]);
 
       // Compute -c/(k*b^d) (mod p) for each subsequence.
       for (ssIdx=seqPtr->ssIdxFirst; ssIdx<=seqPtr->ssIdxLast; ssIdx++)
@@ -523,6 +549,7 @@ void  GenericWorker::SetupDiscreteLog(uint32_t *b, uint64_t *p, MpArithVec mp, M
          mBDCK[ssIdx] = mp.mul(mBD[qIdx], mCK);
       }
 
+      seqIdx++;
       seqPtr = (seq_t *) seqPtr->next;
    } while (seqPtr != NULL);
 
@@ -555,5 +582,9 @@ void  GenericWorker::BabySteps(MpArithVec mp, MpResVec mb, uint32_t *orderOfB)
             break;
          }
       }
+
+      Counters::Add(ii_BabyStepCounter, (orderOfB[pIdx] > 0 ? orderOfB[pIdx] : ii_BabySteps));
+
+      ip_HashTable[pIdx]->CountProbes();
    }
 }
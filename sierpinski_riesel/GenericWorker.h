@@ -40,7 +40,7 @@ private:
    void              SetupDiscreteLog(uint32_t *b, uint64_t *p, MpArithVec mp, MpResVec mb);
 
    void              DiscreteLogSmallPrimes(uint32_t *b, uint64_t *p);
-   void              DiscreteLogLargePrimes(uint32_t *b, uint64_t *p);
+   void              DiscreteLogLargePrimes(uint32_t *b, uint64_t *p, MpArithVec mp);
 
    void              BabySteps(MpArithVec mp, MpResVec mb, uint32_t *orderOfB);
 
@@ -61,6 +61,8 @@ private:
 
    MpResVec         *mBD;           // there is one set of 4 per Q
    MpResVec         *mBDCK;         // there is one set of 4 per subsequence
+   MpResVec         *mKB;           // b followed by k for each sequence
+   MpResVec         *mKBInv;        // the inverses of mKB
 
    MpResVec          mBM;
 };
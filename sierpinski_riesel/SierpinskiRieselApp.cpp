@@ -12,6 +12,7 @@
 #include "../core/inline.h"
 #include "../core/Parser.h"
 #include "../core/Clock.h"
+#include "../core/Counters.h"
 #include "../sieve/primesieve.hpp"
 #include "SierpinskiRieselApp.h"
 #include "AlgebraicFactorHelper.h"
@@ -33,6 +34,8 @@
 
 #define NBIT(n)         ((n) - ii_MinN)
 
+uint32_t SierpinskiRieselApp::ii_TermRemovalTimer = Counters::Register("term removal", CT_TIMER);
+
 // This is declared in App.h, but implemented here.  This means that App.h
 // can remain unchanged if using the mtsieve framework for other applications.
 App *get_app(void)
@@ -40,7 +43,7 @@ App *get_app(void)
    return new SierpinskiRieselApp();
 }
 
-SierpinskiRieselApp::SierpinskiRieselApp() : FactorApp()
+SierpinskiRieselApp::SierpinskiRieselApp() : QueuedFactorApp()
 {
    SetBanner(APP_NAME " v" APP_VERSION ", a program to find factors of k*b^n+c numbers for fixed b and variable k and n");
    SetLogFileName("srsieve2.log");
@@ -68,6 +71,7 @@ SierpinskiRieselApp::SierpinskiRieselApp() : FactorApp()
    ii_PowerResidueLcmMulitplier = 0;
    ii_LimitBaseMultiplier = 0;
    id_BabyStepFactor = 1.0;
+   it_HashTableType = HT_AUTO;
 
 #if defined(USE_OPENCL) || defined(USE_METAL)
    ib_UseGPUWorkersUponRebuild = false;
@@ -87,6 +91,8 @@ void SierpinskiRieselApp::Help(void)
 {
    FactorApp::ParentHelp();
 
+   printf("                      factors are written by a separate thread in batches, so factors\n");
+   printf("                      found in the last 0.1 seconds before a crash can be lost\n");
    printf("-n --nmin=n           Minimum n to search\n");
    printf("-N --nmax=N           Maximum n to search\n");
    printf("-s --sequence=s       Sequence in form k*b^n+c where k, b, and c are decimal values\n");
@@ -103,6 +109,8 @@ void SierpinskiRieselApp::Help(void)
 
    printf("-b --babystepfactor=b used when calculating number of baby steps and giant steps.\n");
    printf("                      As b increases, so do the number of baby steps.  default %lf\n", id_BabyStepFactor);
+   printf("-T --hashtable=T      hash table for baby steps: chained, swiss or auto (default auto).  The chained\n");
+   printf("                      table limits baby steps to %u, auto uses swiss when more are needed\n", HASH_MAX_ELTS);
 
    printf("-U --bmmulitplier=U   multiplied by 2 to compute BASE_MULTIPLE (default %u for single %u for multi\n",
             DEFAULT_BM_MULTIPLIER_SINGLE, DEFAULT_BM_MULTIPLIER_MULTI);
@@ -124,7 +132,7 @@ void  SierpinskiRieselApp::AddCommandLineOptions(std::string &shortOpts, struct
 {
    FactorApp::ParentAddCommandLineOptions(shortOpts, longOpts);
 
-   shortOpts += "n:N:s:f:l:L:R:U:V:X:b:";
+   shortOpts += "n:N:s:f:l:L:R:U:V:X:b:T:";
 
    AppendLongOpt(longOpts, "nmin",           required_argument, 0, 'n');
    AppendLongOpt(longOpts, "nmax",           required_argument, 0, 'N');
@@ -134,6 +142,7 @@ void  SierpinskiRieselApp::AddCommandLineOptions(std::string &shortOpts, struct
    AppendLongOpt(longOpts, "legendrefile",   required_argument, 0, 'L');
    AppendLongOpt(longOpts, "remove",         required_argument, 0, 'R');
    AppendLongOpt(longOpts, "babystepfactor", required_argument, 0, 'b');
+   AppendLongOpt(longOpts, "hashtable",      required_argument, 0, 'T');
    AppendLongOpt(longOpts, "basemultiple",   required_argument, 0, 'U');
    AppendLongOpt(longOpts, "limitbase",      required_argument, 0, 'V');
    AppendLongOpt(longOpts, "powerresidue",   required_argument, 0, 'X');
@@ -207,6 +216,18 @@ parse_t SierpinskiRieselApp::ParseOption(int opt, char *arg, const char *source)
          status = P_SUCCESS;
          break;
 
+      case 'T':
+         status = P_SUCCESS;
+         if (!strcmp(arg, "auto"))
+            it_HashTableType = HT_AUTO;
+         else if (!strcmp(arg, "chained"))
+            it_HashTableType = HT_CHAINED;
+         else if (!strcmp(arg, "swiss"))
+            it_HashTableType = HT_SWISS;
+         else
+            status = P_FAILURE;
+         break;
+
       case 'U':
          status = Parser::Parse(arg, 1, 50, ii_BaseMultipleMultiplier);
          break;
@@ -254,8 +275,8 @@ void SierpinskiRieselApp::ValidateOptions(void)
       seqPtr = ip_FirstSequence;
       do
       {
-         seqPtr->nTerms.resize(ii_MaxN - ii_MinN + 1);
-         std::fill(seqPtr->nTerms.begin(), seqPtr->nTerms.end(), false);
+         seqPtr->nTerms.Resize(ii_MaxN - ii_MinN + 1);
+         seqPtr->nTerms.Fill(false);
 
          seqPtr = (seq_t *) seqPtr->next;
       } while (seqPtr != NULL);
@@ -286,8 +307,8 @@ void SierpinskiRieselApp::ValidateOptions(void)
       seqPtr = ip_FirstSequence;
       do
       {
-         seqPtr->nTerms.resize(ii_MaxN - ii_MinN + 1);
-         std::fill(seqPtr->nTerms.begin(), seqPtr->nTerms.end(), true);
+         seqPtr->nTerms.Resize(ii_MaxN - ii_MinN + 1);
+         seqPtr->nTerms.Fill(true);
 
          il_TermCount += (ii_MaxN - ii_MinN + 1);
 
@@ -363,6 +384,8 @@ void SierpinskiRieselApp::ValidateOptions(void)
 #endif
 
    FactorApp::ParentValidateOptions();
+
+   UseFactorQueues();
 }
 
 bool  SierpinskiRieselApp::LoadSequencesFromFile(char *fileName)
@@ -527,7 +550,7 @@ void SierpinskiRieselApp::ProcessInputTermsFile(bool haveBitMap)
          if (haveBitMap)
          {
             currentSequence = GetSequence(k, c, d);
-            currentSequence->nTerms[NBIT(n)] = true;
+            currentSequence->nTerms.Set(NBIT(n));
             il_TermCount++;
             continue;
          }
@@ -641,7 +664,7 @@ void SierpinskiRieselApp::ProcessInputTermsFile(bool haveBitMap)
 
          if (haveBitMap)
          {
-            currentSequence->nTerms[NBIT(n)] = true;
+            currentSequence->nTerms.Set(NBIT(n));
             il_TermCount++;
          }
          else
@@ -738,13 +761,7 @@ void  SierpinskiRieselApp::RemoveSequence(uint64_t k, uint32_t b, int64_t c, uin
       {
          found = true;
 
-         for (uint32_t n=ii_MinN; n<=ii_MaxN; n++)
-         {
-            if (seqPtr->nTerms[NBIT(n)])
-               removedCount++;
-         }
-
-         seqPtr->nTerms.clear();
+         removedCount = (uint32_t) seqPtr->nTerms.Count();
 
          if (seqPtr == ip_FirstSequence)
             ip_FirstSequence = (seq_t *) seqPtr->next;
@@ -753,7 +770,7 @@ void  SierpinskiRieselApp::RemoveSequence(uint64_t k, uint32_t b, int64_t c, uin
 
          WriteToConsole(COT_OTHER, "%u terms for sequence %s have been removed", removedCount, sequence);
 
-         xfree(seqPtr);
+         delete seqPtr;
 
          il_TermCount -= removedCount;
          ii_SequenceCount--;
@@ -798,7 +815,7 @@ bool SierpinskiRieselApp::ApplyFactor(uint64_t theFactor, const char *term)
 
          if (seqPtr->nTerms[NBIT(n)])
          {
-            seqPtr->nTerms[NBIT(n)] = false;
+            seqPtr->nTerms.Clear(NBIT(n));
             il_TermCount--;
 
             return true;
@@ -885,22 +902,16 @@ void SierpinskiRieselApp::WriteOutputTermsFile(uint64_t largestPrime)
 uint32_t SierpinskiRieselApp::WriteABCDTermsFile(seq_t *seqPtr, uint64_t maxPrime, FILE *termsFile)
 {
    uint32_t n, nCount = 0, previousN;
-   uint32_t bit;
+   uint64_t bit, bitCount;
 
-   n = ii_MinN;
+   bitCount = seqPtr->nTerms.GetSize();
+   bit = seqPtr->nTerms.FindNextSet(0);
 
-   bit = NBIT(n);
-   for (; n<=ii_MaxN; n++)
-   {
-      if (seqPtr->nTerms[bit])
-         break;
-
-      bit++;
-   }
-
-   if (n > ii_MaxN)
+   if (bit == bitCount)
       return 0;
 
+   n = ii_MinN + (uint32_t) bit;
+
    if (seqPtr->d == 1)
       fprintf(termsFile, "ABCD %" PRIu64"*%u^$a%+" PRId64" [%u] // Sieved to %" PRIu64"\n", seqPtr->k, ii_Base, seqPtr->c, n, maxPrime);
    else
@@ -908,19 +919,14 @@ uint32_t SierpinskiRieselApp::WriteABCDTermsFile(seq_t *seqPtr, uint64_t maxPrim
 
    previousN = n;
    nCount = 1;
-   n++;
 
-   bit = NBIT(n);
-   for (; n<=ii_MaxN; n++)
+   for (bit=seqPtr->nTerms.FindNextSet(bit+1); bit<bitCount; bit=seqPtr->nTerms.FindNextSet(bit+1))
    {
-      if (seqPtr->nTerms[bit])
-      {
-         fprintf(termsFile, "%u\n", n - previousN);
-         previousN = n;
-         nCount++;
-      }
+      n = ii_MinN + (uint32_t) bit;
 
-      bit++;
+      fprintf(termsFile, "%u\n", n - previousN);
+      previousN = n;
+      nCount++;
    }
 
    return nCount;
@@ -929,25 +935,21 @@ uint32_t SierpinskiRieselApp::WriteABCDTermsFile(seq_t *seqPtr, uint64_t maxPrim
 uint32_t SierpinskiRieselApp::WriteABCTermsFile(seq_t *seqPtr, uint64_t maxPrime, FILE *termsFile)
 {
    uint32_t n, nCount = 0;
-   uint32_t bit;
+   uint64_t bit, bitCount;
 
    if (seqPtr->d == 1)
       fprintf(termsFile, "ABC %" PRIu64"*%u^$a%+" PRId64" // Sieved to %" PRIu64"\n", seqPtr->k, ii_Base, seqPtr->c, maxPrime);
    else
       fprintf(termsFile, "ABC (%" PRIu64"*%u^$a%+" PRId64")/%u // Sieved to %" PRIu64"\n", seqPtr->k, ii_Base, seqPtr->c, seqPtr->d, maxPrime);
 
-   n = ii_MinN;
-   bit = NBIT(n);
+   bitCount = seqPtr->nTerms.GetSize();
 
-   for (; n<=ii_MaxN; n++)
+   for (bit=seqPtr->nTerms.FindNextSet(0); bit<bitCount; bit=seqPtr->nTerms.FindNextSet(bit+1))
    {
-      if (seqPtr->nTerms[bit])
-      {
-         fprintf(termsFile, "%u\n", n);
-         nCount++;
-      }
+      n = ii_MinN + (uint32_t) bit;
 
-      bit++;
+      fprintf(termsFile, "%u\n", n);
+      nCount++;
    }
 
    return nCount;
@@ -956,20 +958,16 @@ uint32_t SierpinskiRieselApp::WriteABCTermsFile(seq_t *seqPtr, uint64_t maxPrime
 uint32_t SierpinskiRieselApp::WriteBoincTermsFile(seq_t *seqPtr, uint64_t maxPrime, FILE *termsFile)
 {
    uint32_t n, nCount = 0;
-   uint32_t bit;
+   uint64_t bit, bitCount;
 
-   n = ii_MinN;
-   bit = NBIT(n);
+   bitCount = seqPtr->nTerms.GetSize();
 
-   for (; n<=ii_MaxN; n++)
+   for (bit=seqPtr->nTerms.FindNextSet(0); bit<bitCount; bit=seqPtr->nTerms.FindNextSet(bit+1))
    {
-      if (seqPtr->nTerms[bit])
-      {
-         fprintf(termsFile, "%" PRIu64" %u\n", seqPtr->k, n);
-         nCount++;
-      }
+      n = ii_MinN + (uint32_t) bit;
 
-      bit++;
+      fprintf(termsFile, "%" PRIu64" %u\n", seqPtr->k, n);
+      nCount++;
    }
 
    return nCount;
@@ -978,24 +976,20 @@ uint32_t SierpinskiRieselApp::WriteBoincTermsFile(seq_t *seqPtr, uint64_t maxPri
 uint32_t SierpinskiRieselApp::WriteABCNumberPrimesTermsFile(seq_t *seqPtr, uint64_t maxPrime, FILE *termsFile, bool allSequencesHaveDEqual1)
 {
    uint32_t n, nCount = 0;
-   uint32_t bit;
+   uint64_t bit, bitCount;
 
-   n = ii_MinN;
-   bit = NBIT(n);
+   bitCount = seqPtr->nTerms.GetSize();
 
-   for (; n<=ii_MaxN; n++)
+   for (bit=seqPtr->nTerms.FindNextSet(0); bit<bitCount; bit=seqPtr->nTerms.FindNextSet(bit+1))
    {
-      if (seqPtr->nTerms[bit])
-      {
-         if (allSequencesHaveDEqual1)
-            fprintf(termsFile, "%" PRIu64" %u %+" PRId64"\n", seqPtr->k, n, seqPtr->c);
-         else
-            fprintf(termsFile, "%" PRIu64" %u %+" PRId64" %u\n", seqPtr->k, n, seqPtr->c, seqPtr->d);
+      n = ii_MinN + (uint32_t) bit;
 
-         nCount++;
-      }
+      if (allSequencesHaveDEqual1)
+         fprintf(termsFile, "%" PRIu64" %u %+" PRId64"\n", seqPtr->k, n, seqPtr->c);
+      else
+         fprintf(termsFile, "%" PRIu64" %u %+" PRId64" %u\n", seqPtr->k, n, seqPtr->c, seqPtr->d);
 
-      bit++;
+      nCount++;
    }
 
    return nCount;
@@ -1056,7 +1050,8 @@ void  SierpinskiRieselApp::AddSequence(uint64_t k, int64_t c, uint32_t d)
       } while (seqPtr != NULL);
    }
 
-   seq_t *newPtr = (seq_t *) xmalloc(sizeof(seq_t));
+   // Use new so that nTerms is constructed.  The () zero-initializes the other fields.
+   seq_t *newPtr = new seq_t();
 
    uint64_t absc = abs(c);
 
@@ -1120,6 +1115,9 @@ void  SierpinskiRieselApp::NotifyAppToRebuild(uint64_t largestPrimeTested)
       return;
 #endif
 
+   // The helper rebuilds from the remaining terms, so apply all queued factors first
+   FlushFactorQueues();
+
    ip_AppHelper->CleanUp();
 
    delete ip_AppHelper;
@@ -1179,21 +1177,10 @@ void  SierpinskiRieselApp::RemoveSequencesWithNoTerms(void)
    prevSeq = seqPtr = ip_FirstSequence;
    do
    {
-      bool haveTerm = false;
-
-      for (uint32_t n=ii_MinN; n<=ii_MaxN; n++)
-      {
-         if (seqPtr->nTerms[NBIT(n)])
-         {
-            haveTerm = true;
-            break;
-         }
-      }
+      bool haveTerm = (seqPtr->nTerms.FindNextSet(0) < seqPtr->nTerms.GetSize());
 
       if (!haveTerm)
       {
-         seqPtr->nTerms.clear();
-
          nextSeq = (seq_t *) seqPtr->next;
 
          if (seqPtr == ip_FirstSequence)
@@ -1208,7 +1195,7 @@ void  SierpinskiRieselApp::RemoveSequencesWithNoTerms(void)
             WriteToConsole(COT_OTHER, "Sequence (%" PRIu64"*%u^n%+" PRId64")/%u removed as all terms have a factor",
                seqPtr->k, ii_Base, seqPtr->c, seqPtr->d);
 
-         xfree(seqPtr);
+         delete seqPtr;
 
          seqPtr = nextSeq;
          ii_SequenceCount--;
@@ -1274,46 +1261,31 @@ void  SierpinskiRieselApp::CheckForLegendreSupport(void)
 
 void     SierpinskiRieselApp::ReportFactor(uint64_t theFactor, seq_t *seqPtr, uint32_t n, bool verifyFactor)
 {
-   uint32_t nbit;
-   bool     wasRemoved = false;
-   bool     isPrime = false;
+   bool     wasRemoved;
+   bool     isPrime;
    char     buffer[200];
+   uint64_t startNS;
 
    if (n < ii_MinN || n > ii_MaxN)
       return;
 
-   if (seqPtr->d > 1)
-      sprintf(buffer, "(%" PRIu64"*%u^%u%+" PRId64")/%u", seqPtr->k, ii_Base, n, seqPtr->c, seqPtr->d);
-   else
-      sprintf(buffer, "%" PRIu64"*%u^%u%+" PRId64"", seqPtr->k, ii_Base, n, seqPtr->c);
+   // Once there are multiple workers, hand the factor to the factor writer rather
+   // than waiting for ip_FactorAppLock.
+   if (theFactor > GetMaxPrimeForSingleWorker() && QueueFactor(theFactor, seqPtr, n, verifyFactor))
+      return;
 
-   nbit = NBIT(n);
+   startNS = Counters::StartTimer();
 
    if (theFactor > GetMaxPrimeForSingleWorker())
       ip_FactorAppLock->Lock();
 
-   if (seqPtr->nTerms[nbit])
-   {
-      // Do not remove terms where k*b^n+c is prime.  This means that PRP testing program
-      // should identify this term as prime and stop testing other terms of this sequence.
-      if (IsPrime(theFactor, seqPtr, n))
-      {
-         WriteToConsole(COT_OTHER, "%s is prime!", buffer);
-         WriteToLog("%s is prime!", buffer);
-         isPrime = true;
-      }
-      else
-      {
-         il_TermCount--;
-         il_FactorCount++;
-         seqPtr->nTerms[nbit] = false;
-         wasRemoved = true;
-      }
-   }
+   wasRemoved = RemoveTerm(theFactor, seqPtr, n, buffer, isPrime);
 
    if (theFactor > GetMaxPrimeForSingleWorker())
       ip_FactorAppLock->Release();
 
+   Counters::StopTimer(ii_TermRemovalTimer, startNS);
+
    if (isPrime)
       return;
 
@@ -1326,6 +1298,69 @@ void     SierpinskiRieselApp::ReportFactor(uint64_t theFactor, seq_t *seqPtr, ui
    LogFactor(theFactor, "%s", buffer);
 }
 
+// This is executed in the factor writer thread or by a worker waiting for space in its queue
+void     SierpinskiRieselApp::ApplyQueuedFactors(factorentry_t *entries, uint32_t count)
+{
+   bool     wasRemoved;
+   bool     isPrime;
+   char     buffer[200];
+
+   ip_FactorAppLock->Lock();
+
+   for (uint32_t idx=0; idx<count; idx++)
+   {
+      seq_t   *seqPtr = (seq_t *) entries[idx].termPtr;
+      uint32_t n = (uint32_t) entries[idx].termIdx;
+
+      wasRemoved = RemoveTerm(entries[idx].factor, seqPtr, n, buffer, isPrime);
+
+      if (isPrime)
+         continue;
+
+      if (entries[idx].verifyFactor)
+         VerifyFactor(entries[idx].factor, seqPtr, n);
+
+      if (wasRemoved)
+         LogFactor(entries[idx].factor, "%s", buffer);
+   }
+
+   ip_FactorAppLock->Release();
+}
+
+// The caller must hold ip_FactorAppLock unless there is only one worker
+bool     SierpinskiRieselApp::RemoveTerm(uint64_t theFactor, seq_t *seqPtr, uint32_t n, char *term, bool &isPrime)
+{
+   uint32_t nbit;
+
+   isPrime = false;
+
+   if (seqPtr->d > 1)
+      sprintf(term, "(%" PRIu64"*%u^%u%+" PRId64")/%u", seqPtr->k, ii_Base, n, seqPtr->c, seqPtr->d);
+   else
+      sprintf(term, "%" PRIu64"*%u^%u%+" PRId64"", seqPtr->k, ii_Base, n, seqPtr->c);
+
+   nbit = NBIT(n);
+
+   if (!seqPtr->nTerms[nbit])
+      return false;
+
+   // Do not remove terms where k*b^n+c is prime.  This means that PRP testing program
+   // should identify this term as prime and stop testing other terms of this sequence.
+   if (IsPrime(theFactor, seqPtr, n))
+   {
+      WriteToConsole(COT_OTHER, "%s is prime!", term);
+      WriteToLog("%s is prime!", term);
+      isPrime = true;
+      return false;
+   }
+
+   il_TermCount--;
+   il_FactorCount++;
+   seqPtr->nTerms.Clear(nbit);
+
+   return true;
+}
+
 void  SierpinskiRieselApp::VerifyFactor(uint64_t theFactor, seq_t *seqPtr, uint32_t n)
 {
    uint64_t  rem;
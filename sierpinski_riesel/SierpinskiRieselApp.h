@@ -11,14 +11,15 @@
 #ifndef _SierpinskiRieselApp_H
 #define _SierpinskiRieselApp_H
 
-#include "../core/FactorApp.h"
+#include "../core/QueuedFactorApp.h"
+#include "../core/HashTable.h"
 #include "AbstractSequenceHelper.h"
 
 #define NMAX_MAX (1 << 31)
 
 typedef enum { FF_UNKNOWN = 1, FF_ABCD, FF_ABC, FF_BOINC, FF_NUMBER_PRIMES } format_t;
 
-class SierpinskiRieselApp : public FactorApp
+class SierpinskiRieselApp : public QueuedFactorApp
 {
 public:
    SierpinskiRieselApp(void);
@@ -55,6 +56,10 @@ public:
    seq_t            *GetFirstSequenceAndSequenceCount(uint32_t &count) { count = ii_SequenceCount; return ip_FirstSequence; };
 
    double            GetBabyStepFactor(void) { return id_BabyStepFactor; };
+   hashtable_t       GetHashTableType(void) { return it_HashTableType; };
+
+   // The GPU kernels only support the chained hash table
+   uint32_t          GetMaxHashTableElements(void) { return ((it_HashTableType == HT_CHAINED || GetGpuWorkerCount() > 0) ? HASH_MAX_ELTS : SWISS_MAX_ELTS); };
    uint32_t          GetBaseMultipleMulitplier(void) { return ii_BaseMultipleMultiplier; };
    uint32_t          GetPowerResidueLcmMultiplier(void) { return ii_PowerResidueLcmMulitplier; };
    uint32_t          GetLimitBaseMultiplier(void) { return ii_LimitBaseMultiplier; };
@@ -77,8 +82,11 @@ protected:
    void              WriteOutputTermsFile(uint64_t largestPrime);
    Worker           *CreateWorker(uint32_t id, bool gpuWorker, uint64_t largestPrimeTested);
 
+   void              ApplyQueuedFactors(factorentry_t *entries, uint32_t count);
+
 private:
    double            id_BabyStepFactor;
+   hashtable_t       it_HashTableType;
    uint32_t          ii_BaseMultipleMultiplier;
    uint32_t          ii_PowerResidueLcmMulitplier;
    uint32_t          ii_LimitBaseMultiplier;
@@ -92,6 +100,7 @@ private:
    std::string       is_SequencesToRemove;
 
    bool              LoadSequencesFromFile(char *fileName);
+   bool              RemoveTerm(uint64_t theFactor, seq_t *seqPtr, uint32_t n, char *term, bool &isPrime);
    void              ValidateAndAddNewSequence(char *arg);
 
    void              MakeSubsequences(bool newSieve, uint64_t largestPrimeTested);
@@ -135,6 +144,9 @@ private:
 
    uint32_t          ii_SequenceCount;
 
+   // The time workers spend removing terms, including the time waiting for ip_FactorAppLock
+   static uint32_t   ii_TermRemovalTimer;
+
 #if defined(USE_OPENCL) || defined(USE_METAL)
    uint32_t          ii_GpuFactorDensity;
    uint32_t          ii_MaxGpuFactors;
@@ -128,8 +128,8 @@ void SmarandacheApp::ValidateOptions(void)
    {
       ProcessInputTermsFile(false);
 
-      iv_Terms.resize(ii_MaxN - ii_MinN + 1);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), false);
+      iv_Terms.Resize(ii_MaxN - ii_MinN + 1);
+      iv_Terms.Fill(false);
 
       il_TermCount = 0;
       ProcessInputTermsFile(true);
@@ -139,8 +139,8 @@ void SmarandacheApp::ValidateOptions(void)
       if (ii_MaxN <= ii_MinN)
          FatalError("The value for -N must be greater than the value for -n");
 
-      iv_Terms.resize(ii_MaxN - ii_MinN + 1);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), true);
+      iv_Terms.Resize(ii_MaxN - ii_MinN + 1);
+      iv_Terms.Fill(true);
 
       il_TermCount = (ii_MaxN - ii_MinN + 1);
    }
@@ -225,7 +225,7 @@ void SmarandacheApp::ProcessInputTermsFile(bool haveBitMap)
 
       if (haveBitMap)
       {
-         iv_Terms[BIT(n)] = true;
+         iv_Terms.Set(BIT(n));
          il_TermCount++;
       }
       else
@@ -255,7 +255,7 @@ bool SmarandacheApp::ApplyFactor(uint64_t thePrime, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (iv_Terms[bit])
    {
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       il_TermCount--;
       return true;
    }
@@ -314,7 +314,7 @@ bool SmarandacheApp::ReportFactor(uint64_t theFactor, uint32_t n)
    if (iv_Terms[bit])
    {
       newFactor = true;
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       il_TermCount--;
       il_FactorCount++;
 
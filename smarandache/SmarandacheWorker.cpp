@@ -22,6 +22,8 @@ SmarandacheWorker::SmarandacheWorker(uint32_t myId, App *theApp) : Worker(myId,
 
    ip_Terms = ip_SmarandacheApp->GetTerms();
 
+   UseMontgomeryContext();
+
    ib_Initialized = true;
 }
 
@@ -53,9 +55,8 @@ bool  SmarandacheWorker::TestSixDigitN(void)
    uint64_t  ps[4], maxPrime = ip_App->GetMaxPrime();
    uint32_t *terms = ip_Terms->termList;
    uint32_t  termCount = ip_Terms->termCount;
-   uint64_t  invmod2[4];
-   uint64_t  invmod3[4];
-   uint64_t  invmod4[4];
+   MpResVec  resDivisors[3];
+   MpResVec  resInvmod[3];
    bool      factorFound = false;
 
    uint64_t  m = ((uint64_t) terms[0] * 999999) + 1000000;
@@ -68,69 +69,28 @@ bool  SmarandacheWorker::TestSixDigitN(void)
       ps[2] = il_PrimeList[pIdx+2];
       ps[3] = il_PrimeList[pIdx+3];
 
-      if (ps[0] < 12321)
-      {
-         invmod2[0] = InvMod64(12321 % ps[0], ps[0]);
-         invmod2[1] = InvMod64(12321 % ps[1], ps[1]);
-         invmod2[2] = InvMod64(12321 % ps[2], ps[2]);
-         invmod2[3] = InvMod64(12321 % ps[3], ps[3]);
-      }
-      else
-      {
-         invmod2[0] = InvMod64(12321, ps[0]);
-         invmod2[1] = InvMod64(12321, ps[1]);
-         invmod2[2] = InvMod64(12321, ps[2]);
-         invmod2[3] = InvMod64(12321, ps[3]);
-      }
-
-      if (ps[0] < 1234321)
-      {
-         invmod3[0] = InvMod64(1234321 % ps[0], ps[0]);
-         invmod3[1] = InvMod64(1234321 % ps[1], ps[1]);
-         invmod3[2] = InvMod64(1234321 % ps[2], ps[2]);
-         invmod3[3] = InvMod64(1234321 % ps[3], ps[3]);
-      }
-      else
-      {
-         invmod3[0] = InvMod64(1234321, ps[0]);
-         invmod3[1] = InvMod64(1234321, ps[1]);
-         invmod3[2] = InvMod64(1234321, ps[2]);
-         invmod3[3] = InvMod64(1234321, ps[3]);
-      }
-
-      if (ps[0] < 123454321)
-      {
-         invmod4[0] = InvMod64(123454321 % ps[0], ps[0]);
-         invmod4[1] = InvMod64(123454321 % ps[1], ps[1]);
-         invmod4[2] = InvMod64(123454321 % ps[2], ps[2]);
-         invmod4[3] = InvMod64(123454321 % ps[3], ps[3]);
-      }
-      else
-      {
-         invmod4[0] = InvMod64(123454321, ps[0]);
-         invmod4[1] = InvMod64(123454321, ps[1]);
-         invmod4[2] = InvMod64(123454321, ps[2]);
-         invmod4[3] = InvMod64(123454321, ps[3]);
-      }
-
-
-      MpArithVec mp(ps);
+      MpArithVec mp(ik_MpContext, pIdx);
 
       MpResVec res10E1 = mp.nToRes(10);
 
       MpResVec tempMul1 = mp.nToRes(15208068915062105958ULL);
       MpResVec tempSub1 = mp.nToRes(11211123422ULL);
 
+      // The divisors of the steps below, inverted together so that there is only one
+      // inversion per prime
+      resDivisors[0] = mp.nToRes(12321);
+      resDivisors[1] = mp.nToRes(1234321);
+      resDivisors[2] = mp.nToRes(123454321);
+
+      mp.inv(resDivisors, resInvmod, 3);
+
       MpResVec tempSub2 = mp.nToRes(1109890222);
-      MpResVec resInvmod2 = mp.nToRes(invmod2);
 
       MpResVec tempMul3 = mp.nToRes(123454321);
       MpResVec tempSub3 = mp.nToRes(1110988902222ULL);
-      MpResVec resInvmod3 = mp.nToRes(invmod3);
 
       MpResVec tempMul4 = mp.nToRes(12345654321ULL);
       MpResVec tempSub4 = mp.nToRes(1111098889022222ULL);
-      MpResVec resInvmod4 = mp.nToRes(invmod4);
 
       //     t = powmod(10,179,f);
       //     C = mulmod(t,15208068915062105958ULL%f,f);
@@ -148,7 +108,7 @@ bool  SmarandacheWorker::TestSixDigitN(void)
       resTemp = mp.pow(res10E1, 2699);
       resC = mp.mul(resC, resTemp);
       resC = mp.sub(resC, tempSub2);
-      resC = mp.mul(resC, resInvmod2);
+      resC = mp.mul(resC, resInvmod[0]);
 
       //     t = powmod(10,35999,f);
       //     C = mulmod(C, t, f);
@@ -160,7 +120,7 @@ bool  SmarandacheWorker::TestSixDigitN(void)
       resC = mp.mul(resC, resTemp);
       resC = mp.mul(resC, tempMul3);
       resC = mp.sub(resC, tempSub3);
-      resC = mp.mul(resC, resInvmod3);
+      resC = mp.mul(resC, resInvmod[1]);
       resC = mp.mul(resC, tempMul4);
 
       //      C = mulmod(C,12345654321ULL % f, f);
@@ -172,7 +132,7 @@ bool  SmarandacheWorker::TestSixDigitN(void)
       resTemp = mp.pow(res10E1, 449999);
       resC = mp.mul(resC, resTemp);
       resC = mp.sub(resC, tempSub4);
-      resC = mp.mul(resC, resInvmod4);
+      resC = mp.mul(resC, resInvmod[2]);
 
       //      t = powmod(10,6*v[0]-599989,f);
       //      C = mulmod(C, t, f);
@@ -260,7 +220,6 @@ bool  SmarandacheWorker::TestSevenDigitN(void)
    uint64_t  ps[4], maxPrime = ip_App->GetMaxPrime();
    uint32_t *terms = ip_Terms->termList;
    uint32_t  termCount = ip_Terms->termCount;
-   uint64_t  invmod2[4], invmod3[4], invmod4[4], invmod5[4], invmod6[4];
    bool      factorFound = false;
    uint64_t  two9sq = 99;
    uint64_t  three9sq = 999;
@@ -281,7 +240,8 @@ bool  SmarandacheWorker::TestSevenDigitN(void)
 
    MpResVec resTemp;
    MpResVec resT[7];
-   MpResVec resInvmod;
+   MpResVec resDivisors[5];
+   MpResVec resInvmod[5];
 
    for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx+=4)
    {
@@ -290,72 +250,17 @@ bool  SmarandacheWorker::TestSevenDigitN(void)
       ps[2] = il_PrimeList[pIdx+2];
       ps[3] = il_PrimeList[pIdx+3];
 
-      invmod2[0] = InvMod64(two9sq, ps[0]);
-      invmod2[1] = InvMod64(two9sq, ps[1]);
-      invmod2[2] = InvMod64(two9sq, ps[2]);
-      invmod2[3] = InvMod64(two9sq, ps[3]);
+      MpArithVec mp(ik_MpContext, pIdx);
 
-      if (ps[0] < three9sq)
-      {
-         invmod3[0] = InvMod64(three9sq%ps[0], ps[0]);
-         invmod3[1] = InvMod64(three9sq%ps[1], ps[1]);
-         invmod3[2] = InvMod64(three9sq%ps[2], ps[2]);
-         invmod3[3] = InvMod64(three9sq%ps[3], ps[3]);
-      }
-      else
-      {
-         invmod3[0] = InvMod64(three9sq, ps[0]);
-         invmod3[1] = InvMod64(three9sq, ps[1]);
-         invmod3[2] = InvMod64(three9sq, ps[2]);
-         invmod3[3] = InvMod64(three9sq, ps[3]);
-      }
-
-      if (ps[0] < four9sq)
-      {
-         invmod4[0] = InvMod64(four9sq%ps[0], ps[0]);
-         invmod4[1] = InvMod64(four9sq%ps[1], ps[1]);
-         invmod4[2] = InvMod64(four9sq%ps[2], ps[2]);
-         invmod4[3] = InvMod64(four9sq%ps[3], ps[3]);
-      }
-      else
-      {
-         invmod4[0] = InvMod64(four9sq, ps[0]);
-         invmod4[1] = InvMod64(four9sq, ps[1]);
-         invmod4[2] = InvMod64(four9sq, ps[2]);
-         invmod4[3] = InvMod64(four9sq, ps[3]);
-      }
-
-      if (ps[0] < five9sq)
-      {
-         invmod5[0] = InvMod64(five9sq%ps[0], ps[0]);
-         invmod5[1] = InvMod64(five9sq%ps[1], ps[1]);
-         invmod5[2] = InvMod64(five9sq%ps[2], ps[2]);
-         invmod5[3] = InvMod64(five9sq%ps[3], ps[3]);
-      }
-      else
-      {
-         invmod5[0] = InvMod64(five9sq, ps[0]);
-         invmod5[1] = InvMod64(five9sq, ps[1]);
-         invmod5[2] = InvMod64(five9sq, ps[2]);
-         invmod5[3] = InvMod64(five9sq, ps[3]);
-      }
-
-      if (ps[0] < six9sq)
-      {
-         invmod6[0] = InvMod64(six9sq%ps[0], ps[0]);
-         invmod6[1] = InvMod64(six9sq%ps[1], ps[1]);
-         invmod6[2] = InvMod64(six9sq%ps[2], ps[2]);
-         invmod6[3] = InvMod64(six9sq%ps[3], ps[3]);
-      }
-      else
-      {
-         invmod6[0] = InvMod64(six9sq, ps[0]);
-         invmod6[1] = InvMod64(six9sq, ps[1]);
-         invmod6[2] = InvMod64(six9sq, ps[2]);
-         invmod6[3] = InvMod64(six9sq, ps[3]);
-      }
+      // The divisors of the steps below, inverted together so that there is only one
+      // inversion per prime
+      resDivisors[0] = mp.nToRes(two9sq);
+      resDivisors[1] = mp.nToRes(three9sq);
+      resDivisors[2] = mp.nToRes(four9sq);
+      resDivisors[3] = mp.nToRes(five9sq);
+      resDivisors[4] = mp.nToRes(six9sq);
 
-      MpArithVec mp(ps);
+      mp.inv(resDivisors, resInvmod, 5);
 
       MpResVec res10e1 = mp.nToRes(10);
       MpResVec res10en = mp.nToRes(10);
@@ -381,8 +286,7 @@ bool  SmarandacheWorker::TestSevenDigitN(void)
       resAx = mp.mul(resAx, resTemp);
       res10en = mp.mul(res10e1, res10e1);
       resAx = mp.sub(resAx, res10en);
-      resInvmod = mp.nToRes(invmod2);
-      resAx = mp.mul(resAx, resInvmod);
+      resAx = mp.mul(resAx, resInvmod[0]);
       resAx = mp.sub(resAx, mp.one());
 
       // calculate a3x
@@ -402,8 +306,7 @@ bool  SmarandacheWorker::TestSevenDigitN(void)
       resAx = mp.mul(resAx, resTemp);
       res10en = mp.mul(res10en, res10e1);
       resAx = mp.sub(resAx, res10en);
-      resInvmod = mp.nToRes(invmod3);
-      resAx = mp.mul(resAx, resInvmod);
+      resAx = mp.mul(resAx, resInvmod[1]);
       resAx = mp.sub(resAx, mp.one());
 
        // calculate a4x
@@ -423,8 +326,7 @@ bool  SmarandacheWorker::TestSevenDigitN(void)
       resAx = mp.mul(resAx, resTemp);
       res10en = mp.mul(res10en, res10e1);
       resAx = mp.sub(resAx, res10en);
-      resInvmod = mp.nToRes(invmod4);
-      resAx = mp.mul(resAx, resInvmod);
+      resAx = mp.mul(resAx, resInvmod[2]);
       resAx = mp.sub(resAx, mp.one());
 
       // calculate a5x
@@ -444,8 +346,7 @@ bool  SmarandacheWorker::TestSevenDigitN(void)
       resAx = mp.mul(resAx, resTemp);
       res10en = mp.mul(res10en, res10e1);
       resAx = mp.sub(resAx, res10en);
-      resInvmod = mp.nToRes(invmod5);
-      resAx = mp.mul(resAx, resInvmod);
+      resAx = mp.mul(resAx, resInvmod[3]);
       resAx = mp.sub(resAx, mp.one());
 
       // calculate a6x
@@ -465,8 +366,7 @@ bool  SmarandacheWorker::TestSevenDigitN(void)
       resAx = mp.mul(resAx, resTemp);
       res10en = mp.mul(res10en, res10e1);
       resAx = mp.sub(resAx, res10en);
-      resInvmod = mp.nToRes(invmod6);
-      resAx = mp.mul(resAx, resInvmod);
+      resAx = mp.mul(resAx, resInvmod[4]);
       resAx = mp.sub(resAx, mp.one());
 
       // calculate a7(n)
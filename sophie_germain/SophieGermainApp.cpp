@@ -16,7 +16,7 @@
 #include "SophieGermainWorker.h"
 
 #define APP_NAME        "sgsieve"
-#define APP_VERSION     "1.3"
+#define APP_VERSION     "1.3.1"
 
 #define NMAX_MAX        (1 << 31)
 
@@ -44,7 +44,7 @@ SophieGermainApp::SophieGermainApp() : FactorApp()
 
    SetAppMinPrime(3);
 
-   iv_Terms.clear();
+   iv_Terms.Free();
 }
 
 void SophieGermainApp::Help(void)
@@ -132,8 +132,8 @@ void SophieGermainApp::ValidateOptions(void)
 
       ProcessInputTermsFile(false);
 
-      iv_Terms.resize(((il_MaxK - il_MinK) >> 1) + 1);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), false);
+      iv_Terms.Resize(((il_MaxK - il_MinK) >> 1) + 1);
+      iv_Terms.Fill(false);
 
       ProcessInputTermsFile(true);
    }
@@ -185,8 +185,8 @@ void SophieGermainApp::ValidateOptions(void)
 
       il_TermCount = ((il_MaxK - il_MinK) >> 1) + 1;
 
-      iv_Terms.resize(il_TermCount);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), true);
+      iv_Terms.Resize(il_TermCount);
+      iv_Terms.Fill(true);
 
    }
 
@@ -270,7 +270,7 @@ void SophieGermainApp::ProcessInputTermsFile(bool haveBitMap)
       {
          bit = BIT(k);
 
-         iv_Terms[bit] = true;
+         iv_Terms.Set(bit);
          il_TermCount++;
       }
       else
@@ -301,7 +301,7 @@ void SophieGermainApp::ProcessInputTermsFile(bool haveBitMap)
          {
             bit = BIT(k);
 
-            iv_Terms[bit] = true;
+            iv_Terms.Set(bit);
             il_TermCount++;
          }
          else
@@ -331,7 +331,7 @@ void SophieGermainApp::ProcessInputTermsFile(bool haveBitMap)
          {
             bit = BIT(k);
 
-            iv_Terms[bit] = true;
+            iv_Terms.Set(bit);
             il_TermCount++;
          }
          else
@@ -376,7 +376,7 @@ bool SophieGermainApp::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (iv_Terms[bit])
    {
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       il_TermCount--;
 
       return true;
@@ -492,7 +492,7 @@ void  SophieGermainApp::ReportFactor(uint64_t theFactor, uint64_t k, bool firstO
 
    if (iv_Terms[bit])
    {
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
 
       if (firstOfPair)
          LogFactor(theFactor, "%" PRIu64"*%u^%u-1", k, ii_Base, ii_N);
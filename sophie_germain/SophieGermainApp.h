@@ -58,7 +58,7 @@ private:
 
    void              VerifyFactor(uint64_t theFactor, uint64_t k, bool firstOfPair);
 
-   std::vector<bool> iv_Terms;
+   TermBitmap        iv_Terms;
 
    bool              ib_GeneralizedSearch;
    format_t          it_Format;
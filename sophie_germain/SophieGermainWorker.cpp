@@ -21,8 +21,11 @@ SophieGermainWorker::SophieGermainWorker(uint32_t myId, App *theApp) : Worker(my
    il_MaxK = ip_SophieGermainApp->GetMaxK();
    ii_Base = ip_SophieGermainApp->GetBase();
    ii_N = ip_SophieGermainApp->GetN();
+   ik_NPlan = MpPowPlan(ii_N);
    ib_GeneralizedSearch = ip_SophieGermainApp->IsGeneralizedSearch();
 
+   UseMontgomeryContext();
+
    // The thread can't start until initialization is done
    ib_Initialized = true;
 }
@@ -70,10 +73,10 @@ void  SophieGermainWorker::TestMegaPrimeChunkSmall(void)
       // Starting with k*b^n = 1 (mod p)
       //           --> k = (1/b)^n (mod p)
       //           --> k = inv(b)^n (mod p)
-      MpArithVec mp(ps);
+      MpArithVec mp(ik_MpContext, pIdx);
 
       MpResVec resInvs = mp.nToRes(invs);
-      MpResVec res = mp.pow(resInvs, ii_N);
+      MpResVec res = mp.pow(resInvs, ik_NPlan);
       MpResVec resKs = mp.resToN(res);
 
       if (resKs[0] <= il_MaxK) RemoveTermsSmallPrime(resKs[0], true, ps[0]);
@@ -132,8 +135,6 @@ void  SophieGermainWorker::TestMegaPrimeChunkLarge(void)
       ps[2] = il_PrimeList[pIdx+2];
       ps[3] = il_PrimeList[pIdx+3];
 
-      pIdx += 4;
-
       if (ii_Base == 2)
       {
          invs[0] = (1+ps[0]) >> 1;
@@ -152,10 +153,12 @@ void  SophieGermainWorker::TestMegaPrimeChunkLarge(void)
       // Starting with k*b^n = 1 (mod p)
       //           --> k = (1/b)^n (mod p)
       //           --> k = inv(b)^n (mod p)
-      MpArithVec mp(ps);
+      MpArithVec mp(ik_MpContext, pIdx);
+
+      pIdx += 4;
 
       MpResVec resInvs = mp.nToRes(invs);
-      MpResVec res = mp.pow(resInvs, ii_N);
+      MpResVec res = mp.pow(resInvs, ik_NPlan);
       MpResVec resKs = mp.resToN(res);
 
       if (resKs[0] >= il_MinK && resKs[0] <= il_MaxK) RemoveTermsLargePrime(resKs[0], true, ps[0]);
@@ -242,85 +245,88 @@ void    SophieGermainWorker::RemoveTermsSmallPrime(uint64_t k, bool firstOfPair,
 
 
 // Using this bypasses a number of if checks that can be done when prime > il_MaxK.
-// Do not report k/n combinations if the k*2^n+1 is divisible by any p < 50
+// Do not report k/n combinations if the term (k*2^n-1 or k*2^(n+1)-1) is divisible
+// by any p < 50 as those terms have already been removed.
 void    SophieGermainWorker::RemoveTermsLargePrime(uint64_t k, bool firstOfPair, uint64_t prime)
 {
+   uint32_t n = (firstOfPair ? ii_N : ii_N + 1);
    uint32_t smallN;
    uint64_t smallK;
 
+   if (ii_Base & 1)
+   {
+      // Make sure that k is even
+      if (k & 1)
+         k += prime;
+   }
+   else
+   {
+      // Make sure that k is odd
+      if (!(k & 1))
+         k += prime;
+   }
+
+   if (k < il_MinK || k > il_MaxK) return;
+
    if (ii_Base == 2)
    {
-      smallN = ii_N % (2);
+      smallN = n % (2);
       smallK = k % (3);
-      if ((smallK << smallN) % (3) == 2) return;
+      if ((smallK << smallN) % (3) == 1) return;
 
-      smallN = ii_N % (4);
+      smallN = n % (4);
       smallK = k % (5);
-      if ((smallK << smallN) % (5) == 4) return;
+      if ((smallK << smallN) % (5) == 1) return;
 
-      smallN = ii_N % (6);
+      smallN = n % (6);
       smallK = k % (7);
-      if ((smallK << smallN) % (7) == 6) return;
+      if ((smallK << smallN) % (7) == 1) return;
 
-      smallN = ii_N % (10);
+      smallN = n % (10);
       smallK = k % (11);
-      if ((smallK << smallN) % (11) == 10) return;
+      if ((smallK << smallN) % (11) == 1) return;
 
-      smallN = ii_N % (12);
+      smallN = n % (12);
       smallK = k % (13);
-      if ((smallK << smallN) % (13) == 12) return;
+      if ((smallK << smallN) % (13) == 1) return;
 
-      smallN = ii_N % (16);
+      smallN = n % (16);
       smallK = k % (17);
-      if ((smallK << smallN) % (17) == 16) return;
+      if ((smallK << smallN) % (17) == 1) return;
 
-      smallN = ii_N % (18);
+      smallN = n % (18);
       smallK = k % (19);
-      if ((smallK << smallN) % (19) == 18) return;
+      if ((smallK << smallN) % (19) == 1) return;
 
-      smallN = ii_N % (22);
+      smallN = n % (22);
       smallK = k % (23);
-      if ((smallK << smallN) % (23) == 22) return;
+      if ((smallK << smallN) % (23) == 1) return;
 
-      smallN = ii_N % (28);
+      smallN = n % (28);
       smallK = k % (29);
-      if ((smallK << smallN) % (29) == 28) return;
+      if ((smallK << smallN) % (29) == 1) return;
 
-      smallN = ii_N % (30);
+      smallN = n % (30);
       smallK = k % (31);
-      if ((smallK << smallN) % (31) == 30) return;
+      if ((smallK << smallN) % (31) == 1) return;
 
-      smallN = ii_N % (36);
+      smallN = n % (36);
       smallK = k % (37);
-      if ((smallK << smallN) % (37) == 36) return;
+      if ((smallK << smallN) % (37) == 1) return;
 
-      smallN = ii_N % (40);
+      smallN = n % (40);
       smallK = k % (41);
-      if ((smallK << smallN) % (41) == 40) return;
+      if ((smallK << smallN) % (41) == 1) return;
 
-      smallN = ii_N % (42);
+      smallN = n % (42);
       smallK = k % (43);
-      if ((smallK << smallN) % (43) == 42) return;
+      if ((smallK << smallN) % (43) == 1) return;
 
-      smallN = ii_N % (46);
+      smallN = n % (46);
       smallK = k % (47);
-      if ((smallK << smallN) % (47) == 46) return;
+      if ((smallK << smallN) % (47) == 1) return;
    }
 
-   if (ii_Base & 1)
-   {
-      // Make sure that k is even
-      if (k & 1)
-         k += prime;
-   }
-   else
-   {
-      // Make sure that k is odd
-      if (!(k & 1))
-         k += prime;
-   }
-
-   if (k < il_MinK || k > il_MaxK) return;
 
    ip_SophieGermainApp->ReportFactor(prime, k, firstOfPair, true);
 }
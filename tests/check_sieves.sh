@@ -0,0 +1,85 @@
+#!/bin/sh
+# check_sieves.sh -- (C) Mark Rodenkirch, October 2026
+#
+# Run each sieve on a small range with 1 and 4 workers and compare the results with
+# those of v1.6.4, which generated all primes in the App.
+#
+#   - "Primes tested" must be the number of primes that were actually tested.  Each
+#     worker pads its prime list with copies of the last prime, which must not be counted.
+#   - With 1 worker, the factors written with -O must be the same as v1.6.4.
+#   - The terms that remain must be the same as v1.6.4 regardless of the number of workers.
+#
+# srsieve2 tests primes out of order, so only its remaining terms are compared.
+#
+# fbnc and twin use an odd base and start at p = 1, so the first block of each worker
+# includes p = 2.  Their expected results are those of the x87 kernel, i.e. -E fpu.
+#
+# Run this from the directory with the executables, i.e. "make check" or
+# "sh tests/check_sieves.sh".
+
+failed=0
+bin=$(pwd)
+work=$(mktemp -d)
+
+hash_file()
+{
+   grep -v -i sieved "$1" | sort | md5sum | cut -c1-8
+}
+
+# name, primes tested, factors, terms, program, arguments
+check()
+{
+   name=$1; primes=$2; factors=$3; terms=$4; shift 4
+
+   for workers in 1 4
+   do
+      rm -f $work/$name.*
+
+      # Run in the work directory so that the log files of the sieves are written there
+      (cd $work && "$bin/$@" -W$workers -o $name.terms -O $name.factors > $name.log 2>&1)
+
+      if [ $? -ne 0 ]; then
+         echo "$name -W$workers: failed, see below"
+         cat $work/$name.log
+         failed=1
+         continue
+      fi
+
+      tested=$(grep -o "Primes tested: [0-9]*" $work/$name.log | cut -d' ' -f3)
+
+      if [ "$tested" != "$primes" ]; then
+         echo "$name -W$workers: tested $tested primes, expected $primes"
+         failed=1
+      fi
+
+      if [ $workers -eq 1 ] && [ "$factors" != "-" ] && [ "$(hash_file $work/$name.factors)" != "$factors" ]; then
+         echo "$name -W$workers: factors are not the same as v1.6.4"
+         failed=1
+      fi
+
+      if [ "$(hash_file $work/$name.terms)" != "$terms" ]; then
+         echo "$name -W$workers: remaining terms are not the same as v1.6.4"
+         failed=1
+      fi
+   done
+}
+
+check af   78498 085a47a2 982106d1 afsieve -n 10 -N 2000 -P 1e6
+check ck   39221 f4b83387 1447ad3f cksieve -b 2 -n 100 -N 3000 -P 1e6
+check fbnc 78497 89ba3d76 0c84eb7a fbncsieve -k 1 -K 10000 -s "k*3^500+1" -P 1e6
+check gcw  78497 740d00d5 5a1b0236 gcwsieve -b 2 -n 100 -N 20000 -s b -P 1e6
+check k1b2 78497 d5de222a caa057aa k1b2sieve -n 100 -N 2000 -c -99 -C 99 -P 1e6
+check mf   78497 65b4ff45 6700153b mfsieve -n 10 -N 5000 -m 1 -P 1e6
+check sg   78497 9ecb19ca 5812c961 sgsieve -k 1 -K 200000 -b 2 -n 1000 -P 1e6
+check sr   78443 -        82119fe6 srsieve2 -n 1000 -N 50000 -s "3*2^n-1" -P 1e6
+check twin 78497 599ca931 2cf88021 twinsieve -k 1 -K 10000 -b 3 -n 500 -P 1e6
+check xyyx 78497 d5d58173 e2460d32 xyyxsieve -x 10 -X 300 -y 10 -Y 300 -s + -P 1e6
+
+rm -rf $work
+
+if [ $failed -ne 0 ]; then
+   echo "FAILED"
+   exit 1
+fi
+
+echo "All sieves passed"
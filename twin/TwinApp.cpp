@@ -15,7 +15,7 @@
 #include "TwinWorker.h"
 
 #define APP_NAME        "twinsieve"
-#define APP_VERSION     "1.3"
+#define APP_VERSION     "1.4"
 
 #define NMAX_MAX        (1 << 31)
 #define BMAX_MAX        (1 << 31)
@@ -44,9 +44,9 @@ TwinApp::TwinApp() : FactorApp()
 
    il_MaxPrimeForValidFactor = PMAX_MAX_62BIT;
 
-   iv_TwinTerms.clear();
-   iv_MinusTerms.clear();
-   iv_PlusTerms.clear();
+   iv_TwinTerms.Free();
+   iv_MinusTerms.Free();
+   iv_PlusTerms.Free();
 }
 
 void TwinApp::Help(void)
@@ -141,16 +141,16 @@ void TwinApp::ValidateOptions(void)
 
       if (ib_OnlyTwins)
       {
-         iv_TwinTerms.resize(il_MaxK - il_MinK + 1);
-         std::fill(iv_TwinTerms.begin(), iv_TwinTerms.end(), false);
+         iv_TwinTerms.Resize(il_MaxK - il_MinK + 1);
+         iv_TwinTerms.Fill(false);
       }
       else
       {
-         iv_MinusTerms.resize(il_MaxK - il_MinK + 1);
-         std::fill(iv_MinusTerms.begin(), iv_MinusTerms.end(), false);
+         iv_MinusTerms.Resize(il_MaxK - il_MinK + 1);
+         iv_MinusTerms.Fill(false);
 
-         iv_PlusTerms.resize(il_MaxK - il_MinK + 1);
-         std::fill(iv_PlusTerms.begin(), iv_PlusTerms.end(), false);
+         iv_PlusTerms.Resize(il_MaxK - il_MinK + 1);
+         iv_PlusTerms.Fill(false);
       }
 
       ProcessInputTermsFile(true);
@@ -176,18 +176,18 @@ void TwinApp::ValidateOptions(void)
       {
          il_TermCount = il_MaxK - il_MinK + 1;
 
-         iv_TwinTerms.resize(il_MaxK - il_MinK + 1);
-         std::fill(iv_TwinTerms.begin(), iv_TwinTerms.end(), true);
+         iv_TwinTerms.Resize(il_MaxK - il_MinK + 1);
+         iv_TwinTerms.Fill(true);
       }
       else
       {
          il_TermCount = 2*(il_MaxK - il_MinK + 1);
 
-         iv_MinusTerms.resize(il_MaxK - il_MinK + 1);
-         std::fill(iv_MinusTerms.begin(), iv_MinusTerms.end(), true);
+         iv_MinusTerms.Resize(il_MaxK - il_MinK + 1);
+         iv_MinusTerms.Fill(true);
 
-         iv_PlusTerms.resize(il_MaxK - il_MinK + 1);
-         std::fill(iv_PlusTerms.begin(), iv_PlusTerms.end(), true);
+         iv_PlusTerms.Resize(il_MaxK - il_MinK + 1);
+         iv_PlusTerms.Fill(true);
       }
    }
 
@@ -212,7 +212,7 @@ void TwinApp::ValidateOptions(void)
             if (iv_TwinTerms[BIT(k)])
             {
                il_TermCount--;
-               iv_TwinTerms[BIT(k)] = false;
+               iv_TwinTerms.Clear(BIT(k));
             }
          }
          else
@@ -220,13 +220,13 @@ void TwinApp::ValidateOptions(void)
             if (iv_MinusTerms[BIT(k)])
             {
                il_TermCount--;
-               iv_MinusTerms[BIT(k)] = false;
+               iv_MinusTerms.Clear(BIT(k));
             }
 
             if (iv_PlusTerms[BIT(k)])
             {
                il_TermCount--;
-               iv_PlusTerms[BIT(k)] = false;
+               iv_PlusTerms.Clear(BIT(k));
             }
          }
       }
@@ -313,7 +313,7 @@ void TwinApp::ProcessInputTermsFile(bool haveBitMap)
 
       if (haveBitMap)
       {
-         iv_TwinTerms[k-il_MinK] = true;
+         iv_TwinTerms.Set(k-il_MinK);
          il_TermCount++;
       }
       else
@@ -413,15 +413,15 @@ void TwinApp::ProcessInputTermsFile(bool haveBitMap)
          bit = BIT(k);
          if (ib_OnlyTwins)
          {
-            iv_TwinTerms[bit] = true;
+            iv_TwinTerms.Set(bit);
             il_TermCount++;
          }
          else
          {
             if (c == -1)
-               iv_MinusTerms[bit] = true;
+               iv_MinusTerms.Set(bit);
             else
-               iv_PlusTerms[bit] = true;
+               iv_PlusTerms.Set(bit);
             il_TermCount++;
          }
       }
@@ -463,7 +463,7 @@ bool TwinApp::ApplyFactor(uint64_t theFactor,  const char *term)
    {
       if (iv_TwinTerms[bit])
       {
-         iv_TwinTerms[bit] = false;
+         iv_TwinTerms.Clear(bit);
          il_TermCount--;
 
          return true;
@@ -473,7 +473,7 @@ bool TwinApp::ApplyFactor(uint64_t theFactor,  const char *term)
    {
       if (c == -1 && iv_MinusTerms[bit])
       {
-         iv_MinusTerms[bit] = false;
+         iv_MinusTerms.Clear(bit);
          il_TermCount--;
 
          return true;
@@ -481,7 +481,7 @@ bool TwinApp::ApplyFactor(uint64_t theFactor,  const char *term)
 
       if (c == +1 && iv_PlusTerms[bit])
       {
-         iv_PlusTerms[bit] = false;
+         iv_PlusTerms.Clear(bit);
          il_TermCount--;
 
          return true;
@@ -652,7 +652,7 @@ bool  TwinApp::ReportFactor(uint64_t theFactor, uint64_t k, int32_t c)
    {
       if (iv_TwinTerms[bit])
       {
-         iv_TwinTerms[bit] = false;
+         iv_TwinTerms.Clear(bit);
          removedTerm = true;
 
          LogFactor(theFactor, "%s*%u^%u%+d", kStr, ii_Base, ii_N, c);
@@ -665,7 +665,7 @@ bool  TwinApp::ReportFactor(uint64_t theFactor, uint64_t k, int32_t c)
    {
       if (c == -1 && iv_MinusTerms[bit])
       {
-         iv_MinusTerms[bit] = false;
+         iv_MinusTerms.Clear(bit);
          removedTerm = true;
 
          LogFactor(theFactor, "%s*%u^%u-1", kStr, ii_Base, ii_N);
@@ -676,7 +676,7 @@ bool  TwinApp::ReportFactor(uint64_t theFactor, uint64_t k, int32_t c)
 
       if (c == +1 && iv_PlusTerms[bit])
       {
-         iv_PlusTerms[bit] = false;
+         iv_PlusTerms.Clear(bit);
          removedTerm = true;
 
          LogFactor(theFactor, "%s*%u^%u+1", kStr, ii_Base, ii_N);
@@ -56,9 +56,9 @@ private:
    uint64_t          WriteNewPGenTermsFile(uint64_t maxPrime, FILE *termsFile);
    void              AdjustMaxPrime(void);
 
-   std::vector<bool> iv_TwinTerms;
-   std::vector<bool> iv_MinusTerms;
-   std::vector<bool> iv_PlusTerms;
+   TermBitmap        iv_TwinTerms;
+   TermBitmap        iv_MinusTerms;
+   TermBitmap        iv_PlusTerms;
 
    std::string       is_InputFileName;
    std::string       is_OutputFileName;
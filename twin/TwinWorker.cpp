@@ -19,16 +19,21 @@ TwinWorker::TwinWorker(uint32_t myId, App *theApp) : Worker(myId, theApp)
    il_MinK = ip_TwinApp->GetMinK();
    il_MaxK = ip_TwinApp->GetMaxK();
    ii_Base = ip_TwinApp->GetBase();
+   ik_BaseDivisor.SetDivisor(ii_Base);
    ii_N = ip_TwinApp->GetN();
+   ik_NPlan = MpPowPlan(ii_N);
 
    ii_BaseInverses = 0;
 
+   UsePowModKernel();
+
    DeterminePrimeTermRange();
 
    BuildBaseInverses();
 
-   il_PrimeList = (uint64_t *) xmalloc((ip_TwinApp->GetCpuWorkSize() + 10) * sizeof(uint64_t));
-   ii_InverseList = (uint32_t *) xmalloc((ip_TwinApp->GetCpuWorkSize() + 10) * sizeof(uint32_t));
+   // This is allocated when we know how many primes are in the list
+   ii_InverseList = 0;
+   ii_InverseListSize = 0;
 
    // The thread can't start until initialization is done
    ib_Initialized = true;
@@ -36,34 +41,47 @@ TwinWorker::TwinWorker(uint32_t myId, App *theApp) : Worker(myId, theApp)
 
 void  TwinWorker::CleanUp(void)
 {
+   if (ii_InverseList)
+      xfree(ii_InverseList);
+
+   ii_InverseList = 0;
 }
 
 void  TwinWorker::TestMegaPrimeChunk(void)
 {
-   uint64_t p1 = 0, p2, p3, p4;
-   uint64_t k1, k2, k3, k4, ks[4];
+   uint64_t p = 0, k, ks[PRIME_LIST_MULTIPLE];
    uint64_t maxPrime = ip_App->GetMaxPrime();
    int32_t  svb = 0;
-   int32_t  pmb, count, idx;
+   int32_t  pmb, count, primes, idx;
+
+   // The worker can change the number of primes in the list
+   if (ii_PrimesInList > ii_InverseListSize)
+   {
+      if (ii_InverseList)
+         xfree(ii_InverseList);
+
+      ii_InverseListSize = ii_PrimesInList;
+      ii_InverseList = (uint32_t *) xmalloc((ii_InverseListSize + PRIME_LIST_MULTIPLE) * sizeof(uint32_t));
+   }
 
    // Evaluate primes in the vector to determine if can yield a factor.  Only
    // put primes that can yield a factor into an array for the second loop.
    count = 0;
    for (uint32_t pIdx=0; pIdx<ii_PrimesInList; pIdx++)
    {
-      p1 = il_PrimeList[pIdx];
+      p = il_PrimeList[pIdx];
 
-      pmb = (p1 % ii_Base);
+      pmb = ik_BaseDivisor.Mod(p);
 
       if (ii_BaseInverses[pmb] == 0)
          continue;
 
-      if (p1 > maxPrime)
+      if (p > maxPrime)
          break;
 
       svb = ii_BaseInverses[pmb];
 
-      il_PrimeList[count] = p1;
+      MovePrime(pIdx, count);
       ii_InverseList[count] = svb;
       count++;
    }
@@ -71,87 +89,61 @@ void  TwinWorker::TestMegaPrimeChunk(void)
    if (count == 0)
       return;
 
-   // Duplicate the last few entries so that the
-   // number of valid entries is divisible by 4.
-   while (count % 4 != 0)
+   // Duplicate the last few entries so that the number of valid
+   // entries is divisible by the number of primes in a block.
+   primes = count;
+
+   while (count % PRIME_LIST_MULTIPLE != 0)
    {
-      il_PrimeList[count] = p1;
+      MovePrime(count - 1, count);
       ii_InverseList[count] = svb;
       count++;
    }
 
-   for (idx=0; idx<count; idx+=4)
+   for (idx=0; idx<count; idx+=PRIME_LIST_MULTIPLE)
    {
-      p1 = il_PrimeList[idx+0];
-      p2 = il_PrimeList[idx+1];
-      p3 = il_PrimeList[idx+2];
-      p4 = il_PrimeList[idx+3];
-
-      ks[0] = k1 = (1+ii_InverseList[idx+0]*p1)/ii_Base;
-      ks[1] = k2 = (1+ii_InverseList[idx+1]*p2)/ii_Base;
-      ks[2] = k3 = (1+ii_InverseList[idx+2]*p3)/ii_Base;
-      ks[3] = k4 = (1+ii_InverseList[idx+3]*p4)/ii_Base;
-
       // Starting with k*2^n = 1 (mod p)
       //           --> k = (1/2)^n (mod p)
       //           --> k = inverse^n (mod p)
-      fpu_powmod_4b_1n_4p(ks, ii_N, &il_PrimeList[idx+0]);
-
-      k1 = p1 - ks[0];
-      k2 = p2 - ks[1];
-      k3 = p3 - ks[2];
-      k4 = p4 - ks[3];
-
-      if (p1 <= il_MaxK)
-      {
-         // This function allows for multiple terms to be removed
-         if (k1 <= il_MaxK) RemoveTermsSmallPrime(p1, k1, +1);
-         if (k2 <= il_MaxK) RemoveTermsSmallPrime(p2, k2, +1);
-         if (k3 <= il_MaxK) RemoveTermsSmallPrime(p3, k3, +1);
-         if (k4 <= il_MaxK) RemoveTermsSmallPrime(p4, k4, +1);
-      }
+      if (ii_Base == 2)
+         PowModBlockBase2(idx, ks, ik_NPlan, true);
       else
       {
-         // This function allows for a single term to be removed
-         if (k1 <= il_MaxK) RemoveTermsBigPrime(p1, k1, +1);
-         if (k2 <= il_MaxK) RemoveTermsBigPrime(p2, k2, +1);
-         if (k3 <= il_MaxK) RemoveTermsBigPrime(p3, k3, +1);
-         if (k4 <= il_MaxK) RemoveTermsBigPrime(p4, k4, +1);
-      }
+         for (int32_t j=0; j<PRIME_LIST_MULTIPLE; j++)
+            ks[j] = (1+ii_InverseList[idx+j]*il_PrimeList[idx+j])/ii_Base;
 
-      k1 = ks[0];
-      k2 = ks[1];
-      k3 = ks[2];
-      k4 = ks[3];
-
-      if (p1 <= il_MaxK)
-      {
-         // This function allows for multiple terms to be removed
-         if (k1 <= il_MaxK) RemoveTermsSmallPrime(p1, k1, -1);
-         if (k2 <= il_MaxK) RemoveTermsSmallPrime(p2, k2, -1);
-         if (k3 <= il_MaxK) RemoveTermsSmallPrime(p3, k3, -1);
-         if (k4 <= il_MaxK) RemoveTermsSmallPrime(p4, k4, -1);
+         PowModBlock(idx, ks, ik_NPlan);
       }
-      else
+
+      for (int32_t j=0; j<PRIME_LIST_MULTIPLE && idx+j<primes; j++)
       {
-         // This function allows for a single term to be removed
-         if (k1 <= il_MaxK) RemoveTermsBigPrime(p1, k1, -1);
-         if (k2 <= il_MaxK) RemoveTermsBigPrime(p2, k2, -1);
-         if (k3 <= il_MaxK) RemoveTermsBigPrime(p3, k3, -1);
-         if (k4 <= il_MaxK) RemoveTermsBigPrime(p4, k4, -1);
+         p = il_PrimeList[idx+j];
+
+         // RemoveTermsSmallPrime() allows for multiple terms to be removed while
+         // RemoveTermsBigPrime() allows for a single term to be removed
+         k = p - ks[j];
+
+         if (k <= il_MaxK)
+         {
+            if (p <= il_MaxK)
+               RemoveTermsSmallPrime(p, k, +1);
+            else
+               RemoveTermsBigPrime(p, k, +1);
+         }
+
+         k = ks[j];
+
+         if (k <= il_MaxK)
+         {
+            if (p <= il_MaxK)
+               RemoveTermsSmallPrime(p, k, -1);
+            else
+               RemoveTermsBigPrime(p, k, -1);
+         }
       }
 
-      SetLargestPrimeTested(p4, 4);
+      SetLargestPrimeTested(p, MIN(PRIME_LIST_MULTIPLE, primes - idx));
    }
-
-   // Adjust for the possibility that we tested the same prime
-   // more than once at the end of the list.
-   if (p4 == p3)
-      SetLargestPrimeTested(p4, -1);
-   if (p4 == p2)
-      SetLargestPrimeTested(p4, -1);
-   if (p4 == p1)
-      SetLargestPrimeTested(p4, -1);
 }
 
 void  TwinWorker::TestMiniPrimeChunk(uint64_t *miniPrimeChunk)
@@ -21,6 +21,9 @@
    (at your option) any later version.
 */
 
+#ifndef _AVX_ASM_X86_H
+#define _AVX_ASM_X86_H
+
 #define AVX_ARRAY_SIZE  16
 
 extern "C" {
@@ -70,3 +73,5 @@ extern "C" {
    // Same as the 1v version, but 16 distinct comparators
    uint16_t  avx_neg_compare_16v(double *comparator, double *p);
 }
+
+#endif
@@ -0,0 +1,105 @@
+/* avx512-asm-x86.h -- (C) Mark Rodenkirch, October 2026
+
+   AVX-512 x86 assembler routines for GCC.
+
+   These are the same as the routines in avx-asm-x86.h, but they use the zmm
+   registers to do powmod/mulmod/etc in groups of 32.  They require a, b, p < 2^52
+   and all double * parameters to be aligned to a 64-byte boundary such as:
+      double __attribute__((aligned(64))) p[32];
+
+   The same warning about float and double variables in avx-asm-x86.h applies here.
+
+   AvxKernel<N> lets a worker write its AVX code once as a template on the number of
+   primes and then choose AVX_ARRAY_SIZE or AVX512_ARRAY_SIZE at runtime.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+*/
+
+#ifndef _AVX512_ASM_X86_H
+#define _AVX512_ASM_X86_H
+
+#include "avx-asm-x86.h"
+
+#define AVX512_ARRAY_SIZE  32
+
+extern "C" {
+   // Given a list of 32 p, compute 1/p for each of them.
+   void      avx512_compute_reciprocal(double *p, double *reciprocal);
+
+   // Set zmm12-zmm15 to the same value for a.
+   void      avx512_set_1a(double *a);
+
+   // Set zmm12-zmm15 to the 32 different values for a.
+   void      avx512_set_32a(double *a);
+
+   // Set zmm4-zmm7 to the 1 value for b.
+   void      avx512_set_1b(double *b);
+
+   // Set zmm4-zmm7 to the 32 different values for b.
+   void      avx512_set_32b(double *b);
+
+   // Set zmm12-zmm15 and b to b^n mod p.
+   // b and p must be arrays of 32 doubles.
+   void      avx512_powmod(double *b, uint64_t n, double *p, double *reciprocal);
+
+   // Set zmm12-zmm15 to a*b mod p.
+   // Assumes that zmm12-zmm15 contain a.
+   // Assumes that zmm4-zmm7 contain b.
+   void      avx512_mulmod(double *p, double *reciprocal);
+
+   // Extract 32 double values from zmm12-zmm15
+   void      avx512_get_32a(double *ptr);
+
+   // For the 32 doubles in zmm12-zmm15, compare to the comparator.
+   // If bit i is 1, then double i is equal to the comparator.
+   uint32_t  avx512_pos_compare_1v(double *comparator);
+
+   // Same as the 1v version, but 32 distinct comparators
+   uint32_t  avx512_pos_compare_32v(double *comparator);
+
+   // For the 32 doubles in zmm12-zmm15, compare to p - comparator.
+   // If bit i is 1, then double i is equal to p - comparator.
+   uint32_t  avx512_neg_compare_1v(double *comparator, double *p);
+
+   // Same as the 1v version, but 32 distinct comparators
+   uint32_t  avx512_neg_compare_32v(double *comparator, double *p);
+}
+
+template <uint32_t N> struct AvxKernel;
+
+template <> struct AvxKernel<AVX_ARRAY_SIZE>
+{
+   static inline void      compute_reciprocal(double *p, double *reciprocal) { avx_compute_reciprocal(p, reciprocal); };
+   static inline void      set_1a(double *a) { avx_set_1a(a); };
+   static inline void      set_na(double *a) { avx_set_16a(a); };
+   static inline void      set_1b(double *b) { avx_set_1b(b); };
+   static inline void      set_nb(double *b) { avx_set_16b(b); };
+   static inline void      powmod(double *b, uint64_t n, double *p, double *reciprocal) { avx_powmod(b, n, p, reciprocal); };
+   static inline void      mulmod(double *p, double *reciprocal) { avx_mulmod(p, reciprocal); };
+   static inline void      get_na(double *ptr) { avx_get_16a(ptr); };
+   static inline uint32_t  pos_compare_1v(double *comparator) { return avx_pos_compare_1v(comparator); };
+   static inline uint32_t  pos_compare_nv(double *comparator) { return avx_pos_compare_16v(comparator); };
+   static inline uint32_t  neg_compare_1v(double *comparator, double *p) { return avx_neg_compare_1v(comparator, p); };
+   static inline uint32_t  neg_compare_nv(double *comparator, double *p) { return avx_neg_compare_16v(comparator, p); };
+};
+
+template <> struct AvxKernel<AVX512_ARRAY_SIZE>
+{
+   static inline void      compute_reciprocal(double *p, double *reciprocal) { avx512_compute_reciprocal(p, reciprocal); };
+   static inline void      set_1a(double *a) { avx512_set_1a(a); };
+   static inline void      set_na(double *a) { avx512_set_32a(a); };
+   static inline void      set_1b(double *b) { avx512_set_1b(b); };
+   static inline void      set_nb(double *b) { avx512_set_32b(b); };
+   static inline void      powmod(double *b, uint64_t n, double *p, double *reciprocal) { avx512_powmod(b, n, p, reciprocal); };
+   static inline void      mulmod(double *p, double *reciprocal) { avx512_mulmod(p, reciprocal); };
+   static inline void      get_na(double *ptr) { avx512_get_32a(ptr); };
+   static inline uint32_t  pos_compare_1v(double *comparator) { return avx512_pos_compare_1v(comparator); };
+   static inline uint32_t  pos_compare_nv(double *comparator) { return avx512_pos_compare_32v(comparator); };
+   static inline uint32_t  neg_compare_1v(double *comparator, double *p) { return avx512_neg_compare_1v(comparator, p); };
+   static inline uint32_t  neg_compare_nv(double *comparator, double *p) { return avx512_neg_compare_32v(comparator, p); };
+};
+
+#endif
@@ -164,8 +164,8 @@ void XYYXApp::ValidateOptions(void)
 
       il_TermCount = GetXCount() * GetYCount();
 
-      iv_Terms.resize(il_TermCount);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), false);
+      iv_Terms.Resize(il_TermCount);
+      iv_Terms.Fill(false);
 
       il_TermCount = 0;
 
@@ -204,8 +204,8 @@ void XYYXApp::ValidateOptions(void)
 
       il_TermCount = GetXCount() * GetYCount();
 
-      iv_Terms.resize(il_TermCount);
-      std::fill(iv_Terms.begin(), iv_Terms.end(), false);
+      iv_Terms.Resize(il_TermCount);
+      iv_Terms.Fill(false);
 
       SetInitialTerms();
    }
@@ -268,7 +268,7 @@ void XYYXApp::ProcessInputTermsFile(bool haveBitMap)
 
       if (haveBitMap)
       {
-         iv_Terms[BIT(x, y)] = true;
+         iv_Terms.Set(BIT(x, y));
          il_TermCount++;
       }
       else
@@ -323,7 +323,7 @@ bool XYYXApp::ApplyFactor(uint64_t theFactor, const char *term)
    // No locking is needed because the Workers aren't running yet
    if (iv_Terms[bit])
    {
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       il_TermCount--;
       return true;
    }
@@ -415,7 +415,7 @@ bool XYYXApp::ReportFactor(uint64_t theFactor, uint32_t x, uint32_t y)
 
    if (iv_Terms[bit])
    {
-      iv_Terms[bit] = false;
+      iv_Terms.Clear(bit);
       il_TermCount--;
       il_FactorCount++;
       removedTerm = true;
@@ -511,7 +511,7 @@ void  XYYXApp::SetInitialTerms(void)
 
          if (stillPlus || stillMinus)
          {
-            iv_Terms[bit] = true;
+            iv_Terms.Set(bit);
             il_TermCount++;
          }
       }
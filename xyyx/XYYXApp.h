@@ -96,7 +96,7 @@ private:
    void              SetInitialTerms(void);
    void              VerifyFactor(uint64_t theFactor, uint32_t x, uint32_t y);
 
-   std::vector<bool> iv_Terms;
+   TermBitmap        iv_Terms;
 
    bool              ib_UseAvx;
    bool              ib_IsPlus;
@@ -99,7 +99,7 @@ void  XYYXGpuWorker::TestMegaPrimeChunk(void)
 
       ii_FactorCount[0] = 0;
 
-      ip_Kernel->Execute(ii_PrimesInList);
+      ip_Kernel->Execute(ii_PaddedPrimesInList);
 
       for (uint32_t ii=0; ii<ii_FactorCount[0]; ii++)
       {
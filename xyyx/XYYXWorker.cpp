@@ -11,7 +11,10 @@
 
 #include "XYYXWorker.h"
 #include "../x86_asm/fpu-asm-x86.h"
-#include "../x86_asm/avx-asm-x86.h"
+
+#ifdef USE_X86
+#include "../x86_asm/avx512-asm-x86.h"
+#endif
 
 #define X_INDEX(x)  ((x) - ii_MinX)
 #define Y_INDEX(y)  ((y) - ii_MinY)
@@ -39,17 +42,22 @@ XYYXWorker::XYYXWorker(uint32_t myId, App *theApp) : Worker(myId, theApp)
    for (uint32_t i=0; i<=MAX_POWERS; i++)
       ip_FpuPowers[i] = (uint64_t *) malloc(4 * sizeof(uint64_t));
 
+#ifdef USE_X86
+   ib_UseAvx512 = CpuSupportsAvx512();
+   ii_AvxArraySize = (ib_UseAvx512 ? AVX512_ARRAY_SIZE : AVX_ARRAY_SIZE);
+
    if (ip_XYYXApp->UseAvxIfAvailable() && CpuSupportsAvx())
    {
       for (uint32_t i=0; i<=MAX_POWERS; i++)
-         ip_AvxPowers[i] = (double *) xmalloc(AVX_ARRAY_SIZE * sizeof(double));
+         ip_AvxPowers[i] = (double *) xmalloc(ii_AvxArraySize * sizeof(double));
 
       // The AVX logic does not handle when gcd(x, prime) > 1 or gcd(y, prime) > 1
       if (ii_MaxX < ii_MaxY)
-         SetMiniChunkRange(ii_MaxY + 1, PMAX_MAX_52BIT, AVX_ARRAY_SIZE);
+         SetMiniChunkRange(ii_MaxY + 1, PMAX_MAX_52BIT, ii_AvxArraySize);
       else
-         SetMiniChunkRange(ii_MaxX + 1, PMAX_MAX_52BIT, AVX_ARRAY_SIZE);
+         SetMiniChunkRange(ii_MaxX + 1, PMAX_MAX_52BIT, ii_AvxArraySize);
    }
+#endif
 }
 
 void  XYYXWorker::CleanUp(void)
@@ -353,10 +361,21 @@ void  XYYXWorker::CheckFpuResult(uint32_t x, uint32_t y, uint64_t *ps, uint64_t
    }
 }
 
+#ifdef USE_X86
 void  XYYXWorker::TestMiniPrimeChunk(uint64_t *miniPrimeChunk)
 {
-   double __attribute__((aligned(32))) dps[AVX_ARRAY_SIZE];
-   double __attribute__((aligned(32))) reciprocals[AVX_ARRAY_SIZE];
+   if (ib_UseAvx512)
+      TestPrimeChunkAVX<AVX512_ARRAY_SIZE>(miniPrimeChunk);
+   else
+      TestPrimeChunkAVX<AVX_ARRAY_SIZE>(miniPrimeChunk);
+}
+
+// Test N primes at a time
+template <uint32_t N>
+void  XYYXWorker::TestPrimeChunkAVX(uint64_t *miniPrimeChunk)
+{
+   double __attribute__((aligned(64))) dps[N];
+   double __attribute__((aligned(64))) reciprocals[N];
 
    // Every once in a while rebuild the term lists as it will have fewer entries
    // which will speed up testing for the next range of p.
@@ -369,29 +388,30 @@ void  XYYXWorker::TestMiniPrimeChunk(uint64_t *miniPrimeChunk)
       ib_HaveFpuRemainders = false;
       ib_HaveAvxRemainders = true;
 
-      ip_XYYXApp->GetTerms(0, AVX_ARRAY_SIZE, &bases);
+      ip_XYYXApp->GetTerms(0, N, &bases);
 
       ip_xyTerms = bases.xPowY;
       ip_yxTerms = bases.yPowX;
 
-      il_NextTermsBuild = (miniPrimeChunk[AVX_ARRAY_SIZE-1] << 1);
+      il_NextTermsBuild = (miniPrimeChunk[N-1] << 1);
    }
 
    // compute the inverse of b (mod p)
-   for (int i=0; i<AVX_ARRAY_SIZE; i++)
+   for (uint32_t i=0; i<N; i++)
       dps[i] = (double) miniPrimeChunk[i];
 
-   avx_compute_reciprocal(dps, reciprocals);
+   AvxKernel<N>::compute_reciprocal(dps, reciprocals);
 
-   BuildAvxXYRemainders(miniPrimeChunk, dps, reciprocals);
+   BuildAvxXYRemainders<N>(miniPrimeChunk, dps, reciprocals);
 
-   CheckAvxXYRemainders(miniPrimeChunk, dps, reciprocals);
+   CheckAvxXYRemainders<N>(miniPrimeChunk, dps, reciprocals);
 }
 
 // Build a table of x^y mod p for all remaining terms
+template <uint32_t N>
 void  XYYXWorker::BuildAvxXYRemainders(uint64_t *ps, double *dps, double *reciprocals)
 {
-   double    __attribute__((aligned(32))) xPowY[AVX_ARRAY_SIZE];
+   double    __attribute__((aligned(64))) xPowY[N];
    uint32_t  x, y, prevY;
    uint32_t  yIndex, powIndex;
    uint32_t  maxPowers;
@@ -411,16 +431,16 @@ void  XYYXWorker::BuildAvxXYRemainders(uint64_t *ps, double *dps, double *recipr
       if (xyPtr->powerCount == 0)
          continue;
 
-      BuildAvxListOfPowers(x, dps, reciprocals, maxPowers);
+      BuildAvxListOfPowers<N>(x, dps, reciprocals, maxPowers);
 
-      for (int i=0; i<AVX_ARRAY_SIZE; i++)
+      for (uint32_t i=0; i<N; i++)
          xPowY[i] = (double) x;
 
       y = xyPtr->powersOfX[0].y;
 
-      avx_powmod(xPowY, y, dps, reciprocals);
+      AvxKernel<N>::powmod(xPowY, y, dps, reciprocals);
 
-      avx_get_16a(xyPtr->powersOfX[0].avxRemainders);
+      AvxKernel<N>::get_na(xyPtr->powersOfX[0].avxRemainders);
 
       prevY = y;
 
@@ -436,27 +456,28 @@ void  XYYXWorker::BuildAvxXYRemainders(uint64_t *ps, double *dps, double *recipr
          // Now compute x^y (mod p) as (x^prevY * x^(y-prevY) (mod p)
          while (powIndex > maxPowers)
          {
-            avx_set_16b(ip_AvxPowers[maxPowers]);
-            avx_mulmod(dps, reciprocals);
+            AvxKernel<N>::set_nb(ip_AvxPowers[maxPowers]);
+            AvxKernel<N>::mulmod(dps, reciprocals);
             powIndex -= maxPowers;
          };
 
          if (powIndex > 0)
          {
-            avx_set_16b(ip_AvxPowers[powIndex]);
-            avx_mulmod(dps, reciprocals);
+            AvxKernel<N>::set_nb(ip_AvxPowers[powIndex]);
+            AvxKernel<N>::mulmod(dps, reciprocals);
          }
 
-         avx_get_16a(xyPtr->powersOfX[yIndex].avxRemainders);
+         AvxKernel<N>::get_na(xyPtr->powersOfX[yIndex].avxRemainders);
 
          prevY = y;
       }
    }
 }
 
+template <uint32_t N>
 void  XYYXWorker::CheckAvxXYRemainders(uint64_t *ps, double *dps, double *reciprocals)
 {
-   double      __attribute__((aligned(32))) yPowX[AVX_ARRAY_SIZE];
+   double      __attribute__((aligned(64))) yPowX[N];
    uint32_t    x, y, prevX;
    uint32_t    xIndex, powIndex;
    uint32_t    maxPowers;
@@ -477,18 +498,18 @@ void  XYYXWorker::CheckAvxXYRemainders(uint64_t *ps, double *dps, double *recipr
       if (yxPtr->powerCount == 0)
          continue;
 
-      BuildAvxListOfPowers(y, dps, reciprocals, maxPowers);
+      BuildAvxListOfPowers<N>(y, dps, reciprocals, maxPowers);
 
-      for (int i=0; i<AVX_ARRAY_SIZE; i++)
+      for (uint32_t i=0; i<N; i++)
          yPowX[i] = (double) y;
 
       x = yxPtr->powersOfY[0].x;
 
-      avx_powmod(yPowX, x, dps, reciprocals);
+      AvxKernel<N>::powmod(yPowX, x, dps, reciprocals);
 
       powerOfX = yxPtr->powersOfY[0].powerOfX;
 
-      CheckAvxResult(x, y, ps, dps, powerOfX->avxRemainders);
+      CheckAvxResult<N>(x, y, ps, dps, powerOfX->avxRemainders);
 
       prevX = x;
 
@@ -504,78 +525,86 @@ void  XYYXWorker::CheckAvxXYRemainders(uint64_t *ps, double *dps, double *recipr
          // Now compute y^x (mod p) as (y^prevX * y^(x-prevX) (mod p)
          while (powIndex > maxPowers)
          {
-            avx_set_16b(ip_AvxPowers[maxPowers]);
-            avx_mulmod(dps, reciprocals);
+            AvxKernel<N>::set_nb(ip_AvxPowers[maxPowers]);
+            AvxKernel<N>::mulmod(dps, reciprocals);
             powIndex -= maxPowers;
          };
 
          if (powIndex > 0)
          {
-            avx_set_16b(ip_AvxPowers[powIndex]);
-            avx_mulmod(dps, reciprocals);
+            AvxKernel<N>::set_nb(ip_AvxPowers[powIndex]);
+            AvxKernel<N>::mulmod(dps, reciprocals);
          }
 
          powerOfX = yxPtr->powersOfY[xIndex].powerOfX;
 
-         CheckAvxResult(x, y, ps, dps, powerOfX->avxRemainders);
+         CheckAvxResult<N>(x, y, ps, dps, powerOfX->avxRemainders);
 
          prevX = x;
       }
    }
 }
 
+template <uint32_t N>
 void  XYYXWorker::BuildAvxListOfPowers(uint32_t base, double *dps, double *reciprocals, uint32_t count)
 {
    uint32_t  idx;
-   double    __attribute__((aligned(32))) a[AVX_ARRAY_SIZE];
+   double    __attribute__((aligned(64))) a[N];
 
-   for (int i=0; i<AVX_ARRAY_SIZE; i++)
+   for (uint32_t i=0; i<N; i++)
    {
       a[i] = (double) base;
       ip_AvxPowers[0][i] = 1.0;
    }
 
-   avx_set_16a(a);
-   avx_set_16b(a);
+   AvxKernel<N>::set_na(a);
+   AvxKernel<N>::set_nb(a);
 
-   avx_mulmod(dps, reciprocals);
+   AvxKernel<N>::mulmod(dps, reciprocals);
 
    // ip_AvxPowers[1] = a^2 mod p
-   avx_get_16a(ip_AvxPowers[1]);
+   AvxKernel<N>::get_na(ip_AvxPowers[1]);
 
    // Multiply successive terms by a^2 (mod p)
    for (idx=2; idx<=count; idx++)
    {
-      avx_set_16b(ip_AvxPowers[1]);
+      AvxKernel<N>::set_nb(ip_AvxPowers[1]);
 
-      avx_mulmod(dps, reciprocals);
+      AvxKernel<N>::mulmod(dps, reciprocals);
 
-      avx_get_16a(ip_AvxPowers[idx]);
+      AvxKernel<N>::get_na(ip_AvxPowers[idx]);
    }
 }
 
+template <uint32_t N>
 void  XYYXWorker::CheckAvxResult(uint32_t x, uint32_t y, uint64_t *ps, double *dps, double *powerOfX)
 {
    uint32_t idx;
-   double __attribute__((aligned(32))) rems[AVX_ARRAY_SIZE];
+   double __attribute__((aligned(64))) rems[N];
 
-   // Only go further if one or more of the 16 primes yielded a factor for this n
-   if (ib_IsMinus && avx_pos_compare_16v(powerOfX) > 0)
+   // Only go further if one or more of the N primes yielded a factor for this n
+   if (ib_IsMinus && AvxKernel<N>::pos_compare_nv(powerOfX) > 0)
    {
-      avx_get_16a(rems);
+      AvxKernel<N>::get_na(rems);
 
-      for (idx=0; idx<AVX_ARRAY_SIZE; idx++)
+      for (idx=0; idx<N; idx++)
          if (rems[idx] == powerOfX[idx])
             ip_XYYXApp->ReportFactor(ps[idx], x, y);
    }
 
-   // Only go further if one or more of the 16 primes yielded a factor for this n
-   if (ib_IsPlus && avx_neg_compare_16v(powerOfX, dps))
+   // Only go further if one or more of the N primes yielded a factor for this n
+   if (ib_IsPlus && AvxKernel<N>::neg_compare_nv(powerOfX, dps))
    {
-      avx_get_16a(rems);
+      AvxKernel<N>::get_na(rems);
 
-      for (idx=0; idx<AVX_ARRAY_SIZE; idx++)
+      for (idx=0; idx<N; idx++)
          if (rems[idx] == dps[idx] - powerOfX[idx])
             ip_XYYXApp->ReportFactor(ps[idx], x, y);
    }
 }
+#else
+void  XYYXWorker::TestMiniPrimeChunk(uint64_t *miniPrimeChunk)
+{
+   FatalError("XYYXWorker::TestMiniPrimeChunk not implemented");
+}
+#endif
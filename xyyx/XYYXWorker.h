@@ -36,11 +36,23 @@ private:
    void           BuildFpuListOfPowers(uint32_t base, uint64_t *ps, uint32_t count);
    void           CheckFpuResult(uint32_t x, uint32_t y, uint64_t *ps, uint64_t *powerOfX, uint64_t *powesOfY);
 
-   void           TestPrimeChunkAVX(uint64_t &largestPrimeTested, uint64_t &primesTested);
+#ifdef USE_X86
+   // N is AVX_ARRAY_SIZE for the ymm routines or AVX512_ARRAY_SIZE for the zmm routines
+   template <uint32_t N>
+   void           TestPrimeChunkAVX(uint64_t *ps);
+   template <uint32_t N>
    void           BuildAvxXYRemainders(uint64_t *ps, double *dps, double *reciprocals);
+   template <uint32_t N>
    void           CheckAvxXYRemainders(uint64_t *ps, double *dps, double *reciprocals);
+   template <uint32_t N>
    void           BuildAvxListOfPowers(uint32_t base, double *dps, double *reciprocals, uint32_t count);
+   template <uint32_t N>
    void           CheckAvxResult(uint32_t x, uint32_t y, uint64_t *ps, double *dps, double *powersOfX);
+
+   bool           ib_UseAvx512;
+   uint32_t       ii_AvxArraySize;
+#endif
+
    XYYXApp       *ip_XYYXApp;
 
    uint32_t       ii_MinX;